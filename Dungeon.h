@@ -3,15 +3,158 @@
 #include <Arduino.h>
 #include "dungeonTypes.h"
 #include "externBitmaps.h"
+#include "inputRecorder.h"
+#include "rewindBuffer.h"
+#include "tinyJoypadUtils.h"
 
 // uncomment this line to make the player invincible
 //#define _GODMODE_
 
+// Skip rendering the dungeon view if only the status pane has changed
+// (the display still holds the last view). Enabled on all MCUs except the ATtiny85.
+#if !defined(__AVR_ATtiny85__) && !defined(_USE_VIEWPORT_CACHE_)
+  #define _USE_VIEWPORT_CACHE_
+#endif
+
+// Remember for every cell and direction which cells of the field of view are
+// not hidden behind walls, so the renderer can skip the others.
+// Requires 2kB of RAM, so it's only enabled on MCUs with plenty of RAM.
+#if ( defined(__AVR_ATmega2560__) || defined(_VARIANT_ARDUINO_ZERO_) ) && !defined(_USE_POTENTIALLY_VISIBLE_SET_)
+  #define _USE_POTENTIALLY_VISIBLE_SET_
+#endif
+
+// Compose the status pane rows from the widget table (statusWidgets in "externBitmaps.h")
+// instead of testing every byte. The status pane cache and the vertical addressing mode
+// depend on it, the ATtiny85 keeps the smaller byte by byte code otherwise.
+#if ( !defined(__AVR_ATtiny85__) || defined(_USE_VIEWPORT_CACHE_) || defined(_USE_VERTICAL_ADDRESSING_) ) && !defined(_USE_STATUS_WIDGETS_)
+  #define _USE_STATUS_WIDGETS_
+#endif
+
+// Take the potentially visible sets from the level data (generated by host/levelCompiler.cpp)
+// instead of calculating them: 2kB of flash instead of 2kB of RAM, no calculation at all.
+//#define _USE_PRECOMPUTED_PVS_
+
+#if defined(_USE_PRECOMPUTED_PVS_) && !defined(_USE_POTENTIALLY_VISIBLE_SET_)
+  #define _USE_POTENTIALLY_VISIBLE_SET_
+#endif
+
+// Speed profile: Use a separate render kernel for each orientation, so the
+// orientation isn't evaluated for every cell lookup anymore.
+// This costs a lot of flash, so don't enable it on the ATtiny85!
+//#define _USE_ORIENTATION_KERNELS_
+
+// Make the dice reproducible: the random generator always starts with the same seed and
+// ignores the timer and the input timing (for tests, replays and benchmarks)
+//#define _USE_DETERMINISTIC_DICE_
+
+// Roll the dice with the seedable xorshift16 generator (unbiased results). The ATtiny85
+// keeps the smaller timer based dice, unless the dice have to be reproducible.
+#if ( !defined(__AVR_ATtiny85__) || defined(_USE_DETERMINISTIC_DICE_) || defined(_ENABLE_INPUT_RECORDER_) ) && !defined(_USE_XORSHIFT_DICE_)
+  #define _USE_XORSHIFT_DICE_
+#endif
+
+// Count the work done per frame (cell lookups, flash reads, scaled objects...),
+// the last frame's counters are available in 'Dungeon::lastFrameStats'
+//#define _ENABLE_FRAME_STATS_
+
+#if defined(_USE_POTENTIALLY_VISIBLE_SET_) && !defined(_USE_PRECOMPUTED_PVS_) && !defined(_USE_VIEWPORT_CACHE_)
+  #error "_USE_POTENTIALLY_VISIBLE_SET_ requires _USE_VIEWPORT_CACHE_ (for the level revision)!"
+#endif
+
+#ifdef _ENABLE_FRAME_STATS_
+  #define FRAME_STATS_BEGIN()                memset( &frameStats, 0, sizeof( frameStats ) )
+  #define FRAME_STATS_ADD( counter, value )  frameStats.counter += ( value )
+  #define FRAME_STATS_END()                  lastFrameStats = frameStats
+#else
+  #define FRAME_STATS_BEGIN()
+  #define FRAME_STATS_ADD( counter, value )
+  #define FRAME_STATS_END()
+#endif
+
+class Dungeon;
+
+#if defined(ARDUINO_ARCH_HOST)
+// Per instance I/O of the host build, so any number of games can run at once
+// (see host/batchRunner.cpp). If set, it replaces the joypad, the display and
+// the timer (the dice only depend on the seed).
+class DUNGEON_HOST_IO
+{
+public:
+  // returns the inputs (INPUT_LEFT...)
+  uint8_t ( *readInputs )( Dungeon &dungeon );
+  // renders a frame with renderImage( sink ) (e.g. into a HASH_SINK), the renderer resets the flash effects
+  void ( *renderFrame )( Dungeon &dungeon );
+  // seed of the dice (not 0)
+  uint16_t diceSeed;
+  // for the host program
+  void *context;
+};
+
+// The tables of a level in the layout of LevelDefinitions.h, e.g. in a
+// level pack (see host/levelPack.h). If set, they replace the compiled-in ones.
+class LEVEL_DATA
+{
+public:
+  const uint8_t *level;
+  const INTERACTION_INFO *interactionData;
+  const SPECIAL_CELL_INFO *specialCellFX;
+  // MAX_MONSTERS entries
+  const MONSTER_STATS *monsterStats;
+  // MAX_LEVEL_BYTES * MAX_ORIENTATION entries (like levelPotentiallyVisibleSet[])
+  const uint16_t *potentiallyVisibleSet;
+  uint8_t interactions;
+  uint8_t specialCells;
+  uint8_t startX;
+  uint8_t startY;
+  uint8_t startDir;
+};
+
+// a table of the current level, 'builtin' is the one of LevelDefinitions.h
+#define LEVEL_TABLE( member, builtin )  ( _levelData ? _levelData->member : decltype( _levelData->member )( builtin ) )
+#else
+#define LEVEL_TABLE( member, builtin )  ( builtin )
+#endif
+
 // Dungeon
 class Dungeon
 {
 public:
   DUNGEON _dungeon;
+#if defined(ARDUINO_ARCH_HOST)
+  // nullptr = joypad and display
+  DUNGEON_HOST_IO *_hostIO;
+  // nullptr = the level of LevelDefinitions.h (used by init())
+  const LEVEL_DATA *_levelData;
+#endif
+#ifdef _ENABLE_REWIND_
+  // the changes of the last actions
+  REWIND_BUFFER _rewindBuffer;
+#endif
+#ifdef _ENABLE_FRAME_STATS_
+  // counters of the frame being rendered and of the last complete frame
+  FRAME_STATS frameStats;
+  FRAME_STATS lastFrameStats;
+#endif
+#ifdef _USE_VIEWPORT_CACHE_
+  // incremented on every modification of _dungeon.currentLevel
+  uint8_t _levelRevision;
+  // state of the last rendered dungeon view
+  VIEWPORT_KEY _lastViewport;
+  // state of the last rendered status pane
+  STATUS_KEY _lastStatus;
+  // status pane rows to be rendered regardless of their state
+  uint8_t _forcedStatusRows;
+#endif
+#ifdef _USE_POTENTIALLY_VISIBLE_SET_
+ #ifndef _USE_PRECOMPUTED_PVS_
+  // potentially visible cells for every cell and direction (0 = not calculated yet)
+  uint16_t _potentiallyVisibleSet[MAX_LEVEL_BYTES * MAX_ORIENTATION];
+  // level revision the potentially visible sets belong to
+  uint8_t _potentiallyVisibleSetRevision;
+ #endif
+  // potentially visible cells of the current frame
+  uint16_t _visibleCells;
+#endif
 
   static constexpr uint8_t getLevelWidth() { return( LEVEL_WIDTH ); }
   static constexpr uint8_t getLevelHeight() { return( LEVEL_HEIGHT ); }
@@ -21,27 +164,99 @@ public:
 
   bool isPlayerAlive() { return( _dungeon.playerHP > 0 ); }
 
+  // the whole game state is plain data, so a snapshot is a copy (restoring redraws everything)
+  void saveSnapshot( DUNGEON &snapshot ) const { snapshot = _dungeon; }
+  void restoreSnapshot( const DUNGEON &snapshot );
+#ifdef _ENABLE_REWIND_
+  // undoes up to 'actions' actions, returns the number of actions undone
+  uint16_t rewind( const uint16_t actions );
+  void rewindAfterDeath();
+#endif
+
   void gameLoop();
+  void prepareFrame();
+  bool endFlashEffect();
   void checkPlayerMovement();
+  bool playerInput( const uint8_t inputs );
+  // all inputs at once (see readInputs())
+  uint8_t getInputs()
+  {
+  #if defined(ARDUINO_ARCH_HOST)
+    if ( _hostIO ) { return( _hostIO->readInputs( *this ) ); }
+  #endif
+    return( readInputs() );
+  }
 
 #ifdef _USE_FIELD_OF_VIEW_
   void updateFieldOfView();
   uint8_t getCell( const int8_t distance, const int8_t offsetLR );
 #endif
   uint8_t *getCellRaw( int8_t x, int8_t y, const int8_t distance, const int8_t offsetLR, const uint8_t orientation );
+  template <uint8_t orientation> uint8_t *getViewCell( const int8_t distance, const int8_t offsetLR );
   void limitDungeonPosition( int8_t &x, int8_t &y );
   void updateStatusPane();
   void openChest( INTERACTION_INFO &info );
   void initDice();
   void updateDice();
-  uint8_t getDice( uint8_t maxValue );
+#ifdef _USE_XORSHIFT_DICE_
+  uint16_t nextRandom();
+#endif
+  uint8_t getDice( const uint8_t maxValue );
   MONSTER_STATS *findMonster( const uint8_t position );
   void playerAttack( MONSTER_STATS *monster );
   void monsterAttack( MONSTER_STATS *monster );
   void playerInteraction( uint8_t *cell, const uint8_t cellValue );
   void /*__attribute__ ((noinline))*/ renderImage();
+  template <class PIXEL_SINK> void renderImage( PIXEL_SINK &sink );
+#ifdef _USE_VIEWPORT_CACHE_
+  void levelModified() { _levelRevision++; }
+  bool updateViewportCache();
+  uint8_t updateStatusCache();
+#else
+  void levelModified() {}
+  bool updateViewportCache() { return( true ); }
+  uint8_t updateStatusCache() { return( 0xff ); }
+#endif
+#ifdef _USE_STATUS_WIDGETS_
+  void getStatusRow( const uint8_t y, STATUS_ROW &statusRow );
+  uint8_t getStatusPixels( STATUS_ROW &statusRow, const uint8_t x, const uint8_t y );
+  uint8_t getStatusOverlayPixels( uint8_t pixels, const uint8_t x, const uint8_t y );
+#endif
   // bitmap drawing functions
+  template <uint8_t orientation = ANY_ORIENTATION>
+  bool findWallEntry( const int8_t x, SIMPLE_WALL_INFO &wallInfo, uint8_t &offsetX );
+  template <uint8_t orientation = ANY_ORIENTATION>
+  void drawObjects( const int8_t x, const uint8_t y, const uint8_t rows, uint8_t *pixels, const uint8_t maxObjectDistance );
+  template <uint8_t orientation = ANY_ORIENTATION>
   uint8_t /*__attribute__ ((always_inline))*/ getWallPixels( const int8_t x, const int8_t y );
+#ifndef _USE_VERTICAL_ADDRESSING_
+  bool getFrontWallSpan( SIMPLE_WALL_INFO &wallInfo );
+#endif
+#ifdef _USE_VERTICAL_ADDRESSING_
+  template <uint8_t orientation = ANY_ORIENTATION>
+  void getWallColumn( const int8_t x, uint8_t *columnPixels );
+#endif
+#ifdef _USE_ORIENTATION_KERNELS_
+  #ifdef _USE_VERTICAL_ADDRESSING_
+  typedef void ( Dungeon::*RENDER_KERNEL )( const int8_t x, uint8_t *columnPixels );
+  #else
+  typedef uint8_t ( Dungeon::*RENDER_KERNEL )( const int8_t x, const int8_t y );
+  #endif
+  RENDER_KERNEL getRenderKernel();
+#endif
+#ifdef _USE_POTENTIALLY_VISIBLE_SET_
+  // bit 15 is always set, so it's used for the cells next to the player (distance 0)
+  static constexpr uint16_t getVisibleCellBit( const int8_t distance, const int8_t offsetLR )
+  {
+    return( distance ? 1 << ( ( distance - 1 ) * 5 + offsetLR + 2 ) : VISIBLE_CELLS_VALID );
+  }
+  bool isCellVisible( const int8_t distance, const int8_t offsetLR ) { return( _visibleCells & getVisibleCellBit( distance, offsetLR ) ); }
+  void updatePotentiallyVisibleSet();
+  uint16_t calculateVisibleCells();
+#else
+  bool isCellVisible( const int8_t, const int8_t ) { return( true ); }
+  void updatePotentiallyVisibleSet() {}
+#endif
   uint8_t getDownScaledBitmapData( int8_t x, int8_t y, 
                                    const uint8_t distance, const NON_WALL_OBJECT *object,
                                    bool useMask );
@@ -1,94 +1,160 @@
 #pragma once
 
+// Generated by host/levelCompiler.cpp from levels/Level_1.txt - please edit the level there!
+
 #include <Arduino.h>
 #include "dungeonTypes.h"
 #include "externBitmaps.h"
 
+// start of the player
+#define LEVEL_START_X    1
+#define LEVEL_START_Y    1
+#define LEVEL_START_DIR  EAST
+
 // simple level - 1 byte per cell
 const uint8_t Level_1[] PROGMEM = 
 {
-/*             0             1             2            3              4              5             6            7             8            9           10           11            12           13           14           15              */
-/*  0 */     WALL      ,   WALL      ,   WALL     ,   WALL      ,WALL|LVR_LEFT,     WALL     ,    WALL     ,     0       ,   WALL     ,   WALL     ,     0      ,     0       ,     0      ,     0      ,     0,         WALL   , /*  0 */
-/*  1 */       0       ,/*START*/ 0  ,   BARS     ,     0       ,CLOSED_CHEST ,     WALL     , CLOSED_CHEST,   WALL      ,     0      ,   WALL     ,     0      ,   WALL      ,   WALL     ,   WALL     ,     0      ,   WALL     , /*  1 */
-/*  2 */       0       ,     0       ,   WALL     ,     0       ,    WALL     ,     WALL     ,    WALL     ,     0       ,     0      ,   WALL     ,     0      ,   WALL      ,  FOUNTAIN  ,   WALL     ,     0      ,   WALL     , /*  2 */
-/*  3 */  /* RAT*/ 0   ,   WALL      ,     0      ,     0       ,    WALL     ,       0      ,      0      ,     0       ,   WALL     ,   WALL     ,     0      ,   WALL      ,/*BEHOLDR*/0,   WALL     ,     0      ,   WALL     , /*  3 */
-/*  4 */  WALL|LVR_LEFT,   WALL      ,     0      ,   WALL      ,      0      ,       0      ,    WALL     ,     0       ,     0      ,   WALL     ,     0      ,   WALL      ,     0      ,   BARS     ,     0      ,   WALL     , /*  4 */
-/*  5 */     WALL      ,     0       ,/*SPINNER*/0, /* RAT*/ 0  ,    WALL     ,       0      ,    WALL     ,     0       ,     0      ,   WALL     ,     0      ,   WALL      ,   WALL     ,   WALL     ,   WALL     ,   WALL     , /*  5 */
-/*  6 */       0       ,     0       ,   WALL     ,     0       ,      0      ,       0      ,    WALL     ,   WALL      ,CLOSED_CHEST,   WALL     ,     0      ,     0       ,     0      ,/*SKELETN*/0,CLOSED_CHEST,   BARS     , /*  6 */ 
-/*  7 */     WALL      ,   WALL	     ,     0      ,     0       ,    WALL     ,     WALL     ,    WALL     ,WALL|LVR_LEFT,   WALL     ,   WALL     ,   WALL     ,   WALL      ,   WALL     ,   BARS     ,   WALL     ,   WALL     , /*  7 */
-/*  8 */     WALL      ,     0       ,     0      ,     0       ,    WALL     ,       0      ,    WALL     ,/*SPINNER*/0 ,   WALL     ,     0      ,   WALL     ,     0       ,     0      ,     0      ,     0      ,     0      , /*  8 */
-/*  9 */     WALL      ,     0       ,   WALL     , FAKE_WALL   ,    WALL     ,       0      ,      0      ,     0       ,     0      ,     0      ,   WALL     ,   BARS      ,   WALL     ,     0      ,   WALL     ,     0      , /*  9 */
-/* 10 */     WALL      ,     0       ,   WALL     ,CLOSED_CHEST ,    WALL     ,       0      ,    WALL     ,     0       ,   WALL     ,     0      ,   WALL     , /*MIMIC*/ 0 ,   WALL     ,     0      ,     0      ,     0      , /* 10 */
-/* 11 */     WALL      ,     0       ,     0      ,   WALL      ,    WALL     ,       0      ,      0      ,/*TELEP.*/ 0 ,     0      ,     0      ,   WALL     ,   WALL      ,     0      ,     0      ,   WALL     ,     0      , /* 11 */
-/* 12 */  WALL|LVR_LEFT,   WALL      , FAKE_WALL  ,   BARS      ,    BARS     ,       0      ,    WALL     ,CLOSED_CHEST ,WALL|LVR_LEFT,    0      ,     0      , WALL|DOOR   ,     0      ,   WALL     ,     0      ,     0      , /* 12 */
-/* 13 */       0       ,     0       ,     0      ,   WALL      ,    WALL     ,       0      ,      0      ,/*TELEP.*/ 0 ,     0      ,     0      ,   WALL     ,     0       ,     0      ,   WALL     ,     0      ,   WALL     , /* 13 */
-/* 14 */     WALL      ,   WALL      ,     0      ,     0       ,    WALL     ,       0      ,    WALL     ,     0       ,   WALL     ,     0      ,   WALL     ,/*SKELETN*/0 ,   WALL     ,     0      ,     0      ,     0      , /* 14 */
-/* 15 */       0       ,WALL|LVR_LEFT,   WALL     ,WALL|LVR_LEFT,    WALL     ,       0      ,      0      ,     0       ,     0      ,     0      ,   WALL     ,    WALL     ,   WALL     ,WALL|LVR_LEFT,   WALL    ,     0      , /* 15 */
-/*             0             1             2            3              4              5             6            7             8            9           10           11            12           13           14           15              */
+/*              0               1               2               3               4               5               6               7               8               9              10              11              12              13              14              15        */
+/*  0 */           WALL,           WALL,           WALL,           WALL,  WALL|LVR_LEFT,           WALL,           WALL,              0,           WALL,           WALL,              0,              0,              0,              0,              0,           WALL, /*  0 */
+/*  1 */              0,    /*START*/ 0,           BARS,              0,   CLOSED_CHEST,           WALL,   CLOSED_CHEST,           WALL,      /*RAT*/ 0,           WALL,              0,           WALL,           WALL,           WALL,              0,           WALL, /*  1 */
+/*  2 */              0,              0,           WALL,              0,           WALL,           WALL,           WALL,              0,              0,           WALL,  /*SPINNER*/ 0,           WALL,       FOUNTAIN,           WALL,              0,           WALL, /*  2 */
+/*  3 */      /*RAT*/ 0,           WALL,              0,              0,           WALL,              0,              0,              0,           WALL,           WALL,              0,           WALL, /*BEHOLDER*/ 0,           WALL,              0,           WALL, /*  3 */
+/*  4 */  WALL|LVR_LEFT,           WALL,              0,           WALL,              0,              0,           WALL,              0,              0,           WALL,              0,           WALL,              0,           BARS,              0,           WALL, /*  4 */
+/*  5 */           WALL,              0,  /*SPINNER*/ 0,      /*RAT*/ 0,           WALL,              0,           WALL,              0,              0,           WALL,              0,           WALL,           WALL,           WALL,           WALL,           WALL, /*  5 */
+/*  6 */              0,              0,           WALL,              0,              0,              0,           WALL,           WALL,   CLOSED_CHEST,           WALL,              0,              0,              0, /*SKELETON*/ 0,   CLOSED_CHEST,           BARS, /*  6 */
+/*  7 */           WALL,           WALL,              0,              0,           WALL,           WALL,           WALL,  WALL|LVR_LEFT,           WALL,           WALL,           WALL,           WALL,           WALL,           BARS,           WALL,           WALL, /*  7 */
+/*  8 */           WALL,              0,              0,              0,           WALL,              0,           WALL,  /*SPINNER*/ 0,           WALL,              0,           WALL,              0,              0,              0,              0,              0, /*  8 */
+/*  9 */           WALL,              0,           WALL,      FAKE_WALL,           WALL,              0,              0,              0,              0,              0,           WALL,           BARS,           WALL,              0,           WALL,              0, /*  9 */
+/* 10 */           WALL,              0,           WALL,    /*MIMIC*/ 0,           WALL,              0,           WALL,              0,           WALL,              0,           WALL,    /*MIMIC*/ 0,           WALL,              0,              0,              0, /* 10 */
+/* 11 */           WALL,              0,              0,           WALL,           WALL,              0,              0, /*TELEPORT*/ 0,              0,              0,           WALL,           WALL,              0,              0,           WALL,              0, /* 11 */
+/* 12 */  WALL|LVR_LEFT,           WALL,      FAKE_WALL,           BARS,           BARS,              0,           WALL,   CLOSED_CHEST,  WALL|LVR_LEFT,              0,              0,      WALL|DOOR,              0,           WALL,              0,              0, /* 12 */
+/* 13 */              0,              0,              0,           WALL,           WALL,              0,              0, /*TELEPORT*/ 0,              0,              0,           WALL,              0,              0,           WALL,              0,           WALL, /* 13 */
+/* 14 */           WALL,           WALL,              0, /*SKELETON*/ 0,           WALL,              0,           WALL,              0,           WALL,              0,           WALL,              0,           WALL, /*SKELETON*/ 0,              0,              0, /* 14 */
+/* 15 */              0,  WALL|LVR_LEFT,           WALL,  WALL|LVR_LEFT,           WALL,              0,              0,              0,              0,              0,           WALL,           WALL,           WALL,  WALL|LVR_LEFT,           WALL,              0, /* 15 */
 };
 
 // interaction data (6 bytes per event)
 const INTERACTION_INFO interactionData[] PROGMEM =
 {
-  // currentPos                    currentStatus     nextStatus         newItem              modifiedPos        modifiedPosCellValue
-  {  4 +  0 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  5 +  1 * LEVEL_WIDTH  ,      0        },
-
-  {  7 +  0 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  2 +  1 * LEVEL_WIDTH  ,  /*TBD*/ 0    },
-  {  7 +  0 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  2 +  1 * LEVEL_WIDTH  ,  /*TBD*/ 0    },
-																      
-  {  4 +  1 * LEVEL_WIDTH        ,    CLOSED_CHEST , OPEN_CHEST  ,     ITEM_COMPASS    ,  4 +  1 * LEVEL_WIDTH  ,  OPEN_CHEST   },
-  {  6 +  1 * LEVEL_WIDTH        ,    CLOSED_CHEST , OPEN_CHEST  ,    ITEM_SHIELD      ,  6 +  1 * LEVEL_WIDTH  ,  OPEN_CHEST   },
-																      
-  { 12 +  2 * LEVEL_WIDTH        ,    FOUNTAIN     , FOUNTAIN    ,     ITEM_VICTORY    , 12 +  2 * LEVEL_WIDTH  ,    FOUNTAIN   },
-																      
-  {  0 +  4 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  2 +  1 * LEVEL_WIDTH  ,      0        },
-  {  0 +  4 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  2 +  1 * LEVEL_WIDTH  ,     BARS      },
-																      
-  {  8 +  6 * LEVEL_WIDTH        ,    CLOSED_CHEST , OPEN_CHEST  ,     ITEM_AMULET     ,  8 +  6 * LEVEL_WIDTH  ,  OPEN_CHEST   },
-  { 14 +  6 * LEVEL_WIDTH        ,    CLOSED_CHEST , OPEN_CHEST  ,ITEM_RING|ITEM_POTION, 14 +  6 * LEVEL_WIDTH  ,  OPEN_CHEST   },
-																      
-  {  7 +  7 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  7 + 15 * LEVEL_WIDTH  ,   /*TBD*/ 0   },
-  {  7 +  7 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  7 + 15 * LEVEL_WIDTH  ,   /*TBD*/ 0   },
-																      
-  {  0 + 12 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  3 + 12 * LEVEL_WIDTH  ,      0        },
-  {  0 + 12 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  4 + 12 * LEVEL_WIDTH  ,    BARS       },
-  
-  {  7 + 12 * LEVEL_WIDTH        ,    CLOSED_CHEST , OPEN_CHEST  ,ITEM_KEY|ITEM_COMPASS,  7 + 12 * LEVEL_WIDTH  ,  OPEN_CHEST   },
-  {  8 + 12 * LEVEL_WIDTH        ,    LVR_LEFT     ,    0        ,         0           , 10 + 12 * LEVEL_WIDTH  ,      0        },   
-  { 11 + 12 * LEVEL_WIDTH        ,    DOOR         ,    0        ,         0           , 11 + 12 * LEVEL_WIDTH  ,      0        },
-																	    
-  {  1 + 15 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  1 +  9 * LEVEL_WIDTH  ,    BARS       },
-  {  1 + 15 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  1 +  9 * LEVEL_WIDTH  ,      0        },
-  {  3 + 15 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           ,  3 + 12 * LEVEL_WIDTH  ,    BARS       },
-  {  3 + 15 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           ,  4 + 12 * LEVEL_WIDTH  ,      0        },
-																    
-  { 13 + 15 * LEVEL_WIDTH        ,    LVR_LEFT     , LVR_RIGHT   ,         0           , 13 +  7 * LEVEL_WIDTH  ,      0        },
-  { 13 + 15 * LEVEL_WIDTH        ,    LVR_RIGHT    , LVR_LEFT    ,         0           , 13 +  4 * LEVEL_WIDTH  ,      0        },
+  // currentPos            currentStatus  nextStatus     newItem                        modifiedPos            modifiedPosCellValue
+  {  4 +  0 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  5 +  1 * LEVEL_WIDTH, 0            },
+  {  4 +  1 * LEVEL_WIDTH, CLOSED_CHEST , OPEN_CHEST   , ITEM_COMPASS                 ,  4 +  1 * LEVEL_WIDTH, OPEN_CHEST   },
+  {  6 +  1 * LEVEL_WIDTH, CLOSED_CHEST , OPEN_CHEST   , ITEM_SHIELD                  ,  6 +  1 * LEVEL_WIDTH, OPEN_CHEST   },
+  { 12 +  2 * LEVEL_WIDTH, FOUNTAIN     , FOUNTAIN     , ITEM_VICTORY                 , 12 +  2 * LEVEL_WIDTH, FOUNTAIN     },
+  {  0 +  4 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  2 +  1 * LEVEL_WIDTH, 0            },
+  {  0 +  4 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            ,  2 +  1 * LEVEL_WIDTH, BARS         },
+  {  8 +  6 * LEVEL_WIDTH, CLOSED_CHEST , OPEN_CHEST   , ITEM_AMULET                  ,  8 +  6 * LEVEL_WIDTH, OPEN_CHEST   },
+  { 14 +  6 * LEVEL_WIDTH, CLOSED_CHEST , OPEN_CHEST   , ITEM_RING | ITEM_POTION      , 14 +  6 * LEVEL_WIDTH, OPEN_CHEST   },
+  {  7 +  7 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  7 + 15 * LEVEL_WIDTH, 0            },
+  {  7 +  7 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            ,  7 + 15 * LEVEL_WIDTH, 0            },
+  {  0 + 12 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  3 + 12 * LEVEL_WIDTH, 0            },
+  {  0 + 12 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            ,  4 + 12 * LEVEL_WIDTH, BARS         },
+  {  7 + 12 * LEVEL_WIDTH, CLOSED_CHEST , OPEN_CHEST   , ITEM_COMPASS | ITEM_KEY      ,  7 + 12 * LEVEL_WIDTH, OPEN_CHEST   },
+  {  8 + 12 * LEVEL_WIDTH, LVR_LEFT     , 0            , 0                            , 10 + 12 * LEVEL_WIDTH, 0            },
+  { 11 + 12 * LEVEL_WIDTH, DOOR         , 0            , 0                            , 11 + 12 * LEVEL_WIDTH, 0            },
+  {  1 + 15 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  1 +  9 * LEVEL_WIDTH, BARS         },
+  {  1 + 15 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            ,  1 +  9 * LEVEL_WIDTH, 0            },
+  {  3 + 15 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            ,  3 + 12 * LEVEL_WIDTH, BARS         },
+  {  3 + 15 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            ,  4 + 12 * LEVEL_WIDTH, 0            },
+  { 13 + 15 * LEVEL_WIDTH, LVR_LEFT     , LVR_RIGHT    , 0                            , 13 +  7 * LEVEL_WIDTH, 0            },
+  { 13 + 15 * LEVEL_WIDTH, LVR_RIGHT    , LVR_LEFT     , 0                            , 13 +  4 * LEVEL_WIDTH, 0            },
 };
 
 // special cell effects (4 bytes per FX)
 const SPECIAL_CELL_INFO specialCellFX[] PROGMEM =
 {
-  // cell type ,     position       , value_1, value_2
-  { TELEPORTER ,  7 + 11 * LEVEL_WIDTH,     5  ,   13    },
-  { TELEPORTER ,  7 + 13 * LEVEL_WIDTH,     5  ,   11    },
-  { SPINNER    , 10 +  2 * LEVEL_WIDTH,    +2  ,    0    },
-  { SPINNER    ,  2 +  5 * LEVEL_WIDTH,    +1  ,    0    },
-  { SPINNER    ,  7 +  8 * LEVEL_WIDTH,    +3  ,    0    },
+  // cell type , position              , value_1, value_2
+  { TELEPORTER ,  7 + 11 * LEVEL_WIDTH,    5   ,   13    },
+  { TELEPORTER ,  7 + 13 * LEVEL_WIDTH,    5   ,   11    },
+  { SPINNER    , 10 +  2 * LEVEL_WIDTH,   +2   ,    0    },
+  { SPINNER    ,  2 +  5 * LEVEL_WIDTH,   +1   ,    0    },
+  { SPINNER    ,  7 +  8 * LEVEL_WIDTH,   +3   ,    0    },
 };
 
-// monster stats (6 bytes per monster - must fit into RAM - or EEPROM???)
+// monster stats (6 bytes per monster - must fit into RAM - or EEPROM?)
 const MONSTER_STATS monsterStats[MAX_MONSTERS] PROGMEM =
 {
-  // position                monsterType  hp  bonusDamage   attacksFirst  treasureItemMask
-  {   0 +  3 * LEVEL_WIDTH,  RAT        ,  3 ,     -6      ,      1       ,           0                               }, // rat
-  {   8 +  1 * LEVEL_WIDTH,  RAT        ,  3 ,     -4      ,      1       ,           0                               }, // rat
-  {  12 +  3 * LEVEL_WIDTH,  BEHOLDER   , 40 ,     +7      ,      1       ,           0                               }, // beholder (end boss)
-  {   3 +  5 * LEVEL_WIDTH,  RAT        ,  5 ,     -4      ,      1       ,           0                               }, // rat
-  {  13 +  6 * LEVEL_WIDTH,  SKELETON   , 15 ,     +4      ,      0       ,  ITEM_SWORD | ITEM_SHIELD                 }, // skeleton
-  {   7 +  8 * LEVEL_WIDTH,  SKELETON   , 12 ,     +3      ,      0       ,  ITEM_SWORD | ITEM_SHIELD                 }, // skeleton
-  {   3 + 10 * LEVEL_WIDTH,  MIMIC      , 15 ,     -1      ,      1       ,     ITEM_POTION | ITEM_SWORD              }, // mimic
-  {  11 + 10 * LEVEL_WIDTH,  MIMIC      , 15 ,     +1      ,      0       ,  ITEM_SWORD | ITEM_SHIELD | ITEM_POTION   }, // mimic
-  {   3 + 14 * LEVEL_WIDTH,  SKELETON   , 12 ,     +3      ,      0       ,  ITEM_SWORD | ITEM_SHIELD                 }, // skeleton
-  {  13 + 14 * LEVEL_WIDTH,  SKELETON   , 12 ,     +3      ,      0       ,  ITEM_SWORD | ITEM_SHIELD                 }, // skeleton
+  // position            monsterType  hp  bonusDamage  attacksFirst  treasureItemMask
+  {  0 +  3 * LEVEL_WIDTH, RAT        ,   3 ,     -6     ,      1       , 0                                          }, // rat
+  {  8 +  1 * LEVEL_WIDTH, RAT        ,   3 ,     -4     ,      1       , 0                                          }, // rat
+  { 12 +  3 * LEVEL_WIDTH, BEHOLDER   ,  40 ,     +7     ,      1       , 0                                          }, // beholder
+  {  3 +  5 * LEVEL_WIDTH, RAT        ,   5 ,     -4     ,      1       , 0                                          }, // rat
+  { 13 +  6 * LEVEL_WIDTH, SKELETON   ,  15 ,     +4     ,      0       , ITEM_SWORD | ITEM_SHIELD                   }, // skeleton
+  {  7 +  8 * LEVEL_WIDTH, SKELETON   ,  12 ,     +3     ,      0       , ITEM_SWORD | ITEM_SHIELD                   }, // skeleton
+  {  3 + 10 * LEVEL_WIDTH, MIMIC      ,  15 ,     -1     ,      1       , ITEM_POTION | ITEM_SWORD                   }, // mimic
+  { 11 + 10 * LEVEL_WIDTH, MIMIC      ,  15 ,     +1     ,      0       , ITEM_POTION | ITEM_SWORD | ITEM_SHIELD     }, // mimic
+  {  3 + 14 * LEVEL_WIDTH, SKELETON   ,  12 ,     +3     ,      0       , ITEM_SWORD | ITEM_SHIELD                   }, // skeleton
+  { 13 + 14 * LEVEL_WIDTH, SKELETON   ,  12 ,     +3     ,      0       , ITEM_SWORD | ITEM_SHIELD                   }, // skeleton
+};
+
+#ifdef _USE_PRECOMPUTED_PVS_
+// potentially visible sets for every cell and direction (see Dungeon::calculateVisibleCells()),
+// calculated with every cell open which can be opened, so they are valid in every state
+const uint16_t levelPotentiallyVisibleSet[MAX_LEVEL_BYTES * MAX_ORIENTATION] PROGMEM =
+{
+  0x8cee, 0x830e, 0xb9ee, 0x810e, 0x8004, 0xc30c, 0xf3ce, 0x8046, 0x8004, 0x830c, 0xefee, 0x8466, 0x8004, 0x830c, 0xb9ce, 0x8466,
+  0x8004, 0x830c, 0xe3ce, 0x8066, 0xb9ce, 0x856e, 0x81ce, 0x846e, 0xefee, 0x8cee, 0x818e, 0x816e, 0xb9ce, 0x8466, 0x8004, 0xc30c,
+  0xefee, 0x804e, 0xf1ce, 0xe38e, 0xb9ce, 0xb9ce, 0x8066, 0xc30c, 0x800c, 0xb9ce, 0xb9ce, 0x8006, 0x800e, 0xb9ce, 0x830e, 0x80ce,
+  0x800e, 0xb1ce, 0x800e, 0x99ce, 0x800e, 0x818e, 0x806e, 0xb9ce, 0x8006, 0x800c, 0xb9ce, 0xb9ce, 0x9dce, 0x8046, 0x830c, 0xb9ce,
+  0x800c, 0xb9ce, 0x91ce, 0x8006, 0x800e, 0xb9ce, 0xa38e, 0x80ce, 0x800e, 0xb9ce, 0x816e, 0x9dee, 0x800e, 0xb9ce, 0xf1ce, 0xbdce,
+  0x800e, 0x91ce, 0xc30e, 0xb9ce, 0x800e, 0x808e, 0x800e, 0xb9ce, 0x8006, 0x8004, 0x800c, 0xb9ce, 0xb9ce, 0x818e, 0xb9ce, 0xb9ce,
+  0x8004, 0x800c, 0xe38e, 0x8046, 0x810e, 0x8dee, 0x816e, 0x8cee, 0x818e, 0x806e, 0xb9ce, 0x800e, 0x81ce, 0x8066, 0x830c, 0x81ce,
+  0x81ce, 0x806e, 0xb9ce, 0x830e, 0x81ce, 0x81ce, 0x8066, 0x830c, 0x80ce, 0x800e, 0xb9ce, 0x830e, 0x804e, 0xbbce, 0x836e, 0xe3ce,
+  0x818e, 0x8cee, 0x808e, 0x800e, 0x81ce, 0x8066, 0x810c, 0x81ce, 0x81ce, 0x8dee, 0xb9ce, 0xbbce, 0x81ce, 0x806e, 0xe38e, 0x834e,
+  0x81ce, 0x8066, 0x810c, 0xefee, 0x81ce, 0xc34e, 0xb9ce, 0x830e, 0x80ce, 0x99ce, 0xefee, 0x834e, 0x810c, 0x80ce, 0xbdce, 0x8466,
+  0x808e, 0x8006, 0x830c, 0x8cee, 0xc34e, 0x81ce, 0x806e, 0x9dce, 0xb1ce, 0x800e, 0xb9ce, 0x800e, 0x806e, 0x818e, 0x876e, 0x81ce,
+  0x8004, 0x800c, 0x99ce, 0x8006, 0x830e, 0x81ce, 0x836e, 0x80ce, 0x99ce, 0x800e, 0xb1ce, 0x800e, 0x856e, 0x9dee, 0xc34e, 0x81ce,
+  0xf3ce, 0x8046, 0x8004, 0x800c, 0xb9ee, 0x99ce, 0x846e, 0x818e, 0xc30c, 0x80ce, 0xfdce, 0x8006, 0xb9ce, 0x8006, 0xc30c, 0x80ce,
+  0x846e, 0xb9ce, 0x8cee, 0x99ce, 0x800c, 0xfdce, 0xb9ce, 0x8046, 0x810e, 0xefee, 0x876e, 0x88ee, 0xa38e, 0x814e, 0x9dee, 0x9dce,
+  0x91ce, 0x800e, 0xbbce, 0xb9ce, 0x830c, 0x81ce, 0x8066, 0x8004, 0xb9ce, 0x800e, 0xb9ce, 0x800e, 0x816e, 0xe3ce, 0x834e, 0x81ce,
+  0x808e, 0x830e, 0x80ce, 0x800e, 0x834e, 0x81ce, 0x81ce, 0x81ce, 0xb9ce, 0x800e, 0x818e, 0x806e, 0xc36e, 0x8cee, 0x810e, 0x8dee,
+  0xf9ce, 0x8006, 0x8004, 0x800c, 0x810c, 0xefee, 0xb1ce, 0x8006, 0xe38e, 0x814e, 0xefee, 0x804e, 0xb9ce, 0xbdce, 0xb9ce, 0x8dee,
+  0x810c, 0x8dee, 0x8066, 0x8004, 0x818e, 0x846e, 0xb1ce, 0x808e, 0xe3ce, 0xf3ce, 0xc34e, 0x91ce, 0xf1ce, 0x818e, 0x88ee, 0x830e,
+  0x8066, 0x800c, 0x91ce, 0xe3ce, 0x830e, 0x81ce, 0x876e, 0xf9ee, 0xb9ce, 0x800e, 0x99ce, 0x800e, 0x836e, 0xb9ce, 0x830e, 0x81ce,
+  0x91ce, 0x99ce, 0x8006, 0x800c, 0x836e, 0x80ce, 0x800e, 0x818e, 0xb9ce, 0x8006, 0x800c, 0xb1ce, 0x8066, 0x8004, 0x800c, 0xb9ce,
+  0x800c, 0xb9ce, 0x81ce, 0x8066, 0xc30c, 0xf1ce, 0x818e, 0x8066, 0xf1ce, 0xe38e, 0x816e, 0x8cee, 0x8066, 0x830c, 0xf9ce, 0x9dce,
+  0xe38e, 0x81ce, 0xe3ce, 0xb9ce, 0xb1ce, 0x800e, 0x818e, 0x856e, 0x836e, 0xb9ee, 0x810e, 0xafee, 0xb9ce, 0x81ce, 0x8046, 0x800c,
+  0x8cee, 0x800e, 0x808e, 0x818e, 0x834e, 0xe3ce, 0x814e, 0xf3ce, 0xb9ce, 0x830e, 0x80ce, 0x800e, 0x8066, 0xc30c, 0x81ce, 0x81ce,
+  0xb9ce, 0x876e, 0x8dee, 0x806e, 0xefee, 0x834e, 0xb9ce, 0x816e, 0xb9ce, 0x830e, 0xe3ce, 0xc36e, 0x8004, 0x830c, 0x81ce, 0x8466,
+  0x810e, 0x8cee, 0x800e, 0xb9ce, 0xe38e, 0x8066, 0x800c, 0xb9ce, 0xb9ce, 0xb9ce, 0xfdee, 0xb9ce, 0x8cee, 0x99ce, 0xfbce, 0x834e,
+  0x834e, 0x80ce, 0xc30e, 0xefee, 0xb9ce, 0x8006, 0x800c, 0xfdce, 0x8466, 0x8004, 0x800c, 0xb9ce, 0xbbce, 0x80ce, 0x8006, 0x800c,
+  0x9dee, 0x8006, 0x8004, 0x810c, 0x876e, 0xb9ce, 0x800e, 0xe38e, 0xb9ce, 0xb9ce, 0x8006, 0x800c, 0x806e, 0xb9ce, 0x800e, 0x818e,
+  0x800e, 0xb9ce, 0x846e, 0xb1ce, 0x800e, 0xb9ce, 0xb9ce, 0xb9ce, 0x800e, 0xb9ce, 0xc30e, 0xb9ce, 0x800e, 0x9dce, 0x800e, 0xb9ce,
+  0xe3ce, 0x8046, 0x8004, 0x830c, 0xf1ce, 0xffce, 0xb9ce, 0x830e, 0x830c, 0x8dee, 0xefee, 0x8046, 0x9dce, 0x846e, 0xb9ce, 0x8cee,
+  0xefee, 0x8046, 0x830c, 0x9dee, 0xb9ce, 0x800e, 0xb9ce, 0xc30e, 0x8004, 0x8004, 0x8004, 0x8004, 0x8004, 0x800c, 0xb9ce, 0x8006,
+  0xbdce, 0x8006, 0x8004, 0x800c, 0x8004, 0x800c, 0xb9ce, 0x8006, 0xb9ce, 0x8066, 0x8004, 0x800c, 0x8dee, 0xc36e, 0xb9ce, 0x810e,
+  0x81ce, 0xefee, 0xefee, 0xc34e, 0x81ce, 0xc36e, 0xb9ce, 0x876e, 0x81ce, 0x816e, 0xefee, 0xefee, 0x81ce, 0x846e, 0xb9ce, 0x876e,
+  0x800e, 0xbdce, 0xc36e, 0xb9ce, 0x810c, 0xbdee, 0xb9ce, 0x8006, 0xe38e, 0x81ce, 0x836e, 0x80ce, 0xb9ce, 0x800e, 0x91ce, 0x99ce,
+  0x806e, 0xe38e, 0x836e, 0xbbce, 0x8004, 0xc30c, 0xb9ce, 0x8006, 0x800e, 0xe38e, 0xefee, 0x80ce, 0x8004, 0xc30c, 0xb9ce, 0x8466,
+  0x800e, 0x818e, 0xefee, 0x8cee, 0x8004, 0x800c, 0xb9ce, 0x8466, 0x800e, 0xb9ce, 0x836e, 0x8cee, 0x800c, 0xb9ce, 0x91ce, 0x8006,
+  0xc30e, 0xb9ce, 0x876e, 0x80ce, 0xb9ce, 0xb1ce, 0xb9ce, 0x99ce, 0x846e, 0x818e, 0x836e, 0xb9ce, 0x8006, 0x800c, 0xb9ce, 0xb9ce,
+  0x814e, 0x8dee, 0x876e, 0xefee, 0xe38e, 0x846e, 0x9dce, 0x800e, 0xf3ce, 0x81ce, 0x834e, 0x81ce, 0xb9ee, 0x800e, 0x808e, 0x830e,
+  0x856e, 0xb9ce, 0x856e, 0xe3ce, 0x808e, 0xb9ce, 0xb9ce, 0x800e, 0x814e, 0xb9ce, 0x876e, 0x81ce, 0x808e, 0xb9ce, 0xbdce, 0xb9ce,
+  0x814e, 0x81ce, 0xc36e, 0xb9ce, 0x808e, 0x800e, 0xf9ce, 0xb9ce, 0x814e, 0x8dee, 0xc34e, 0xb9ce, 0x818e, 0x846e, 0x808e, 0x800e,
+  0xe3ce, 0xefee, 0x816e, 0x81ce, 0xb9ce, 0xc36e, 0xf1ce, 0x830e, 0x8dee, 0x81ce, 0xefee, 0xe3ce, 0x80ce, 0x800e, 0xb9ce, 0xc76e,
+  0xc76e, 0xe3ce, 0xc34e, 0xb9ce, 0xf1ce, 0x810e, 0x8cee, 0x800e, 0x836e, 0x80ce, 0xb9ce, 0x81ce, 0xbdce, 0x8006, 0x8004, 0x800c,
+  0x876e, 0xefee, 0x806e, 0x818e, 0x91ce, 0xc76e, 0xb9ce, 0x800e, 0xabee, 0xefee, 0xefee, 0x81ce, 0x91ce, 0xc76e, 0xbdee, 0xc76e,
+  0xabee, 0x81ce, 0xffee, 0xefee, 0x91ce, 0x800e, 0xfbce, 0xc76e, 0xc36e, 0x80ce, 0xc30e, 0xefee, 0xb1ce, 0x8006, 0x8004, 0x800c,
+  0xc36e, 0xb9ce, 0xf9ce, 0x818e, 0xb9ce, 0xb9ce, 0xe38e, 0x804e, 0x876e, 0x81ce, 0x816e, 0x8dee, 0x99ce, 0x800e, 0xf1ce, 0xbdce,
+  0x836e, 0xf1ce, 0x810e, 0xefee, 0xb9ce, 0xe38e, 0x8066, 0x800c, 0x8066, 0x830c, 0xb9ce, 0x818e, 0xb9ce, 0xc30e, 0xe3ce, 0xb1ce,
+  0xc30c, 0xb9ce, 0x8dee, 0x8466, 0xb9ce, 0xf9ce, 0xb9ce, 0x806e, 0xc36e, 0xfbce, 0x876e, 0x8dee, 0xb9ce, 0xfbce, 0xbdee, 0xbdce,
+  0x876e, 0xe3ce, 0xffee, 0xb9ce, 0xb9ce, 0xc30e, 0xfbce, 0xbdee, 0x8466, 0xc30c, 0xefee, 0xbdee, 0xb9ce, 0x9dce, 0xb9ee, 0x846e,
+  0x830c, 0x8cee, 0xf3ce, 0x8066, 0xb9ce, 0x8466, 0xc30c, 0x8cee, 0xefee, 0x81ce, 0xb9ce, 0x9dce, 0xb9ce, 0x800e, 0xe38e, 0xc34e,
+  0x8466, 0xc30c, 0x80ce, 0x99ce, 0xb9ce, 0xb9ce, 0x8dee, 0x804e, 0x8cee, 0xb9ce, 0x99ce, 0x816e, 0x804e, 0xfdce, 0x830e, 0xefee,
+  0x830e, 0xefee, 0x806e, 0xfdce, 0xb9ce, 0xc76e, 0xb9ce, 0xb9ce, 0xefee, 0xffee, 0xefee, 0xb9ce, 0xb9ce, 0xffee, 0xb9ce, 0xc76e,
+  0xefee, 0xb9ce, 0xefee, 0xefee, 0xb9ce, 0xf9ce, 0xb9ce, 0xffee, 0x806e, 0xbfce, 0x836e, 0xffee, 0x810e, 0x8dee, 0x91ce, 0xfdce,
+  0xe38e, 0x804e, 0xa38e, 0xb9ce, 0xb9ce, 0x99ce, 0x856e, 0xbdee, 0x830c, 0x80ce, 0xbdce, 0x8006, 0xb9ce, 0x8006, 0xc30c, 0x80ce,
+  0x800c, 0xfdce, 0x8006, 0x8004, 0x830e, 0xafee, 0x804e, 0x808e, 0x9dce, 0x816e, 0x80ce, 0x91ce, 0x8dee, 0x846e, 0x818e, 0xb9ce,
+  0xe3ce, 0xb9ce, 0x8466, 0xc30c, 0xb9ce, 0xbdce, 0x99ce, 0x830e, 0xc36e, 0xbdee, 0x876e, 0xe3ce, 0xfbce, 0xbdee, 0xb9ce, 0xf9ce,
+  0xffee, 0x8dee, 0xc36e, 0xb9ce, 0xbdee, 0x806e, 0xb1ce, 0xfbce, 0x8dee, 0x9dee, 0xc34e, 0xfbce, 0xe3ce, 0x80ce, 0x808e, 0xc30e,
+  0xf1ce, 0x8006, 0x810c, 0xe3ce, 0x816e, 0xefee, 0x80ce, 0xfbce, 0xe38e, 0x814e, 0x8dee, 0x804e, 0xb9ce, 0xb9ce, 0x99ce, 0x89ee,
+  0x818e, 0x846e, 0x818e, 0xb9ce, 0xe3ce, 0x91ce, 0x8006, 0x810c, 0xb9ce, 0x808e, 0x8006, 0x830c, 0x8066, 0x8004, 0x800c, 0xe38e,
+  0x830e, 0xefee, 0x804e, 0xf1ce, 0xb9ce, 0xc76e, 0x80ce, 0x800e, 0xefee, 0xefee, 0x89ee, 0x81ce, 0xfbce, 0x876e, 0x91ce, 0xc36e,
+  0xffee, 0x81ce, 0xa3ce, 0xefee, 0xbdee, 0x800e, 0x818e, 0xc76e, 0xc76e, 0x8cee, 0x810e, 0xefee, 0xfbce, 0x8046, 0x8004, 0x800c,
+  0xbdee, 0xb9ce, 0x800e, 0x818e, 0xc30c, 0xf1ce, 0x8006, 0x8004, 0xf1ce, 0xa38e, 0x804e, 0x808e, 0x8066, 0x810c, 0x80ce, 0x91ce,
+  0x8046, 0x8004, 0x800c, 0xe38e, 0x8006, 0x8004, 0x800c, 0xf1ce, 0xb9ce, 0x8046, 0x8004, 0x800c, 0x8cee, 0x8006, 0x8004, 0x810c,
+  0xc30c, 0xb9ce, 0x8006, 0x8004, 0xb9ce, 0xb9ce, 0x8006, 0x800c, 0xc36e, 0xb9ce, 0x804e, 0x818e, 0xf9ce, 0x99ce, 0x808e, 0xb1ce,
+  0x876e, 0x80ce, 0x810e, 0xb9ce, 0xbdce, 0x8006, 0x800c, 0xb9ce, 0x8466, 0x830c, 0xb9ce, 0xb9ce, 0xf9ce, 0x830e, 0xe3ce, 0x804e,
+  0x8004, 0xc30c, 0x81ce, 0x8466, 0xe38e, 0x816e, 0x8dee, 0x806e, 0xb9ce, 0x91ce, 0xb9ce, 0x816e, 0x8cee, 0x808e, 0x8006, 0x830c,
 };
+#endif
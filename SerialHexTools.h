@@ -3,7 +3,12 @@
 #include <Arduino.h>
 
 #if !defined(__AVR_ATtiny85__)
-  static uint8_t hexdumpPositionCount = 0;
+  #if defined(ARDUINO_ARCH_HOST)
+    // the host runs games in several threads
+    static thread_local uint8_t hexdumpPositionCount = 0;
+  #else
+    static uint8_t hexdumpPositionCount = 0;
+  #endif
   static uint8_t hexdumpValuesPerLine = 16;
 
   void hexdumpResetPositionCount();
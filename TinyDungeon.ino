@@ -28,6 +28,9 @@
 #include "dungeon.h"
 #include "tinyJoypadUtils.h"
 #include "soundFX.h"
+#include "profiler.h"
+#include "microBenchmarks.h"
+#include "inputRecorder.h"
 
 static Dungeon _dungeon;
 
@@ -36,8 +39,14 @@ void setup()
 {
   // initialize the pins (and serial port if present)
   InitTinyJoypad();
+  // replay the recorded inputs? (if enabled)
+  INIT_INPUT_RECORDER();
   // perform display initialization
   InitDisplay();
+  // start the profiler (if enabled)
+  PROFILER_INIT();
+  // run the micro benchmarks (if enabled)
+  RUN_MICRO_BENCHMARKS( _dungeon );
 }
 
 /*--------------------------------------------------------*/
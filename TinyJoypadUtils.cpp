@@ -9,14 +9,46 @@
 
 #include <Arduino.h>
 #include "tinyJoypadUtils.h"
+#include "profiler.h"
 
 #if defined(__AVR_ATtiny85__)
-  #include <ssd1306xled.h>
+  #ifdef _USE_USI_I2C_
+    #include "ssd1306USI.h"
+  #else
+    #include <ssd1306xled.h>
+    // the pins ssd1306xled uses
+    #ifndef SSD1306_SDA
+      #define SSD1306_SDA  PB0
+    #endif
+    #ifndef SSD1306_SCL
+      #define SSD1306_SCL  PB2
+    #endif
+  #endif
 #else
-  // include Adafruit library and immediately create an object
-  #include <Adafruit_SSD1306.h>
-  Adafruit_SSD1306 display( 128, 64, &Wire, -1 );
+  #ifdef _USE_ASYNC_DISPLAY_
+    // interrupt driven transport, the rows are sent directly from the frame buffer
+    #include "ssd1306TWI.h"
+    uint8_t frameBuffer[128 * 8];
+    #define DISPLAY_BUFFER  frameBuffer
+    // start of the current row in the frame buffer
+    uint8_t *asyncRowStart;
+    #ifdef _USE_VERTICAL_ADDRESSING_
+      // column range of PrepareDisplayColumns()
+      uint8_t asyncStartColumn;
+      uint8_t asyncEndColumn;
+    #endif
+  #else
+    // include Adafruit library and immediately create an object
+    #include <Adafruit_SSD1306.h>
+    Adafruit_SSD1306 display( 128, 64, &Wire, -1 );
+    #define DISPLAY_BUFFER  display.getBuffer()
+  #endif
+  // current write position in the buffer (used by SendPixels())
   uint8_t *adafruitBuffer;
+  #ifdef _USE_VERTICAL_ADDRESSING_
+    // current page in vertical addressing mode (0xff means page addressing mode)
+    uint8_t adafruitPage = 0xff;
+  #endif
 
   // these functions are only required if a screenshot should be printed as a hexdump to the serial port
   #ifdef _ENABLE_SERIAL_SCREENSHOT_
@@ -181,6 +213,8 @@ void InitDisplay()
 {
 #if defined(__AVR_ATtiny85__) /* codepath for ATtiny85 */
   SSD1306.ssd1306_init();
+#elif defined(_USE_ASYNC_DISPLAY_)
+  ssd1306TWI_init();
 #else
   // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
   // Address 0x3D for 128x64
@@ -193,8 +227,8 @@ void InitDisplay()
 }
 
 /*-------------------------------------------------------*/
-// This code will init the display for row <y>
-void PrepareDisplayRow( uint8_t y )
+// This code will init the display for row <y> (starting at column <startColumn>)
+void PrepareDisplayRow( uint8_t y, uint8_t startColumn )
 {
 #if defined(__AVR_ATtiny85__)  /* codepath for ATtiny85 */
     // initialize image transfer to segment 'y'
@@ -202,52 +236,196 @@ void PrepareDisplayRow( uint8_t y )
   #ifdef _USE_SH1106_
     // SH1106 internally uses 132 pixels/line,
     // output is (always?) centered, so we need to start at position 2
-    SSD1306.ssd1306_send_command(0x02);
-    SSD1306.ssd1306_send_command(0x10);  
-  #else
-    // classic SSD1306 supports only 128 pixels/line, so we start at 0
-    SSD1306.ssd1306_send_command(0x00);
-    SSD1306.ssd1306_send_command(0x10);  
-  #endif    
+    startColumn += 2;
+  #endif
+    // classic SSD1306 supports only 128 pixels/line
+    SSD1306.ssd1306_send_command( startColumn & 0x0f );
+    SSD1306.ssd1306_send_command( 0x10 | ( startColumn >> 4 ) );
     SSD1306.ssd1306_send_data_start();
 
 #else  /* codepath for any Adafruit_SSD1306 supported MCU */
 
+  #ifdef _USE_ASYNC_DISPLAY_
+  // the row of the last frame might still be on its way
+  ssd1306TWI_waitForPage( y );
+  #endif
   // address the display buffer
-  adafruitBuffer = display.getBuffer() + ( y * 128 );
+  adafruitBuffer = DISPLAY_BUFFER + ( y * 128 ) + startColumn;
+  #ifdef _USE_ASYNC_DISPLAY_
+  asyncRowStart = adafruitBuffer;
+  #endif
 #endif
 }
 
+#if defined(__AVR_ATtiny85__) && !defined(_USE_USI_I2C_)
+/*-------------------------------------------------------*/
+// Clocks out a byte in the current data transmission of ssd1306xled with the
+// same pin sequence as its ssd1306_send_byte(), but inlined into the run loops:
+// no call per byte, and the bits come from the MSB instead of shifting by the bit number
+static inline void xledClockOutByte( uint8_t byte )
+{
+  for ( uint8_t n = 0; n < 8; n++ )
+  {
+    if ( byte & 0x80 ) { PORTB |= ( 1 << SSD1306_SDA ); }
+    else               { PORTB &= ~( 1 << SSD1306_SDA ); }
+    PORTB |= ( 1 << SSD1306_SCL );
+    PORTB &= ~( 1 << SSD1306_SCL );
+    byte <<= 1;
+  }
+  // acknowledge bit (ignored, like ssd1306xled does)
+  PORTB |= ( 1 << SSD1306_SDA );
+  PORTB |= ( 1 << SSD1306_SCL );
+  PORTB &= ~( 1 << SSD1306_SCL );
+}
+#endif
+
 /*-------------------------------------------------------*/
-void SendPixels( uint8_t pixels )
+// Sends <count> bytes from RAM to the display
+void SendPixelRun( const uint8_t *pixels, uint8_t count )
 {
 #if defined(__AVR_ATtiny85__) /* codepath for ATtiny85 */
-  // send a byte directly to the SSD1306
-  SSD1306.ssd1306_send_byte( pixels );
+  #ifdef _USE_USI_I2C_
+  // one burst in the current data transmission
+  SSD1306.ssd1306_send_run( pixels, count );
+  #else
+  // one burst in the data transmission ssd1306xled has started
+  while ( count-- )
+  {
+    xledClockOutByte( *pixels++ );
+  }
+  #endif
+#else  /* codepath for any Adafruit_SSD1306 supported MCU */
+  #ifdef _USE_VERTICAL_ADDRESSING_
+  if ( adafruitPage != 0xff )
+  {
+    // the bytes aren't consecutive in the buffer
+    while ( count-- ) { SendPixels( *pixels++ ); }
+    return;
+  }
+  #endif
+  memcpy( adafruitBuffer, pixels, count );
+  adafruitBuffer += count;
+#endif
+}
 
+/*-------------------------------------------------------*/
+// Sends <count> bytes from flash to the display
+void SendPixelRun_P( const uint8_t *pixels, uint8_t count )
+{
+#if defined(__AVR_ATtiny85__) /* codepath for ATtiny85 */
+  #ifdef _USE_USI_I2C_
+  // one burst in the current data transmission
+  SSD1306.ssd1306_send_run_P( pixels, count );
+  #else
+  // one burst in the data transmission ssd1306xled has started
+  while ( count-- )
+  {
+    xledClockOutByte( pgm_read_byte( pixels++ ) );
+  }
+  #endif
 #else  /* codepath for any Adafruit_SSD1306 supported MCU */
-  // write pixels directly to the buffer
-  *adafruitBuffer++ = pixels;
+  #ifdef _USE_VERTICAL_ADDRESSING_
+  if ( adafruitPage != 0xff )
+  {
+    // the bytes aren't consecutive in the buffer
+    while ( count-- ) { SendPixels( pgm_read_byte( pixels++ ) ); }
+    return;
+  }
+  #endif
+  memcpy_P( adafruitBuffer, pixels, count );
+  adafruitBuffer += count;
 #endif
 }
 
 /*-------------------------------------------------------*/
-// This code will finish a row (only on Tiny85)
+// This code will finish a row (only on Tiny85 or with the async display)
 void FinishDisplayRow()
 {
 #if defined(__AVR_ATtiny85__)
   // this line appears to be optional, as it was never called during the intro screen...
   // but hey, we still have some bytes left ;)
   SSD1306.ssd1306_send_data_stop();
+#elif defined(_USE_ASYNC_DISPLAY_)
+  // send the row in the background, while the next one is rendered
+  uint16_t offset = asyncRowStart - DISPLAY_BUFFER;
+  ssd1306TWI_queueRow( asyncRowStart, offset / 128, offset % 128, adafruitBuffer - asyncRowStart );
+#endif
+}
+
+#ifdef _USE_VERTICAL_ADDRESSING_
+/*-------------------------------------------------------*/
+// This code will switch the display to vertical addressing mode,
+// so every following call to SendPixels() fills the columns
+// <startColumn>..<endColumn> from top to bottom (8 bytes per column).
+void PrepareDisplayColumns( uint8_t startColumn, uint8_t endColumn )
+{
+#if defined(__AVR_ATtiny85__)  /* codepath for ATtiny85 */
+  // vertical addressing mode
+  SSD1306.ssd1306_send_command(0x20);
+  SSD1306.ssd1306_send_command(0x01);
+  // set column range
+  SSD1306.ssd1306_send_command(0x21);
+  SSD1306.ssd1306_send_command(startColumn);
+  SSD1306.ssd1306_send_command(endColumn);
+  // use all 8 pages
+  SSD1306.ssd1306_send_command(0x22);
+  SSD1306.ssd1306_send_command(0x00);
+  SSD1306.ssd1306_send_command(0x07);
+  SSD1306.ssd1306_send_data_start();
+
+#else  /* codepath for any Adafruit_SSD1306 supported MCU */
+
+  #ifdef _USE_ASYNC_DISPLAY_
+  // the columns of all pages are written
+  ssd1306TWI_waitUntilDone();
+  asyncStartColumn = startColumn;
+  asyncEndColumn = endColumn;
+  #else
+  // the end column is implicitly given by the number of bytes sent
+  (void)endColumn;
+  #endif
+  // address the display buffer
+  adafruitBuffer = DISPLAY_BUFFER + startColumn;
+  adafruitPage = 0;
+#endif
+}
+
+/*-------------------------------------------------------*/
+// This code will finish the column output and switch
+// the display back to page addressing mode
+void FinishDisplayColumns()
+{
+#if defined(__AVR_ATtiny85__)
+  SSD1306.ssd1306_send_data_stop();
+  // restore the column range and page addressing mode for PrepareDisplayRow()
+  SSD1306.ssd1306_send_command(0x21);
+  SSD1306.ssd1306_send_command(0x00);
+  SSD1306.ssd1306_send_command(0x7f);
+  SSD1306.ssd1306_send_command(0x20);
+  SSD1306.ssd1306_send_command(0x02);
+#else
+  adafruitPage = 0xff;
+  #ifdef _USE_ASYNC_DISPLAY_
+  // the columns are complete now, so they are sent page by page
+  for ( uint8_t y = 0; y < 8; y++ )
+  {
+    ssd1306TWI_queueRow( DISPLAY_BUFFER + y * 128 + asyncStartColumn, y, asyncStartColumn, asyncEndColumn - asyncStartColumn + 1 );
+  }
+  #endif
 #endif
 }
+#endif
 
 /*-------------------------------------------------------*/
 void DisplayBuffer()
 {
 #if !defined(__AVR_ATtiny85__) /* codepath for any Adafruit_SSD1306 supported MCU */
+  #ifndef _USE_ASYNC_DISPLAY_
+  PROFILER_START( PROFILE_DISPLAY );
   // display buffer (not necessary)
   display.display();
+  PROFILER_STOP( PROFILE_DISPLAY );
+  #endif
 
   // slow down fast microcontrollers
   #if defined(_VARIANT_ARDUINO_ZERO_)
@@ -280,7 +458,7 @@ void SerialScreenshot()
     Serial.println( F("(4) Rotate and mirror the result as needed :)\r\n") );
     Serial.println( F("Hint: If you only get partial screenshots, try using a terminal program to capture the serial output.") );
     // output the full buffer as a hexdump to the serial port
-    printScreenBufferToSerial( display.getBuffer(), 128, 8 );
+    printScreenBufferToSerial( DISPLAY_BUFFER, 128, 8 );
   #endif
 #endif
 }
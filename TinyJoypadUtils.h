@@ -19,6 +19,33 @@
 // Uncomment the following line to activate SH1106 support 
 //#define _USE_SH1106_
 
+////////////////////////////////////////////////////////////
+// Uncomment the following line to render the screen column by column
+// using the vertical addressing mode of the SSD1306 (not supported by SH1106!)
+//#define _USE_VERTICAL_ADDRESSING_
+
+#if defined(_USE_VERTICAL_ADDRESSING_) && defined(_USE_SH1106_)
+  #error "The SH1106 doesn't support the vertical addressing mode!"
+#endif
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to use the built-in USI I2C transport
+// on the ATtiny85 instead of the ssd1306xled library (see ssd1306USI.h)
+//#define _USE_USI_I2C_
+// Uncomment the following line to run the USI I2C transport in fast-mode plus (1 MHz),
+// many SSD1306 panels work fine with it, although the datasheet only specifies 400 kHz
+//#define _USE_USI_I2C_FAST_MODE_PLUS_
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to send each finished row by an interrupt driven
+// TWI transmitter, while the next row is already rendered (AVR ATmega only).
+// This replaces Adafruit_SSD1306 and Wire (see ssd1306TWI.h)
+//#define _USE_ASYNC_DISPLAY_
+
+#if defined(_USE_ASYNC_DISPLAY_) && ( !defined(__AVR__) || defined(__AVR_ATtiny85__) )
+  #error "The async display pipeline requires the TWI hardware of an AVR ATmega!"
+#endif
+
 ////////////////////////////////////////////////////////////
 // Uncomment the following line to enable serial screenshot
 //#define _ENABLE_SERIAL_SCREENSHOT_
@@ -91,15 +118,66 @@ void Sound( const uint8_t freq, const uint8_t dur );
 
 // functions to simplify display handling between ATtiny85 and Ardafruit_SSD1306
 void InitDisplay();
-void PrepareDisplayRow( uint8_t y );
-void SendPixels( uint8_t pixels );
+void PrepareDisplayRow( uint8_t y, uint8_t startColumn = 0 );
+inline void SendPixels( uint8_t pixels );
+void SendPixelRun( const uint8_t *pixels, uint8_t count );
+void SendPixelRun_P( const uint8_t *pixels, uint8_t count );
 void FinishDisplayRow();
 void DisplayBuffer();
+#ifdef _USE_VERTICAL_ADDRESSING_
+// functions for column wise display output (8 bytes per column, top to bottom)
+void PrepareDisplayColumns( uint8_t startColumn, uint8_t endColumn );
+void FinishDisplayColumns();
+#endif
 
 // screenshot functions
 void SerialScreenshot();
 void CheckForSerialScreenshot();
 
+// SendPixels() is called 1024 times per frame, so it's inlined
+#if defined(__AVR_ATtiny85__)
+  #ifdef _USE_USI_I2C_
+    #include "ssd1306USI.h"
+  #else
+    #include <ssd1306xled.h>
+  #endif
+#else
+  // current write position in the Adafruit_SSD1306 buffer
+  extern uint8_t *adafruitBuffer;
+  #ifdef _USE_VERTICAL_ADDRESSING_
+    // current page in vertical addressing mode (0xff means page addressing mode)
+    extern uint8_t adafruitPage;
+  #endif
+#endif
+
+/*-------------------------------------------------------*/
+inline void SendPixels( uint8_t pixels )
+{
+#if defined(__AVR_ATtiny85__) /* codepath for ATtiny85 */
+  // send a byte directly to the SSD1306
+  SSD1306.ssd1306_send_byte( pixels );
+
+#else  /* codepath for any Adafruit_SSD1306 supported MCU */
+  #ifdef _USE_VERTICAL_ADDRESSING_
+  if ( adafruitPage != 0xff )
+  {
+    // write pixels to the buffer and move down one page
+    *adafruitBuffer = pixels;
+    adafruitBuffer += 128;
+    // column finished? -> back to the top of the next column
+    if ( ++adafruitPage == 8 )
+    {
+      adafruitPage = 0;
+      adafruitBuffer -= 8 * 128 - 1;
+    }
+    return;
+  }
+  #endif
+  // write pixels directly to the buffer
+  *adafruitBuffer++ = pixels;
+#endif
+}
+
 #ifdef ENABLE_OLD_TINYFLIP_NAMING_CONVENTION
   #define TinyFlip_PrepareDisplayRow        PrepareDisplayRow
   #define TinyFlip_SendPixels               SendPixels
@@ -2,171 +2,411 @@
 #include "dungeon.h"
 #include "monsterBitmaps.h"
 #include "objectBitmaps.h"
+#ifdef _USE_PRECOMPUTED_PVS_
+  #include "LevelDefinitions.h"
+#endif
+#include "profiler.h"
 #include "wallBitmaps.h"
 
 /*--------------------------------------------------------*/
-uint8_t Dungeon::getWallPixels( const int8_t x, const int8_t y )
+// Returns a pointer to the cell which is 'distance' away from the player
+// and 'offsetLR' to the right, as seen in direction 'orientation'.
+// The step vectors are known at compile time, so there is no switch.
+template <uint8_t orientation>
+uint8_t *Dungeon::getViewCell( const int8_t distance, const int8_t offsetLR )
 {
-  uint8_t pixels = 0;
+  int8_t x = _dungeon.playerX + distance * ORIENTATION_STEPS<orientation>::distanceX + offsetLR * ORIENTATION_STEPS<orientation>::offsetX;
+  int8_t y = _dungeon.playerY + distance * ORIENTATION_STEPS<orientation>::distanceY + offsetLR * ORIENTATION_STEPS<orientation>::offsetY;
 
-  SIMPLE_WALL_INFO wallInfo;
-  
-  const SIMPLE_WALL_INFO *wallInfoPtr = arrayOfWallInfo;
+  limitDungeonPosition( x, y );
 
-  // all objects are visible
-  int8_t maxObjectDistance = MAX_VIEW_DISTANCE;
+  FRAME_STATS_ADD( cellLookups, 1 );
+
+  return( _dungeon.currentLevel + y * getLevelWidth() + x );
+}
+
+/*--------------------------------------------------------*/
+// The generic version uses the player's current orientation
+template <>
+uint8_t *Dungeon::getViewCell<ANY_ORIENTATION>( const int8_t distance, const int8_t offsetLR )
+{
+  return( getCellRaw( _dungeon.playerX, _dungeon.playerY, distance, offsetLR, _dungeon.dir ) );
+}
+
+/*--------------------------------------------------------*/
+// Shading effect to pronounce the distance of walls and objects
+static inline uint8_t shadePixels( uint8_t pixels, const uint8_t distance, const int8_t x )
+{
+#ifdef _ENABLE_SHADING_
+  switch ( distance )
+  {
+    case 0:
+    case 1:
+      break;
+    case 2:
+      if ( x & 1 ) { pixels &= 0x55; }
+      else { pixels &= 0xaa; }
+      break;
+    default:
+      if ( x & 1 ) { pixels &= 055; }
+      else { pixels &= 0x00; }
+  }
+#endif
+  return( pixels );
+}
 
-  //int8_t objectNo = -1;
+/*--------------------------------------------------------*/
+// Finds the closest wall in column x: Returns true if there is one,
+// 'wallInfo' is its entry and 'offsetX' the column of its bitmap
+// (mirrored on odd fields).
+template <uint8_t orientation>
+bool Dungeon::findWallEntry( const int8_t x, SIMPLE_WALL_INFO &wallInfo, uint8_t &offsetX )
+{
+  const SIMPLE_WALL_INFO *wallInfoPtr = arrayOfWallInfo;
 
   // iterate through the whole list (at least as long as it's necessary)
   while( true )
   {
     // the structure resides in PROGMEM, so we need to copy it to RAM first...
     memcpy_P( &wallInfo, wallInfoPtr, sizeof( wallInfo ) );
+    FRAME_STATS_ADD( wallEntriesTested, 1 );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( wallInfo ) );
 
     // end of list reached?
-    if ( wallInfo.wallBitmap == nullptr ) { break; }
-    
-    //objectNo++;
+    if ( wallInfo.wallBitmap == nullptr ) { return( false ); }
 
-    // check conditions
-    if ( ( x >= wallInfo.startPosX ) && ( x <= wallInfo.endPosX ) )
+    // check conditions (cells hidden behind other walls can be skipped)
+    if ( ( x >= wallInfo.startPosX ) && ( x <= wallInfo.endPosX ) && isCellVisible( wallInfo.viewDistance, wallInfo.leftRightOffset ) )
     {
-      bool mirror = ( ( _dungeon.playerX + _dungeon.playerY ) & 0x01 );
-
       // is there a wall object?
     #ifdef _USE_FIELD_OF_VIEW_
       if ( ( getCell( wallInfo.viewDistance, wallInfo.leftRightOffset ) & WALL_MASK ) == ( WALL & ~FLAG_SOLID ) )
     #else
-      if ( ( *( getCellRaw( _dungeon.playerX, _dungeon.playerY, wallInfo.viewDistance, wallInfo.leftRightOffset, _dungeon.dir ) ) & WALL_MASK ) == ( WALL & ~FLAG_SOLID ) )
+      if ( ( *( getViewCell<orientation>( wallInfo.viewDistance, wallInfo.leftRightOffset ) ) & WALL_MASK ) == ( WALL & ~FLAG_SOLID ) )
     #endif
       {
-        //if ( y == 0 ) { Serial.print( F("column = ") ); Serial.print( x ); Serial.print( F(" -> objectNo = ") ); Serial.println( objectNo ); }
-
-        // split combined positions into start and end
-        int8_t startPosY = wallInfo.posStartEndY / 16;
-        int8_t endPosY = wallInfo.posStartEndY & 0x0f;
+        bool mirror = ( ( _dungeon.playerX + _dungeon.playerY ) & 0x01 );
 
-        // is there wall information for this vertical position
-        if ( ( y >= startPosY ) && ( y <= endPosY ) )
+        // is the bitmap smaller than the screen?
+        if ( wallInfo.width < WINDOW_SIZE_X )
         {
-          uint8_t offsetX;
-
-          // is the bitmap smaller than the screen?
-          bool smallBitmap = ( wallInfo.width < WINDOW_SIZE_X );
+          // positions are to be considered relative to the bitmap
+          int8_t posX = x - wallInfo.startPosX;
 
-          if ( smallBitmap )
+          if ( mirror )
           {
-            // positions are to be considered relative to the bitmap
-            int8_t posX = x - wallInfo.startPosX;
-
-            if ( mirror )
-            {
-              offsetX = wallInfo.width - 1 - posX - wallInfo.relPos;
-            }
-            else
-            {
-              offsetX = posX + wallInfo.relPos;
-            }
+            offsetX = wallInfo.width - 1 - posX - wallInfo.relPos;
           }
           else
           {
-            // mirror walls on odd fields
-            offsetX = mirror ? ( WINDOW_SIZE_X - 1 ) - x : x;
-          }
-
-          // get wall pixels (shave off the empty rows)
-          pixels = pgm_read_byte( wallInfo.wallBitmap + ( y - startPosY ) * wallInfo.width + offsetX );
-
-        #ifdef _ENABLE_SHADING_
-          switch ( wallInfo.viewDistance )
-          {
-            case 0:
-            case 1:
-              break;
-            case 2:
-              if ( x & 1 ) { pixels &= 0x55; }
-              else { pixels &= 0xaa; }
-              break;
-            default:
-              if ( x & 1 ) { pixels &= 055; }
-              else { pixels &= 0x00; }
+            offsetX = posX + wallInfo.relPos;
           }
-        #endif
         }
         else
         {
-          // nope, just nothing
-          pixels = 0;
+          // mirror walls on odd fields
+          offsetX = mirror ? ( WINDOW_SIZE_X - 1 ) - x : x;
         }
-        // objects behind walls are not visible, but doors or switches might be placed *on* walls
-        maxObjectDistance = wallInfo.viewDistance;
         // that's it!
-        break;
+        return( true );
       }
     }
     // move to next entry
     wallInfoPtr++;
   }
+}
 
+/*--------------------------------------------------------*/
+// Draws the NWOs (Non Wall Objects) of column x over the background pixels
+// of 'rows' rows starting with row 'y' (with mask!). Objects at distances
+// beyond 'maxObjectDistance' are hidden behind a wall.
+template <uint8_t orientation>
+void Dungeon::drawObjects( const int8_t x, const uint8_t y, const uint8_t rows, uint8_t *pixels, const uint8_t maxObjectDistance )
+{
   NON_WALL_OBJECT object;
 
-  // draw NWOs (Non Wall Objects) over the background pixels (with mask!)
   for ( uint8_t distance = maxObjectDistance; distance > 0; distance-- )
   {
+    // objects hidden behind walls can be skipped
+    if ( !isCellVisible( distance, 0 ) ) { continue; }
+
+    // the cell is looked up once per distance, but only if an object covers the column
+    bool cellKnown = false;
+    uint8_t cellValue = 0;
+
     for ( uint8_t n = 0; n < sizeof( objectList ) / sizeof( objectList[0] ); n++ )
     {
       memcpy_P( &object, &objectList[n], sizeof( object ) );
+      FRAME_STATS_ADD( flashBytesRead, sizeof( object ) );
       uint8_t objectWidth = object.bitmapWidth >> distance;
 
       // non wall objects will only be rendered if directly in front of the player (for now!)
       if ( ( x >= WINDOW_CENTER_X - objectWidth ) && ( x < WINDOW_CENTER_X + objectWidth ) )
       {
-      #ifdef _USE_FIELD_OF_VIEW_
-        if ( ( getCell( distance, 0 ) & OBJECT_MASK ) == object.itemType )
-      #else
-        if ( ( *( getCellRaw( _dungeon.playerX, _dungeon.playerY, distance, 0, _dungeon.dir ) ) & OBJECT_MASK ) == object.itemType )
-      #endif
+        if ( !cellKnown )
         {
-          objectWidth = WINDOW_CENTER_X - objectWidth;
-          uint8_t posX = x - objectWidth;
-          // free background
-          uint8_t mask = getDownScaledBitmapData( posX, y, distance, &object, true );
-          pixels &= mask;
-          // and overlay scaled bitmap
-          uint8_t scaledBitmap = getDownScaledBitmapData( posX, y, distance, &object, false );
-
-        #ifdef _ENABLE_SHADING_
-          // shading effect to pronounce the distance of an object
-          switch ( distance )
-          {
-            case 0:
-            case 1:
-              break;
-            case 2:
-              if ( x & 1 ) { scaledBitmap &= 0x55; }
-              else { scaledBitmap &= 0xaa; }
-              break;
-            default:
-              if ( x & 1 ) { scaledBitmap &= 055; }
-              else { scaledBitmap &= 0x00; }
-          }
+        #ifdef _USE_FIELD_OF_VIEW_
+          cellValue = getCell( distance, 0 ) & OBJECT_MASK;
+        #else
+          cellValue = *( getViewCell<orientation>( distance, 0 ) ) & OBJECT_MASK;
         #endif
+          cellKnown = true;
+        }
+
+        if ( cellValue == object.itemType )
+        {
+          uint8_t posX = x - ( WINDOW_CENTER_X - objectWidth );
 
-          if ( distance == 1 )
+          for ( uint8_t row = 0; row < rows; row++ )
           {
-            // invert monster?!
-            scaledBitmap ^= ( _dungeon.invertMonsterEffect & ~mask );
+            // free background
+            uint8_t mask = getDownScaledBitmapData( posX, y + row, distance, &object, true );
+            // and overlay scaled bitmap
+            uint8_t scaledBitmap = shadePixels( getDownScaledBitmapData( posX, y + row, distance, &object, false ), distance, x );
+
+            if ( distance == 1 )
+            {
+              // invert monster?!
+              scaledBitmap ^= ( _dungeon.invertMonsterEffect & ~mask );
+            }
+            pixels[row] = ( pixels[row] & mask ) | scaledBitmap;
           }
-          pixels |= scaledBitmap;
         }
       }
     }
   }
-  
+}
+
+/*--------------------------------------------------------*/
+template <uint8_t orientation>
+uint8_t Dungeon::getWallPixels( const int8_t x, const int8_t y )
+{
+  PROFILER_START( PROFILE_WALLS );
+
+  uint8_t pixels = 0;
+
+  SIMPLE_WALL_INFO wallInfo;
+  uint8_t offsetX;
+
+  // all objects are visible
+  int8_t maxObjectDistance = MAX_VIEW_DISTANCE;
+
+  if ( findWallEntry<orientation>( x, wallInfo, offsetX ) )
+  {
+    // split combined positions into start and end
+    int8_t startPosY = wallInfo.posStartEndY / 16;
+    int8_t endPosY = wallInfo.posStartEndY & 0x0f;
+
+    // is there wall information for this vertical position
+    if ( ( y >= startPosY ) && ( y <= endPosY ) )
+    {
+      // get wall pixels (shave off the empty rows)
+      pixels = shadePixels( pgm_read_byte( wallInfo.wallBitmap + ( y - startPosY ) * wallInfo.width + offsetX ), wallInfo.viewDistance, x );
+      FRAME_STATS_ADD( flashBytesRead, 1 );
+    }
+    // objects behind walls are not visible, but doors or switches might be placed *on* walls
+    maxObjectDistance = wallInfo.viewDistance;
+  }
+
+  PROFILER_STOP( PROFILE_WALLS );
+  PROFILER_START( PROFILE_OBJECTS );
+
+  drawObjects<orientation>( x, y, 1, &pixels, maxObjectDistance );
+
+  PROFILER_STOP( PROFILE_OBJECTS );
+
   return( pixels );
 }
 
+#ifndef _USE_VERTICAL_ADDRESSING_
+/*--------------------------------------------------------*/
+// Checks if the center columns of the dungeon view show nothing but
+// the plain wall directly in front of the player. In this case every
+// row of these columns is a consecutive part of the wall bitmap and
+// can be sent as a whole, without calling getWallPixels() for each byte.
+// Note: The cells at distance 0 don't overlap the front wall, so it
+// always wins the columns it covers.
+bool Dungeon::getFrontWallSpan( SIMPLE_WALL_INFO &wallInfo )
+{
+  // mirrored walls are read backwards and the xor effect changes every byte
+  if ( ( ( _dungeon.playerX + _dungeon.playerY ) & 0x01 ) || _dungeon.displayXorEffect ) { return( false ); }
+
+  const uint8_t cellValue = *( getCellRaw( _dungeon.playerX, _dungeon.playerY, 1, 0, _dungeon.dir ) );
+
+  // is there a wall at all?
+  if ( ( cellValue & WALL_MASK ) != ( WALL & ~FLAG_SOLID ) ) { return( false ); }
+
+  // doors or switches placed on the wall are drawn over it
+  NON_WALL_OBJECT object;
+  for ( uint8_t n = 0; n < sizeof( objectList ) / sizeof( objectList[0] ); n++ )
+  {
+    memcpy_P( &object, &objectList[n], sizeof( object ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( object ) );
+    if ( ( cellValue & OBJECT_MASK ) == object.itemType ) { return( false ); }
+  }
+
+  // find the entry of the front wall
+  const SIMPLE_WALL_INFO *wallInfoPtr = arrayOfWallInfo;
+  while ( true )
+  {
+    memcpy_P( &wallInfo, wallInfoPtr++, sizeof( wallInfo ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( wallInfo ) );
+
+    if ( wallInfo.wallBitmap == nullptr ) { return( false ); }
+
+    if ( ( wallInfo.viewDistance == 1 ) && ( wallInfo.leftRightOffset == 0 ) ) { break; }
+  }
+
+  // the bitmap has to cover all rows and exactly the columns of the entry
+  return( ( wallInfo.posStartEndY == 0x07 ) && ( wallInfo.relPos == 0 ) 
+       && ( wallInfo.width == wallInfo.endPosX - wallInfo.startPosX + 1 ) );
+}
+#endif
+
+#ifdef _USE_VERTICAL_ADDRESSING_
+/*--------------------------------------------------------*/
+// Calculates all 8 rows of column x at once.
+// The wall entry and the objects only depend on the column,
+// so they are resolved only once instead of once per row.
+template <uint8_t orientation>
+void Dungeon::getWallColumn( const int8_t x, uint8_t *columnPixels )
+{
+  PROFILER_START( PROFILE_WALLS );
+
+  memset( columnPixels, 0, 8 );
+
+  SIMPLE_WALL_INFO wallInfo;
+  uint8_t offsetX;
+
+  // all objects are visible
+  int8_t maxObjectDistance = MAX_VIEW_DISTANCE;
+
+  if ( findWallEntry<orientation>( x, wallInfo, offsetX ) )
+  {
+    // split combined positions into start and end
+    int8_t startPosY = wallInfo.posStartEndY / 16;
+    int8_t endPosY = wallInfo.posStartEndY & 0x0f;
+
+    // get wall pixels (the empty rows were shaved off)
+    const uint8_t *wallData = wallInfo.wallBitmap + offsetX;
+    for ( int8_t y = startPosY; y <= endPosY; y++ )
+    {
+      columnPixels[y] = shadePixels( pgm_read_byte( wallData ), wallInfo.viewDistance, x );
+      FRAME_STATS_ADD( flashBytesRead, 1 );
+      wallData += wallInfo.width;
+    }
+    // objects behind walls are not visible, but doors or switches might be placed *on* walls
+    maxObjectDistance = wallInfo.viewDistance;
+  }
+
+  PROFILER_STOP( PROFILE_WALLS );
+  PROFILER_START( PROFILE_OBJECTS );
+
+  drawObjects<orientation>( x, 0, 8, columnPixels, maxObjectDistance );
+
+  PROFILER_STOP( PROFILE_OBJECTS );
+}
+#endif
+
+#ifdef _USE_POTENTIALLY_VISIBLE_SET_
+/*--------------------------------------------------------*/
+// Looks up the potentially visible set of the current position
+// and direction. The sets are calculated on first use and
+// discarded whenever the level has been modified.
+// With _USE_PRECOMPUTED_PVS_ they come from the level data, they
+// were calculated for the level with all doors, bars... open.
+void Dungeon::updatePotentiallyVisibleSet()
+{
+#ifdef _USE_PRECOMPUTED_PVS_
+  _visibleCells = pgm_read_word( LEVEL_TABLE( potentiallyVisibleSet, levelPotentiallyVisibleSet ) + ( _dungeon.playerX + _dungeon.playerY * getLevelWidth() ) * MAX_ORIENTATION + _dungeon.dir );
+#else
+  if ( _potentiallyVisibleSetRevision != _levelRevision )
+  {
+    // the level has changed, so all sets have to be recalculated
+    memset( _potentiallyVisibleSet, 0, sizeof( _potentiallyVisibleSet ) );
+    _potentiallyVisibleSetRevision = _levelRevision;
+  }
+
+  uint16_t *visibleCells = _potentiallyVisibleSet + ( _dungeon.playerX + _dungeon.playerY * getLevelWidth() ) * MAX_ORIENTATION + _dungeon.dir;
+  if ( !*visibleCells )
+  {
+    *visibleCells = calculateVisibleCells();
+  }
+  _visibleCells = *visibleCells;
+#endif
+}
+
+/*--------------------------------------------------------*/
+// Returns a bit mask of all cells in the field of view (distance 1..3,
+// offset -2..+2) which might contribute pixels from the current position.
+// The wall list is processed just like in getWallPixels(), but for all
+// columns at once: A cell is visible if at least one of its columns isn't
+// covered by a closer wall yet.
+uint16_t Dungeon::calculateVisibleCells()
+{
+  uint16_t visibleCells = VISIBLE_CELLS_VALID;
+
+  // one bit per column, set if the column is already covered by a wall
+  uint8_t coveredColumns[WINDOW_SIZE_X / 8];
+  memset( coveredColumns, 0, sizeof( coveredColumns ) );
+
+  // get the width of the widest non wall object
+  NON_WALL_OBJECT object;
+  uint8_t maxObjectWidth = 0;
+  for ( uint8_t n = 0; n < sizeof( objectList ) / sizeof( objectList[0] ); n++ )
+  {
+    memcpy_P( &object, &objectList[n], sizeof( object ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( object ) );
+    if ( object.bitmapWidth > maxObjectWidth ) { maxObjectWidth = object.bitmapWidth; }
+  }
+
+  SIMPLE_WALL_INFO wallInfo;
+  const SIMPLE_WALL_INFO *wallInfoPtr = arrayOfWallInfo;
+  int8_t distance = 0;
+
+  while ( true )
+  {
+    memcpy_P( &wallInfo, wallInfoPtr++, sizeof( wallInfo ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( wallInfo ) );
+
+    // the entries are ordered by distance, so all closer walls are known now
+    while ( ( distance < wallInfo.viewDistance ) || ( ( wallInfo.wallBitmap == nullptr ) && ( distance < MAX_VIEW_DISTANCE ) ) )
+    {
+      distance++;
+      // are the objects in the center line of this distance visible?
+      uint8_t objectWidth = maxObjectWidth >> distance;
+      for ( uint8_t x = WINDOW_CENTER_X - objectWidth; x < WINDOW_CENTER_X + objectWidth; x++ )
+      {
+        if ( !( coveredColumns[x / 8] & ( 1 << ( x & 0x07 ) ) ) )
+        {
+          visibleCells |= getVisibleCellBit( distance, 0 );
+          break;
+        }
+      }
+    }
+
+    // end of list reached?
+    if ( wallInfo.wallBitmap == nullptr ) { break; }
+
+    bool isWall = ( ( *( getCellRaw( _dungeon.playerX, _dungeon.playerY, wallInfo.viewDistance, wallInfo.leftRightOffset, _dungeon.dir ) ) & WALL_MASK ) == ( WALL & ~FLAG_SOLID ) );
+
+    for ( uint8_t x = wallInfo.startPosX; x <= wallInfo.endPosX; x++ )
+    {
+      if ( !( coveredColumns[x / 8] & ( 1 << ( x & 0x07 ) ) ) )
+      {
+        // at least one column of this cell is visible
+        visibleCells |= getVisibleCellBit( wallInfo.viewDistance, wallInfo.leftRightOffset );
+        if ( !isWall ) { break; }
+        // the wall hides everything behind
+        coveredColumns[x / 8] |= ( 1 << ( x & 0x07 ) );
+      }
+    }
+  }
+
+  return( visibleCells );
+}
+#endif
+
 /*--------------------------------------------------------*/
 // Returns the downscaled bitmap data at position x,y.
 // Supported distance values are 1, 2, 3.
@@ -193,6 +433,8 @@ uint8_t Dungeon::getDownScaledBitmapData( int8_t x,                      // alre
   // is there anything to be done?
   uint8_t startOffsetY = pgm_read_byte( verticalStartOffset + distance );
   uint8_t endOffsetY = pgm_read_byte( verticalEndOffset + distance );
+  FRAME_STATS_ADD( objectsScaled, 1 );
+  FRAME_STATS_ADD( flashBytesRead, 3 );
 
   if ( ( y >= startOffsetY ) && ( y <= endOffsetY ) )
   {
@@ -203,6 +445,7 @@ uint8_t Dungeon::getDownScaledBitmapData( int8_t x,                      // alre
     
     // get associated bit mask
     uint8_t bitMask = pgm_read_byte( bitMaskFromScalingFactor + scaleFactor );
+    FRAME_STATS_ADD( flashBytesRead, 1 );
 
     // calculate the first and last bit to be processed
     uint8_t startBitNo = object->bitmapVerticalOffsetInBits;
@@ -230,6 +473,7 @@ uint8_t Dungeon::getDownScaledBitmapData( int8_t x,                      // alre
         {
           // to get the output value, we will sum all the bits up (using a lookup table saves time and flash space)
           bitSum += pgm_read_byte( nibbleBitCount + ( ( pgm_read_byte( data++ ) >> ( bitNo & 0x07 ) ) & bitMask ) );
+          FRAME_STATS_ADD( flashBytesRead, 2 );
         }
       }
       else if ( useMask )
@@ -256,3 +500,43 @@ uint8_t Dungeon::getDownScaledBitmapData( int8_t x,                      // alre
                                      
   return( pixels );  
 }
+
+/*--------------------------------------------------------*/
+// instantiate the generic render kernel
+#ifdef _USE_VERTICAL_ADDRESSING_
+  template void Dungeon::getWallColumn<ANY_ORIENTATION>( const int8_t x, uint8_t *columnPixels );
+#else
+  template uint8_t Dungeon::getWallPixels<ANY_ORIENTATION>( const int8_t x, const int8_t y );
+#endif
+
+#ifdef _USE_ORIENTATION_KERNELS_
+/*--------------------------------------------------------*/
+// Returns the render kernel for the player's current orientation
+Dungeon::RENDER_KERNEL Dungeon::getRenderKernel()
+{
+  switch ( _dungeon.dir )
+  {
+  #ifdef _USE_VERTICAL_ADDRESSING_
+    case NORTH:
+      return( &Dungeon::getWallColumn<NORTH> );
+    case EAST:
+      return( &Dungeon::getWallColumn<EAST> );
+    case SOUTH:
+      return( &Dungeon::getWallColumn<SOUTH> );
+    //case WEST:
+    default:
+      return( &Dungeon::getWallColumn<WEST> );
+  #else
+    case NORTH:
+      return( &Dungeon::getWallPixels<NORTH> );
+    case EAST:
+      return( &Dungeon::getWallPixels<EAST> );
+    case SOUTH:
+      return( &Dungeon::getWallPixels<SOUTH> );
+    //case WEST:
+    default:
+      return( &Dungeon::getWallPixels<WEST> );
+  #endif
+  }
+}
+#endif
@@ -6,15 +6,78 @@
 #include "LevelDefinitions.h"
 #include "dungeonTypes.h"
 #include "externBitmaps.h"
+#include "inputRecorder.h"
+#include "pixelSinks.h"
+#include "profiler.h"
 #include "soundFX.h"
+#include "stackMonitor.h"
 #include "tinyJoypadUtils.h"
 
+// seed of the random generator (any value but 0)
+#define DICE_SEED  0xace1
+
+// entropy for the random generator (the timer at the time of the call)
+#if defined( __AVR_ATtiny85__ )
+  #define DICE_ENTROPY()  TCNT0
+#else
+  #define DICE_ENTROPY()  uint8_t( micros() )
+#endif
+
 /*--------------------------------------------------------*/
 void Dungeon::clear()
 {
   // zero dungeon structure
   memset( &_dungeon, 0x00, sizeof( _dungeon ) );
+  // the level is gone (and will be reloaded by init())
+  levelModified();
+#ifdef _USE_VIEWPORT_CACHE_
+  // redraw the whole status pane
+  _forcedStatusRows = 0xff;
+#endif
+}
+
+/*--------------------------------------------------------*/
+void Dungeon::restoreSnapshot( const DUNGEON &snapshot )
+{
+  _dungeon = snapshot;
+  // the level might be different, and the status pane, too
+  levelModified();
+#ifdef _USE_VIEWPORT_CACHE_
+  _forcedStatusRows = 0xff;
+#endif
+}
+
+#ifdef _ENABLE_REWIND_
+/*--------------------------------------------------------*/
+uint16_t Dungeon::rewind( const uint16_t actions )
+{
+  uint16_t undone = 0;
+  while ( ( undone < actions ) && _rewindBuffer.stepBack() ) { undone++; }
+  if ( undone ) { restoreSnapshot( _rewindBuffer.getState() ); }
+  return( undone );
+}
+
+/*--------------------------------------------------------*/
+// the player has died: DOWN plays the last moments again, FIRE ends the game
+void Dungeon::rewindAfterDeath()
+{
+  // turn dungeon to black
+  clear();
+  renderImage();
+
+  for ( ;; )
+  {
+    const uint8_t inputs = getInputs();
+    if ( inputs & INPUT_FIRE ) { return; }
+    if ( ( inputs & INPUT_DOWN ) && rewind( REWIND_ACTIONS_AFTER_DEATH ) )
+    {
+      // don't walk back with the same press
+      while ( getInputs() & INPUT_DOWN );
+      return;
+    }
+  }
 }
+#endif
 
 /*--------------------------------------------------------*/
 // initialize all variables
@@ -24,19 +87,19 @@ void Dungeon::init()
   clear();
 
   // Prepare the dungeon
-  _dungeon.playerX = 1; //2; //7; // we could save 4 bytes here, if the whole level is shifted, so that the starting point is at (0,0)
-  _dungeon.playerY = 1; //12; //11;
-  _dungeon.dir  = EAST;
+  _dungeon.playerX = LEVEL_TABLE( startX, LEVEL_START_X ); // we could save 4 bytes here, if the whole level is shifted, so that the starting point is at (0,0)
+  _dungeon.playerY = LEVEL_TABLE( startY, LEVEL_START_Y );
+  _dungeon.dir  = LEVEL_TABLE( startDir, LEVEL_START_DIR );
   // prepare player stats
   _dungeon.playerHP = 10;
   _dungeon.playerDamage = 3;
   //_dungeon.displayXorEffect = 0;
 
   // copy the level data to RAM
-  memcpy_P( _dungeon.currentLevel, Level_1, getLevelWidth() * getLevelHeight() );
+  memcpy_P( _dungeon.currentLevel, LEVEL_TABLE( level, Level_1 ), getLevelWidth() * getLevelHeight() );
 
   // populate dungeon with monsters
-  memcpy_P( _dungeon.monsterStats, monsterStats, sizeof( monsterStats ) );
+  memcpy_P( _dungeon.monsterStats, LEVEL_TABLE( monsterStats, monsterStats ), sizeof( monsterStats ) );
 
   serialPrint( F("sizeof( MONSTER_STATS ) = ") );
   serialPrintln( sizeof( MONSTER_STATS ) );
@@ -66,6 +129,11 @@ void Dungeon::init()
 
   // initialize timer/counter
   initDice();
+
+#ifdef _ENABLE_REWIND_
+  // nothing to undo yet
+  _rewindBuffer.reset( _dungeon );
+#endif
 }
 
 /*--------------------------------------------------------*/
@@ -78,6 +146,24 @@ void Dungeon::initDice()
   TCCR0A = 0x00;        // normal mode
   TCCR0B = ( 1<<CS00 ); // prescaling with 1
 #endif
+
+#ifdef _USE_XORSHIFT_DICE_
+  _dungeon.dice = DICE_SEED;
+  #if defined(ARDUINO_ARCH_HOST)
+  if ( _hostIO )
+  {
+    _dungeon.dice = _hostIO->diceSeed;
+    return;
+  }
+  #endif
+  #if defined(_ENABLE_INPUT_RECORDER_)
+  // only the seed counts, it's part of the recording
+  _dungeon.dice = inputRecorderStart( DICE_SEED ^ DICE_ENTROPY() );
+  #elif !defined(_USE_DETERMINISTIC_DICE_)
+  // the timer and the input timing are mixed in by updateDice()
+  updateDice();
+  #endif
+#endif
 }
 
 /*--------------------------------------------------------*/
@@ -89,22 +175,25 @@ void Dungeon::initDice()
 // it ain't over, till it's over...  
   while( isPlayerAlive() )
   {
-    // sword found? -> adjust damage
-    if ( _dungeon.playerItems & ITEM_SWORD ) { _dungeon.playerDamage = 10; }
-
-    // shield found? adjust protection
-    if ( _dungeon.playerItems & ITEM_SHIELD ) { _dungeon.playerArmour = 3; }
-
-#ifdef _USE_FIELD_OF_VIEW_
-    // setup field of view according to direction
-    updateFieldOfView();
-#endif
+    // items and field of view
+    prepareFrame();
 
     // update the status pane and render the screen
     renderImage();
 
+  #if defined(_ENABLE_FRAME_STATS_) && defined(USE_SERIAL_PRINT)
+    lastFrameStats.serialPrint();
+  #endif
+
     // update player's position and orientation
     checkPlayerMovement();
+
+    // collect the profiler statistics of this round
+    PROFILER_END_FRAME();
+
+  #ifdef _ENABLE_REWIND_
+    if ( !isPlayerAlive() ) { rewindAfterDeath(); }
+  #endif
   }
 
   // player is dead... turn dungeon to black
@@ -114,23 +203,30 @@ void Dungeon::initDice()
   renderImage();
 
   // let the player feel the darkness...
-  while ( !isFirePressed() );
+  while ( !( getInputs() & INPUT_FIRE ) );
  }
 
 
 /*--------------------------------------------------------*/
-void Dungeon::checkPlayerMovement()
+// applies the items and sets up the next frame
+void Dungeon::prepareFrame()
 {
-  // get pointer to cell in front of player
-  uint8_t *cell = getCellRaw( _dungeon.playerX, _dungeon.playerY, +1, 0, _dungeon.dir );
+  // sword found? -> adjust damage
+  if ( _dungeon.playerItems & ITEM_SWORD ) { _dungeon.playerDamage = 10; }
 
-  // check if there is a monster in front of the player
-  // ...  
+  // shield found? adjust protection
+  if ( _dungeon.playerItems & ITEM_SHIELD ) { _dungeon.playerArmour = 3; }
 
-  // no movement yet
-  bool playerHasReachedNewCell = false;
-  bool playerAction = false;
+#ifdef _USE_FIELD_OF_VIEW_
+  // setup field of view according to direction
+  updateFieldOfView();
+#endif
+}
 
+/*--------------------------------------------------------*/
+// returns true if a flashing effect was visible (it's disabled by the next frame)
+bool Dungeon::endFlashEffect()
+{
   // remember to disable the flashing effect
   bool disableFlashEffect = _dungeon.displayXorEffect | _dungeon.invertMonsterEffect | _dungeon.invertStatusEffect;;
   _dungeon.displayXorEffect = 0;
@@ -138,219 +234,262 @@ void Dungeon::checkPlayerMovement()
   _dungeon.invertMonsterEffect = 0;
   _dungeon.invertStatusEffect = 0;
   */
+  return( disableFlashEffect );
+}
+
+/*--------------------------------------------------------*/
+void Dungeon::checkPlayerMovement()
+{
+  // no player action while a flashing effect is visible
+  if ( endFlashEffect() ) { return; }
 
   // stay in this loop until the player does anything
-  while ( !playerAction && !disableFlashEffect )
+  do
   {
-    playerAction = _dungeon.displayXorEffect;
-
     // prepare the dice
     updateDice();
+  }
+  // all inputs at once (they might be recorded or replayed)
+  while ( !playerInput( getInputs() ) );
+}
 
-    if ( isLeftPressed() ) 
+/*--------------------------------------------------------*/
+// handles the inputs of one poll, returns true if the player did anything
+bool Dungeon::playerInput( const uint8_t inputs )
+{
+  // get pointer to cell in front of player
+  uint8_t *cell = getCellRaw( _dungeon.playerX, _dungeon.playerY, +1, 0, _dungeon.dir );
+
+  // check if there is a monster in front of the player
+  // ...  
+
+  // no movement yet
+  bool playerHasReachedNewCell = false;
+  bool playerAction = false;
+
+  if ( inputs & INPUT_LEFT )
+  {
+    // turn left
+    _dungeon.dir = ( _dungeon.dir - 1 ) & 0x03;
+    stepSound();
+    playerAction = true;
+  }
+  
+  if ( inputs & INPUT_RIGHT )
+  {
+    // turn right
+    _dungeon.dir = ( _dungeon.dir + 1 ) & 0x03;
+    stepSound();
+    playerAction = true;
+  }
+
+  if ( inputs & INPUT_UP )
+  {
+    if ( ( ( *cell ) & FLAG_SOLID ) != FLAG_SOLID )
     {
-      // turn left
-      _dungeon.dir = ( _dungeon.dir - 1 ) & 0x03;
       stepSound();
-      playerAction = true;
+      stepSound();
+      
+      switch( _dungeon.dir )
+      {
+        case NORTH:
+          _dungeon.playerY--; break;
+        case EAST:
+          _dungeon.playerX++; break;
+        case SOUTH:
+          _dungeon.playerY++; break;
+        case WEST:
+        default:  // this saves 4 bytes
+          _dungeon.playerX--; break;
+      }
+
+      // just a small step for a player
+      playerHasReachedNewCell = true;
     }
-    
-    if ( isRightPressed() )
+    else
     {
-      // turn right
-      _dungeon.dir = ( _dungeon.dir + 1 ) & 0x03;
-      stepSound();
-      playerAction = true;
+      wallSound();
     }
-
-    if ( isUpPressed() )
+  }
+  
+  if ( inputs & INPUT_DOWN )
+  {
+    if ( ( *( getCellRaw( _dungeon.playerX, _dungeon.playerY, -1, 0, _dungeon.dir ) ) & FLAG_SOLID ) != FLAG_SOLID )
     {
-      if ( ( ( *cell ) & FLAG_SOLID ) != FLAG_SOLID )
-      {
-        stepSound();
-        stepSound();
-        
-        switch( _dungeon.dir )
-        {
-          case NORTH:
-            _dungeon.playerY--; break;
-          case EAST:
-            _dungeon.playerX++; break;
-          case SOUTH:
-            _dungeon.playerY++; break;
-          case WEST:
-          default:  // this saves 4 bytes
-            _dungeon.playerX--; break;
-        }
-
-        // just a small step for a player
-        playerHasReachedNewCell = true;
-      }
-      else
+      stepSound();
+      stepSound();
+  
+      switch( _dungeon.dir )
       {
-        wallSound();
+        case NORTH:
+          _dungeon.playerY++; break;
+        case EAST:
+          _dungeon.playerX--; break;
+        case SOUTH:
+          _dungeon.playerY--; break;
+        case WEST:
+        default:
+          _dungeon.playerX++; break;
       }
-    }
     
-    if ( isDownPressed() )
+      // just a small step for a player
+      playerHasReachedNewCell = true;
+    }
+    else
     {
-      if ( ( *( getCellRaw( _dungeon.playerX, _dungeon.playerY, -1, 0, _dungeon.dir ) ) & FLAG_SOLID ) != FLAG_SOLID )
-      {
-        stepSound();
-        stepSound();
-    
-        switch( _dungeon.dir )
-        {
-          case NORTH:
-            _dungeon.playerY++; break;
-          case EAST:
-            _dungeon.playerX--; break;
-          case SOUTH:
-            _dungeon.playerY--; break;
-          case WEST:
-          default:
-            _dungeon.playerX++; break;
-        }
-      
-        // just a small step for a player
-        playerHasReachedNewCell = true;
-      }
-      else
-      {
-        wallSound();
-      }
+      wallSound();
     }
+  }
+
+  // always limit the positions
+  limitDungeonPosition( _dungeon.playerX, _dungeon.playerY );
+
+  // check for special cell effects like teleporter or spinner
+  if ( playerHasReachedNewCell )
+  {
+    PROFILER_START( PROFILE_MOVEMENT );
 
-    // always limit the positions
-    limitDungeonPosition( _dungeon.playerX, _dungeon.playerY );
+    // obviously that's a player action, too
+    playerAction = true;
+    // log player coordinates
+    serialPrint( F("player position = (") ); serialPrint( _dungeon.playerX ); serialPrint( F(", ") ); serialPrint( _dungeon.playerY ); serialPrintln( F(")") );
 
-    // check for special cell effects like teleporter or spinner
-    if ( playerHasReachedNewCell )
+    SPECIAL_CELL_INFO specialCellInfo;
+    
+    const SPECIAL_CELL_INFO *specialCells = LEVEL_TABLE( specialCellFX, specialCellFX );
+    for ( int n = 0; n < int( LEVEL_TABLE( specialCells, sizeof( specialCellFX ) / sizeof( specialCellFX[0] ) ) ); n++ )
     {
-      // obviously that's a player action, too
-      playerAction = true;
-      // log player coordinates
-      serialPrint( F("player position = (") ); serialPrint( _dungeon.playerX ); serialPrint( F(", ") ); serialPrint( _dungeon.playerY ); serialPrintln( F(")") );
+      // copy cell info object from flash to RAM
+      memcpy_P( &specialCellInfo, &specialCells[n], sizeof( specialCellInfo ) );
 
-      SPECIAL_CELL_INFO specialCellInfo;
-      
-      for ( int n = 0; n < int( sizeof( specialCellFX ) / sizeof( specialCellFX[0] ) ); n++ )
+      // does this entry refer to the current position?
+      if ( specialCellInfo.position == _dungeon.playerX + _dungeon.playerY * getLevelWidth() )
       {
-        // copy cell info object from flash to RAM
-        memcpy_P( &specialCellInfo, &specialCellFX[n], sizeof( specialCellInfo ) );
+      #if !defined(__AVR_ATtiny85__)
+        // print the special effect...
+        specialCellInfo.serialPrint();
+      #endif
 
-        // does this entry refer to the current position?
-        if ( specialCellInfo.position == _dungeon.playerX + _dungeon.playerY * getLevelWidth() )
+        // teleporter?
+        if ( specialCellInfo.specialFX == TELEPORTER )
         {
-        #if !defined(__AVR_ATtiny85__)
-          // print the special effect...
-          specialCellInfo.serialPrint();
-        #endif
-
-          // teleporter?
-          if ( specialCellInfo.specialFX == TELEPORTER )
-          {
-            _dungeon.playerX = specialCellInfo.value_1;
-            _dungeon.playerY = specialCellInfo.value_2;
-          }
-          else // it's a spinner
-          {
-            // modify player's orientation
-            _dungeon.dir += specialCellInfo.value_1;
-            _dungeon.dir &= 0x03;
-          }
-          // *** BAZINGA! ***
-          if ( _dungeon.playerItems & ITEM_RING )
-          {
-            _dungeon.displayXorEffect = 0xff; /* visualize by flashing if player has the <Ring of Orientation>*/
-          }
+          _dungeon.playerX = specialCellInfo.value_1;
+          _dungeon.playerY = specialCellInfo.value_2;
+        }
+        else // it's a spinner
+        {
+          // modify player's orientation
+          _dungeon.dir += specialCellInfo.value_1;
+          _dungeon.dir &= 0x03;
+        }
+        // *** BAZINGA! ***
+        if ( _dungeon.playerItems & ITEM_RING )
+        {
+          _dungeon.displayXorEffect = 0xff; /* visualize by flashing if player has the <Ring of Orientation>*/
         }
       }
     }
-    else
+
+    PROFILER_STOP( PROFILE_MOVEMENT );
+  }
+  else
+  {
+    // ... and ACTION!
+    if ( inputs & INPUT_FIRE )
     {
-      // ... and ACTION!
-      if ( isFirePressed() )
-      {
-        playerAction = true;
+      playerAction = true;
 
-        uint8_t cellValue = *cell;
+      uint8_t cellValue = *cell;
 
-        #ifdef USE_SERIAL_PRINT
-          _dungeon.serialPrint();
-          Serial.print(F("*cell = "));printHexToSerial( cellValue );Serial.println();
-        #endif
+      #ifdef USE_SERIAL_PRINT
+        _dungeon.serialPrint();
+        Serial.print(F("*cell = "));printHexToSerial( cellValue );Serial.println();
+      #endif
 
-        if ( cellValue & FLAG_MONSTER )
-        {
-          /////////////////////////////////////////////
-          // find the monster... 
-          // (cell - _dungeon.currentLevel) is the offset from the level begin ;)
-          MONSTER_STATS *monster = findMonster( cell - _dungeon.currentLevel );
+      if ( cellValue & FLAG_MONSTER )
+      {
+        PROFILER_START( PROFILE_COMBAT );
 
+        /////////////////////////////////////////////
+        // find the monster... 
+        // (cell - _dungeon.currentLevel) is the offset from the level begin ;)
+        MONSTER_STATS *monster = findMonster( cell - _dungeon.currentLevel );
 
-          /////////////////////////////////////////////
-          // does the monster attack first?
-          if ( monster->attacksFirst )
-          {
-            // now let the monster attack the player
-            monsterAttack( monster );
-          }          
-
-          /////////////////////////////////////////////
-          // player attacks monster (if he/she is still alive)
-          if ( _dungeon.playerHP > 0 )
-          {
-            playerAttack( monster );
 
-            // wait for fire button to be released (random number generation!)
-            while ( isFirePressed() )
-            {
-              updateDice();
-            }
+        /////////////////////////////////////////////
+        // does the monster attack first?
+        if ( monster->attacksFirst )
+        {
+          // now let the monster attack the player
+          monsterAttack( monster );
+        }          
 
-            // update the status pane and render the screen (monster will be inverted)
-            renderImage();
-            // redraw with normal monster (so that the monster appears to have flashed)
-            renderImage();
-          }
+        /////////////////////////////////////////////
+        // player attacks monster (if he/she is still alive)
+        if ( _dungeon.playerHP > 0 )
+        {
+          playerAttack( monster );
 
-          /////////////////////////////////////////////
-          // is the monster still alive?
-          if ( monster->hitpoints > 0 )
+          // wait for fire button to be released (random number generation!)
+          while ( getInputs() & INPUT_FIRE )
           {
-            if ( !monster->attacksFirst )
-            {
-              // just wait a moment (for the display effect to be visible)
-              _variableDelay_us( 250 );
-              
-              // now let the monster attack the player
-              monsterAttack( monster );
-            }
+            updateDice();
           }
-          else
+
+          // update the status pane and render the screen (monster will be inverted)
+          renderImage();
+          // redraw with normal monster (so that the monster appears to have flashed)
+          renderImage();
+        }
+
+        /////////////////////////////////////////////
+        // is the monster still alive?
+        if ( monster->hitpoints > 0 )
+        {
+          if ( !monster->attacksFirst )
           {
-            // the monster has been defeated!
-            serialPrintln(F("Monster defeated!"));
-            // remove the monster from the dungeon
-            *cell = EMPTY;
-            // collect the treasure!
-            _dungeon.playerItems |= monster->treasureItemMask;
+            // just wait a moment (for the display effect to be visible)
+            _variableDelay_us( 250 );
+            
+            // now let the monster attack the player
+            monsterAttack( monster );
           }
-
-        #ifdef USE_SERIAL_PRINT
-          _dungeon.serialPrint();
-          Serial.print(F("*cell = ")); printHexToSerial( cellValue ); Serial.println();
-        #endif
         }
         else
         {
-          // let's see if there is some scripted interaction...
-          playerInteraction( cell, cellValue );
+          // the monster has been defeated!
+          serialPrintln(F("Monster defeated!"));
+          // remove the monster from the dungeon
+          *cell = EMPTY;
+          levelModified();
+          // collect the treasure!
+          _dungeon.playerItems |= monster->treasureItemMask;
         }
+
+      #ifdef USE_SERIAL_PRINT
+        _dungeon.serialPrint();
+        Serial.print(F("*cell = ")); printHexToSerial( cellValue ); Serial.println();
+      #endif
+
+        PROFILER_STOP( PROFILE_COMBAT );
+        STACK_CHECK( STACK_CHECKPOINT_COMBAT );
+      }
+      else
+      {
+        PROFILER_START( PROFILE_MOVEMENT );
+        // let's see if there is some scripted interaction...
+        playerInteraction( cell, cellValue );
+        PROFILER_STOP( PROFILE_MOVEMENT );
+        STACK_CHECK( STACK_CHECKPOINT_INTERACTION );
       }
     }
   }
+
+#ifdef _ENABLE_REWIND_
+  if ( playerAction ) { _rewindBuffer.record( _dungeon ); }
+#endif
+
+  return( playerAction );
 }
 
 
@@ -422,6 +561,8 @@ uint8_t *Dungeon::getCellRaw( int8_t x, int8_t y, const int8_t distance, const i
 
   limitDungeonPosition( x, y );
 
+  FRAME_STATS_ADD( cellLookups, 1 );
+
   return( _dungeon.currentLevel + y * getLevelWidth() + x );
 }
 
@@ -457,6 +598,7 @@ void Dungeon::openChest( INTERACTION_INFO &info )
       if ( *currentCell == FAKE_WALL ) { *currentCell = EMPTY; }
       currentCell++;
     }
+    levelModified();
   }
   
 #if !defined(__AVR_ATtiny85__)
@@ -505,22 +647,63 @@ void Dungeon::openChest( INTERACTION_INFO &info )
 
 
 /*--------------------------------------------------------*/
+// Called while waiting for the player, so the time between the
+// calls (the input timing) ends up in the random generator.
 void Dungeon::updateDice()
 { 
-#if !defined( __AVR_ATtiny85__ )
-  _dungeon.dice++; 
+#if defined(_USE_XORSHIFT_DICE_) && !defined(_USE_DETERMINISTIC_DICE_) && !defined(_ENABLE_INPUT_RECORDER_)
+  #if defined(ARDUINO_ARCH_HOST)
+  // instances only depend on their seed
+  if ( _hostIO ) { return; }
+  #endif
+  _dungeon.dice ^= DICE_ENTROPY();
+  // xorshift doesn't recover from 0
+  if ( !_dungeon.dice ) { _dungeon.dice = DICE_SEED; }
+  nextRandom();
 #endif
 }
 
 
+#ifdef _USE_XORSHIFT_DICE_
+/*--------------------------------------------------------*/
+// xorshift16 (shift triple 7, 9, 8), period 65535
+uint16_t Dungeon::nextRandom()
+{
+  uint16_t value = _dungeon.dice;
+  value ^= value << 7;
+  value ^= value >> 9;
+  value ^= value << 8;
+  _dungeon.dice = value;
+  return( value );
+}
+
+
 /*--------------------------------------------------------*/
-uint8_t Dungeon::getDice( uint8_t maxValue )
+// Returns 1..maxValue (maxValue > 0), all values are equally likely.
+// The high byte of random * maxValue is the result, the few low bytes
+// which would make it biased are drawn again (only 256 % maxValue of
+// 256 cases, and the modulo is only calculated if there's a chance).
+uint8_t Dungeon::getDice( const uint8_t maxValue )
 {
-#if !defined( __AVR_ATtiny85__ )
-  uint8_t value =_dungeon.dice; 
+  uint16_t product = uint8_t( nextRandom() >> 8 ) * maxValue;
+
+  if ( uint8_t( product ) < maxValue )
+  {
+    const uint8_t threshold = uint8_t( -maxValue ) % maxValue;
+    while ( uint8_t( product ) < threshold )
+    {
+      product = uint8_t( nextRandom() >> 8 ) * maxValue;
+    }
+  }
+  return( ( product >> 8 ) + 1 );
+}
+
 #else
+/*--------------------------------------------------------*/
+// Returns 0..maxValue, the free running timer 0 is the random value
+uint8_t Dungeon::getDice( const uint8_t maxValue )
+{
   uint8_t value = TCNT0;
-#endif
   // limit value
   while ( value > maxValue )
   {
@@ -528,6 +711,7 @@ uint8_t Dungeon::getDice( uint8_t maxValue )
   }  
   return( value );
 }
+#endif
 
 
 /*--------------------------------------------------------*/
@@ -631,6 +815,9 @@ void Dungeon::monsterAttack( MONSTER_STATS *monster )
     // update the status pane and render the screen
     renderImage();
 
+  // the deepest call path: checkPlayerMovement() -> playerInput() -> monsterAttack() -> renderImage()
+  STACK_CHECK( STACK_CHECKPOINT_MONSTER_ATTACK );
+
   // just some logging
   serialPrintln(F("<- monsterAttack()"));
 }
@@ -639,10 +826,11 @@ void Dungeon::monsterAttack( MONSTER_STATS *monster )
 void Dungeon::playerInteraction( uint8_t *cell, const uint8_t cellValue )
 {
   INTERACTION_INFO interactionInfo;
-  for ( uint8_t n = 0; n < sizeof( interactionData ) / sizeof( INTERACTION_INFO ); n++ )
+  const INTERACTION_INFO *interactions = LEVEL_TABLE( interactionData, interactionData );
+  for ( uint8_t n = 0; n < LEVEL_TABLE( interactions, sizeof( interactionData ) / sizeof( INTERACTION_INFO ) ); n++ )
   {
     // get data from progmem
-    memcpy_P( &interactionInfo, interactionData + n, sizeof( INTERACTION_INFO ) );
+    memcpy_P( &interactionInfo, interactions + n, sizeof( INTERACTION_INFO ) );
 
     // does this info cover the current position?
     if ( cell == _dungeon.currentLevel + interactionInfo.currentPosition )
@@ -712,6 +900,9 @@ void Dungeon::playerInteraction( uint8_t *cell, const uint8_t cellValue )
           _dungeon.currentLevel[interactionInfo.modifiedPosition] = interactionInfo.modifiedPositionCellValue;
         }
 
+        // the level has (probably) been changed
+        levelModified();
+
         swordSound();
         
         // perform only the first action, otherwise on/off actions might be immediately revoked ;)
@@ -722,124 +913,455 @@ void Dungeon::playerInteraction( uint8_t *cell, const uint8_t cellValue )
 }
 
 /*--------------------------------------------------------*/
+// renders the screen to the display
 void Dungeon::renderImage()
 {
-  uint8_t statusPanelOffset = 0; 
+#if defined(ARDUINO_ARCH_HOST)
+  if ( _hostIO )
+  {
+    _hostIO->renderFrame( *this );
+    return;
+  }
+#endif
+  DISPLAY_SINK sink;
+  renderImage( sink );
+  INPUT_RECORDER_FRAME();
+}
+
+/*--------------------------------------------------------*/
+// renders the screen to any pixel sink (see "pixelSinks.h")
+template <class PIXEL_SINK>
+void Dungeon::renderImage( PIXEL_SINK &sink )
+{
+  PROFILER_START( PROFILE_RENDER );
+  FRAME_STATS_BEGIN();
+
+  // is there anything new to see in the dungeon? (only the display keeps the last image)
+  const bool renderViewport = !PIXEL_SINK::isDisplay || updateViewportCache();
+
+  // get the cells which might be visible from here
+  updatePotentiallyVisibleSet();
+
+#ifdef _USE_ORIENTATION_KERNELS_
+  // the orientation is resolved only once per frame
+  const RENDER_KERNEL renderKernel = getRenderKernel();
+#endif
+
+  // which rows of the status pane have changed?
+  uint8_t statusRows = PIXEL_SINK::isDisplay ? updateStatusCache() : 0xff;
+
+#ifdef _USE_VERTICAL_ADDRESSING_
+  if ( renderViewport || statusRows )
+  {
+    // the screen is sent column by column (except for an unchanged dungeon view or status pane)
+    sink.prepareColumns( renderViewport ? 0 : WINDOW_SIZE_X, statusRows ? 127 : WINDOW_SIZE_X - 1 );
+    FRAME_STATS_ADD( displayBytes, 8 * ( ( renderViewport ? WINDOW_SIZE_X : 0 ) + ( statusRows ? 32 : 0 ) ) );
+
+    uint8_t columnPixels[8];
+
+    // the first 96 columns are used to display the dungeon
+    for ( uint8_t x = 0; renderViewport && ( x < 96 ); x++ )
+    {
+      // calculate all 8 rows of the column at once
+    #ifdef _USE_ORIENTATION_KERNELS_
+      ( this->*renderKernel )( x, columnPixels );
+    #else
+      getWallColumn( x, columnPixels );
+    #endif
+
+      for ( uint8_t y = 0; y < 8; y++ )
+      {
+        // send 8 vertical pixels to the display
+        sink.send( columnPixels[y] ^ _dungeon.displayXorEffect );
+      }
+    } // for x
+
+    // display the dashboard here
+    if ( statusRows )
+    {
+      PROFILER_START( PROFILE_STATUS );
+
+      STATUS_ROW statusRow[8];
+      for ( uint8_t y = 0; y < 8; y++ )
+      {
+        getStatusRow( y, statusRow[y] );
+      }
+
+      for ( uint8_t x = 0; x < 32; x++ )
+      {
+        for ( uint8_t y = 0; y < 8; y++ )
+        {
+          // send 8 vertical pixels to the display
+          sink.send( getStatusPixels( statusRow[y], x, y ) );
+        }
+      } // for x
+
+      PROFILER_STOP( PROFILE_STATUS );
+    }
+
+    // all columns have been finished
+    sink.finishColumns();
+  }
+
+#else
+  // a plain wall in front of the player is sent in spans
+  SIMPLE_WALL_INFO frontWall;
+  const bool sendFrontWallSpan = renderViewport && getFrontWallSpan( frontWall );
+#ifndef _USE_STATUS_WIDGETS_
+  uint8_t statusPanelOffset = 0;
+#endif
 
   for ( uint8_t y = 0; y < 8; y++ )
   {
-    // prepare display of row <y>
-    PrepareDisplayRow( y );
+    // has the status pane row changed?
+    const bool renderStatusRow = statusRows & 0x01;
+    statusRows >>= 1;
+
+    // nothing to do for this row?
+    if ( !renderViewport && !renderStatusRow ) { continue; }
+
+    // prepare display of row <y> (the dungeon view is skipped if it hasn't changed)
+    sink.prepareRow( y, renderViewport ? 0 : WINDOW_SIZE_X );
+    FRAME_STATS_ADD( displayBytes, ( renderViewport ? WINDOW_SIZE_X : 0 ) + ( renderStatusRow ? 32 : 0 ) );
     
     uint8_t pixels;
 
     // the first 96 columns are used to display the dungeon
-    for ( uint8_t x = 0; x < 96; x++ )
+    for ( uint8_t x = 0; renderViewport && ( x < 96 ); x++ )
     {
+      if ( sendFrontWallSpan && ( x == frontWall.startPosX ) )
+      {
+        // send the whole row of the wall bitmap at once
+        sink.sendRun_P( frontWall.wallBitmap + y * frontWall.width, frontWall.width );
+        FRAME_STATS_ADD( flashBytesRead, frontWall.width );
+        x = frontWall.endPosX;
+        continue;
+      }
+
+    #ifdef _USE_ORIENTATION_KERNELS_
+      pixels = ( this->*renderKernel )( x, y );
+    #else
       pixels = getWallPixels( x, y );
+    #endif
       pixels ^= _dungeon.displayXorEffect;
 
       // send 8 vertical pixels to the display
-      SendPixels( pixels );
+      sink.send( pixels );
     } // for x
 
     // display the dashboard here
-    for ( uint8_t x = 0; x < 32; x++ )
+    if ( renderStatusRow )
     {
-      pixels = 0;
-      if ( y | ( _dungeon.playerItems & ITEM_COMPASS ) )
+      PROFILER_START( PROFILE_STATUS );
+
+    #ifdef _USE_STATUS_WIDGETS_
+      STATUS_ROW statusRow;
+      getStatusRow( y, statusRow );
+
+      if ( ( statusRow.visibleColumns == 0xFFFFFFFFUL ) && !statusRow.invertedColumns && ( statusRow.overlayStartX == 0xff ) )
       {
-        pixels = pgm_read_byte( statusPanel + statusPanelOffset );
-        // compass present?
-        if ( !y )
+        // nothing changes the panel bitmap, so the row is sent as is
+        sink.sendRun_P( statusPanel + y * 32, 32 );
+        FRAME_STATS_ADD( flashBytesRead, 32 );
+      }
+      else
+      {
+        for ( uint8_t x = 0; x < 32; x++ )
         {
-          if ( ( x >= 14 ) && ( x < 19 ) )
-          { 
-            pixels |= pgm_read_byte( compass + x - 14 + 5 * _dungeon.dir );
-          }
+          // send 8 vertical pixels to the display
+          sink.send( getStatusPixels( statusRow, x, y ) );
         }
       }
-
-      // special status rows
-      if ( ( x >= 1 ) && ( x <= 30 ) )
+    #else
+      for ( uint8_t x = 0; x < 32; x++ )
       {
-        // hitpoints
-        if ( y == 4 )
+        pixels = 0;
+        if ( y | ( _dungeon.playerItems & ITEM_COMPASS ) )
         {
-          // display HP as a 4x scaled bar, so max visible HP is 112 ;)
-            if ( ( x - 2 ) > ( _dungeon.playerHP / 4 ) ) { pixels = 0; }
-            // invert the row if the player was hurt
-            pixels ^= _dungeon.invertStatusEffect;
+          pixels = pgm_read_byte( statusPanel + statusPanelOffset );
+          FRAME_STATS_ADD( flashBytesRead, 1 );
+          // compass present?
+          if ( !y )
+          {
+            if ( ( x >= 14 ) && ( x < 19 ) )
+            { 
+              pixels |= pgm_read_byte( compass + x - 14 + 5 * _dungeon.dir );
+              FRAME_STATS_ADD( flashBytesRead, 1 );
+            }
+          }
         }
-        // items: display the appropriate icons
-        if ( y == 5 )
+
+        // special status rows
+        if ( ( x >= 1 ) && ( x <= 30 ) )
         {
-          if ( x >= 2 )
+          // hitpoints
+          if ( y == 4 )
           {
-            if ( x <= 7 )
-            {
-              if ( !( _dungeon.playerItems & ITEM_SWORD ) ) { pixels = 0; }
-            }
-            else if ( x <= 13 )
-            {
-              if ( !( _dungeon.playerItems & ITEM_SHIELD ) ) { pixels = 0; }
-            }
-            else if ( x <= 19 )
-            {
-              if ( !( _dungeon.playerItems & ITEM_AMULET ) ) { pixels = 0; }
-            }
-            else if ( x <= 25 )
-            {
-              if ( !( _dungeon.playerItems & ITEM_RING ) ) { pixels = 0; }
-            }
-            else if ( x <= 30 )
+            // display HP as a 4x scaled bar, so max visible HP is 112 ;)
+              if ( ( x - 2 ) > ( _dungeon.playerHP / 4 ) ) { pixels = 0; }
+              // invert the row if the player was hurt
+              pixels ^= _dungeon.invertStatusEffect;
+          }
+          // items: display the appropriate icons
+          if ( y == 5 )
+          {
+            if ( x >= 2 )
             {
-              if ( !( _dungeon.playerItems & ITEM_KEY ) ) { pixels = 0; }
+              if ( x <= 7 )
+              {
+                if ( !( _dungeon.playerItems & ITEM_SWORD ) ) { pixels = 0; }
+              }
+              else if ( x <= 13 )
+              {
+                if ( !( _dungeon.playerItems & ITEM_SHIELD ) ) { pixels = 0; }
+              }
+              else if ( x <= 19 )
+              {
+                if ( !( _dungeon.playerItems & ITEM_AMULET ) ) { pixels = 0; }
+              }
+              else if ( x <= 25 )
+              {
+                if ( !( _dungeon.playerItems & ITEM_RING ) ) { pixels = 0; }
+              }
+              else if ( x <= 30 )
+              {
+                if ( !( _dungeon.playerItems & ITEM_KEY ) ) { pixels = 0; }
+              }
             }
           }
+          // did the player win?
+          if ( y == 6 )
+          {
+            if ( !(_dungeon.playerItems & ITEM_VICTORY ) ) { pixels = 0; }
+          }
         }
-        // did the player win?
-        if ( y == 6 )
-        {
-          if ( !(_dungeon.playerItems & ITEM_VICTORY ) ) { pixels = 0; }
-        }
-      }
 
-      // is the player dead?
-      if ( !isPlayerAlive() )
-      {
-        if ( y >= 3 )
+        // is the player dead?
+        if ( !isPlayerAlive() )
         {
-          constexpr uint8_t joeyBitmapWidth = 28;
-          constexpr uint8_t joeyMaskWidth = 28;
-          // the y position needs correction, because we are already in row 3
-          const uint8_t *offsetXY = joey - 3 * ( joeyBitmapWidth + joeyMaskWidth ) + y * ( joeyBitmapWidth + joeyMaskWidth ) + joeyBitmapWidth + 2  - x;
-          if ( ( x >= 2 ) && ( x < 30 ) )
+          if ( y >= 3 )
           {
-            // use mask
-            pixels &= pgm_read_byte( offsetXY + joeyMaskWidth );
-            // or pixels in
-            pixels |= pgm_read_byte( offsetXY );
+            constexpr uint8_t joeyBitmapWidth = 28;
+            constexpr uint8_t joeyMaskWidth = 28;
+            // the y position needs correction, because we are already in row 3
+            const uint8_t *offsetXY = joey - 3 * ( joeyBitmapWidth + joeyMaskWidth ) + y * ( joeyBitmapWidth + joeyMaskWidth ) + joeyBitmapWidth + 2  - x;
+            if ( ( x >= 2 ) && ( x < 30 ) )
+            {
+              // use mask
+              pixels &= pgm_read_byte( offsetXY + joeyMaskWidth );
+              // or pixels in
+              pixels |= pgm_read_byte( offsetXY );
+              FRAME_STATS_ADD( flashBytesRead, 2 );
+            }
           }
         }
-      }
 
-      // send 8 vertical pixels to the display
-      SendPixels( pixels );
+        // send 8 vertical pixels to the display
+        sink.send( pixels );
 
-      statusPanelOffset++;
+        statusPanelOffset++;
+      }
+    #endif
+
+      PROFILER_STOP( PROFILE_STATUS );
     }
     
     // this row has been finished
-    FinishDisplayRow();
+    sink.finishRow();
   } // for y
+#endif
 
   // display the whole screen
-  DisplayBuffer();
+  sink.finishFrame();
 
   // disable fight effects
   _dungeon.invertMonsterEffect = 0;
   _dungeon.invertStatusEffect = 0;
 
-  return;  
+  FRAME_STATS_END();
+  PROFILER_STOP( PROFILE_RENDER );
+
+  STACK_CHECK( STACK_CHECKPOINT_RENDER );
 }
+
+#if !defined(__AVR_ATtiny85__)
+// pixel sinks for benchmarks and regression checks
+template void Dungeon::renderImage<FRAMEBUFFER_SINK>( FRAMEBUFFER_SINK &sink );
+template void Dungeon::renderImage<HASH_SINK>( HASH_SINK &sink );
+template void Dungeon::renderImage<NULL_SINK>( NULL_SINK &sink );
+#endif
+
+#ifdef _USE_STATUS_WIDGETS_
+/*--------------------------------------------------------*/
+// Composes row y of the status pane from the widgets:
+// The status panel bitmap is only visible where the widgets are "switched on".
+void Dungeon::getStatusRow( const uint8_t y, STATUS_ROW &statusRow )
+{
+  statusRow.visibleColumns = 0xFFFFFFFFUL;
+  statusRow.invertedColumns = 0;
+  // no overlay
+  statusRow.overlayStartX = 0xff;
+  statusRow.overlayEndX = 0;
+
+  // hide the widgets of all missing items
+  STATUS_WIDGET widget;
+  for ( uint8_t n = 0; n < sizeof( statusWidgets ) / sizeof( statusWidgets[0] ); n++ )
+  {
+    memcpy_P( &widget, &statusWidgets[n], sizeof( widget ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( widget ) );
+    if ( ( widget.row == y ) && !( _dungeon.playerItems & widget.itemMask ) )
+    {
+      statusRow.visibleColumns &= ~widget.columnMask;
+    }
+  }
+
+  switch ( y )
+  {
+    case 0:
+      // the compass needle
+      if ( _dungeon.playerItems & ITEM_COMPASS )
+      {
+        statusRow.overlayStartX = 14;
+        statusRow.overlayEndX = 18;
+      }
+      break;
+    case 4:
+    {
+      // display HP as a 4x scaled bar, so max visible HP is 112 ;)
+      int8_t hitpointsBarEnd = _dungeon.playerHP / 4 + 2;
+      if ( hitpointsBarEnd < 30 )
+      {
+        statusRow.visibleColumns &= ~getStatusColumnMask( ( hitpointsBarEnd < 1 ) ? 1 : hitpointsBarEnd + 1, 30 );
+      }
+      // invert the row if the player was hurt
+      if ( _dungeon.invertStatusEffect )
+      {
+        statusRow.invertedColumns = getStatusColumnMask( 1, 30 );
+      }
+      break;
+    }
+  }
+
+  // is the player dead? -> show Joey
+  if ( !isPlayerAlive() && ( y >= 3 ) )
+  {
+    statusRow.overlayStartX = 2;
+    statusRow.overlayEndX = 29;
+  }
+}
+
+/*--------------------------------------------------------*/
+// Returns 8 vertical pixels of the status pane at column x (0..31) and row y (0..7).
+// The column masks are shifted on every call, so all columns of
+// the row have to be processed in order.
+uint8_t Dungeon::getStatusPixels( STATUS_ROW &statusRow, const uint8_t x, const uint8_t y )
+{
+  uint8_t pixels = 0;
+
+  if ( statusRow.visibleColumns & 0x01 )
+  {
+    pixels = pgm_read_byte( statusPanel + y * 32 + x );
+    FRAME_STATS_ADD( flashBytesRead, 1 );
+  }
+  if ( statusRow.invertedColumns & 0x01 )
+  {
+    pixels = ~pixels;
+  }
+  statusRow.visibleColumns >>= 1;
+  statusRow.invertedColumns >>= 1;
+
+  if ( ( x >= statusRow.overlayStartX ) && ( x <= statusRow.overlayEndX ) )
+  {
+    pixels = getStatusOverlayPixels( pixels, x, y );
+  }
+
+  return( pixels );
+}
+
+/*--------------------------------------------------------*/
+// Draws the compass needle or Joey (if the player is dead) over the status pane
+uint8_t Dungeon::getStatusOverlayPixels( uint8_t pixels, const uint8_t x, const uint8_t y )
+{
+  if ( !y )
+  {
+    // the compass needle
+    pixels |= pgm_read_byte( compass + x - 14 + 5 * _dungeon.dir );
+    FRAME_STATS_ADD( flashBytesRead, 1 );
+  }
+  else
+  {
+    constexpr uint8_t joeyBitmapWidth = 28;
+    constexpr uint8_t joeyMaskWidth = 28;
+    // the y position needs correction, because we are already in row 3
+    const uint8_t *offsetXY = joey - 3 * ( joeyBitmapWidth + joeyMaskWidth ) + y * ( joeyBitmapWidth + joeyMaskWidth ) + joeyBitmapWidth + 2  - x;
+    // use mask
+    pixels &= pgm_read_byte( offsetXY + joeyMaskWidth );
+    // or pixels in
+    pixels |= pgm_read_byte( offsetXY );
+    FRAME_STATS_ADD( flashBytesRead, 2 );
+  }
+
+  return( pixels );
+}
+#endif
+
+#ifdef _USE_VIEWPORT_CACHE_
+/*--------------------------------------------------------*/
+// Returns true if the dungeon view has to be rendered, because
+// anything it depends on has changed since the last call.
+bool Dungeon::updateViewportCache()
+{
+  VIEWPORT_KEY viewport;
+  viewport.playerX = _dungeon.playerX;
+  viewport.playerY = _dungeon.playerY;
+  viewport.dir = _dungeon.dir;
+  viewport.levelRevision = _levelRevision;
+  viewport.displayXorEffect = _dungeon.displayXorEffect;
+  viewport.invertMonsterEffect = _dungeon.invertMonsterEffect;
+
+  if ( memcmp( &viewport, &_lastViewport, sizeof( viewport ) ) == 0 )
+  {
+    // same view as before - the display already shows it
+    return( false );
+  }
+
+  // remember the new view
+  _lastViewport = viewport;
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// Returns a bit mask of the status pane rows which have to be
+// rendered, because their widgets have changed since the last call.
+uint8_t Dungeon::updateStatusCache()
+{
+  STATUS_KEY status;
+  status.playerItems = _dungeon.playerItems;
+  status.dir = _dungeon.dir;
+  status.hitpointsBarEnd = _dungeon.playerHP / 4;
+  status.invertStatusEffect = _dungeon.invertStatusEffect;
+  status.isPlayerAlive = isPlayerAlive();
+
+  uint8_t statusRows = _forcedStatusRows;
+  _forcedStatusRows = 0;
+
+  // item widgets
+  const uint8_t changedItems = status.playerItems ^ _lastStatus.playerItems;
+  STATUS_WIDGET widget;
+  for ( uint8_t n = 0; n < sizeof( statusWidgets ) / sizeof( statusWidgets[0] ); n++ )
+  {
+    memcpy_P( &widget, &statusWidgets[n], sizeof( widget ) );
+    FRAME_STATS_ADD( flashBytesRead, sizeof( widget ) );
+    if ( changedItems & widget.itemMask ) { statusRows |= 1 << widget.row; }
+  }
+  // compass needle
+  if ( status.dir != _lastStatus.dir ) { statusRows |= 1 << 0; }
+  // hitpoints bar
+  if ( ( status.hitpointsBarEnd != _lastStatus.hitpointsBarEnd ) || ( status.invertStatusEffect != _lastStatus.invertStatusEffect ) ) { statusRows |= 1 << 4; }
+  // Joey
+  if ( status.isPlayerAlive != _lastStatus.isPlayerAlive ) { statusRows |= 0xf8; }
+
+  _lastStatus = status;
+  return( statusRows );
+}
+#endif
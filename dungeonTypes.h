@@ -13,6 +13,9 @@ const uint8_t MAX_VIEW_DISTANCE = 3;
 
 const uint8_t MAX_MONSTERS      = 10;
 
+// marks a potentially visible set as calculated
+const uint16_t VISIBLE_CELLS_VALID = 0x8000;
+
 const uint8_t WINDOW_SIZE_X     = 96;
 const uint8_t WINDOW_CENTER_X   = WINDOW_SIZE_X / 2; /* = 48 */
 const uint8_t WINDOW_SIZE_Y     = 64;
@@ -119,9 +122,8 @@ public:
   int8_t  playerDamage;
   int8_t  playerArmour;
   uint8_t playerItems;
-#if !defined( __AVR_ATtiny85__ )
-  int8_t  dice;
-#endif  
+  // state of the random generator (xorshift16, never 0)
+  uint16_t dice;
   uint8_t displayXorEffect;
   uint8_t invertMonsterEffect;
   uint8_t invertStatusEffect;
@@ -173,6 +175,87 @@ public:
 #endif
 };
 
+// everything the dungeon view (96x64 pixels) depends on
+class VIEWPORT_KEY
+{
+public:
+  int8_t  playerX;
+  int8_t  playerY;
+  uint8_t dir;
+  uint8_t levelRevision;
+  uint8_t displayXorEffect;
+  uint8_t invertMonsterEffect;
+};
+
+// Returns a bit mask for the status pane columns startX..endX (bit 0 = column 0)
+constexpr uint32_t getStatusColumnMask( const uint8_t startX, const uint8_t endX )
+{
+  return( ( 0xFFFFFFFFUL >> ( 31 - endX ) ) & ( 0xFFFFFFFFUL << startX ) );
+}
+
+// a status pane widget which is only visible if the player owns an item
+class STATUS_WIDGET
+{
+public:
+  // row of the status pane (0..7)
+  uint8_t  row;
+  // required item(s)
+  uint8_t  itemMask;
+  // columns covered by the widget (bit 0 = column 0)
+  uint32_t columnMask;
+};
+
+// composition of a single status pane row
+class STATUS_ROW
+{
+public:
+  // columns showing the status panel bitmap (bit 0 = column 0)
+  uint32_t visibleColumns;
+  // columns to be inverted
+  uint32_t invertedColumns;
+  // columns with an overlay (compass needle, Joey)
+  uint8_t  overlayStartX;
+  uint8_t  overlayEndX;
+};
+
+// work done while rendering a frame (see _ENABLE_FRAME_STATS_)
+class FRAME_STATS
+{
+public:
+  // calls of getCellRaw() and getViewCell()
+  uint16_t cellLookups;
+  // wall table entries checked by the renderer
+  uint16_t wallEntriesTested;
+  // calls of getDownScaledBitmapData()
+  uint16_t objectsScaled;
+  // bytes read from flash (memcpy_P(), pgm_read_byte())
+  uint32_t flashBytesRead;
+  // bytes sent to the pixel sink
+  uint16_t displayBytes;
+
+#if !defined(__AVR_ATtiny85__)
+  void serialPrint()
+  {
+    Serial.print( F("FRAME_STATS cells = ") ); Serial.print( cellLookups );
+    Serial.print( F(", walls = ") ); Serial.print( wallEntriesTested );
+    Serial.print( F(", objects = ") ); Serial.print( objectsScaled );
+    Serial.print( F(", flash = ") ); Serial.print( flashBytesRead );
+    Serial.print( F(", display = ") ); Serial.println( displayBytes );
+  }
+#endif
+};
+
+// everything the status pane depends on
+class STATUS_KEY
+{
+public:
+  uint8_t playerItems;
+  uint8_t dir;
+  int8_t  hitpointsBarEnd;
+  uint8_t invertStatusEffect;
+  bool    isPlayerAlive;
+};
+
 // NON_WALL_OBJECT
 class NON_WALL_OBJECT
 {
@@ -295,4 +378,46 @@ enum
   WEST  = 3,
   LEFT  = WEST,
   MAX_ORIENTATION = 4,
+  // use the player's current orientation (evaluated at runtime)
+  ANY_ORIENTATION = 0xff,
+};
+
+// Step vectors for moving away from the player ('distance')
+// and to the right ('offsetLR') for each orientation
+template <uint8_t orientation> class ORIENTATION_STEPS;
+
+template <> class ORIENTATION_STEPS<NORTH>
+{
+public:
+  static constexpr int8_t distanceX =  0;
+  static constexpr int8_t distanceY = -1;
+  static constexpr int8_t offsetX   = +1;
+  static constexpr int8_t offsetY   =  0;
+};
+
+template <> class ORIENTATION_STEPS<EAST>
+{
+public:
+  static constexpr int8_t distanceX = +1;
+  static constexpr int8_t distanceY =  0;
+  static constexpr int8_t offsetX   =  0;
+  static constexpr int8_t offsetY   = +1;
+};
+
+template <> class ORIENTATION_STEPS<SOUTH>
+{
+public:
+  static constexpr int8_t distanceX =  0;
+  static constexpr int8_t distanceY = +1;
+  static constexpr int8_t offsetX   = -1;
+  static constexpr int8_t offsetY   =  0;
+};
+
+template <> class ORIENTATION_STEPS<WEST>
+{
+public:
+  static constexpr int8_t distanceX = -1;
+  static constexpr int8_t distanceY =  0;
+  static constexpr int8_t offsetX   =  0;
+  static constexpr int8_t offsetY   = -1;
 };
@@ -85,3 +85,16 @@ const SIMPLE_WALL_INFO arrayOfWallInfo[] PROGMEM = {
 
   { NULL                   ,   0   ,   0 ,   0x00      ,     0   ,      0    ,   0  ,   0 }, // 7 unused bytes.. how can I save those?
 };
+
+// status pane widgets depending on the player's items (6 bytes per widget), only used with _USE_STATUS_WIDGETS_
+// The hitpoints bar and the death overlay are handled by Dungeon::getStatusRow().
+const STATUS_WIDGET statusWidgets[] PROGMEM = {
+  // row, itemMask    , columnMask
+  {  0 , ITEM_COMPASS , getStatusColumnMask(  0, 31 ) }, // compass (the whole row)
+  {  5 , ITEM_SWORD   , getStatusColumnMask(  2,  7 ) }, // sword
+  {  5 , ITEM_SHIELD  , getStatusColumnMask(  8, 13 ) }, // shield
+  {  5 , ITEM_AMULET  , getStatusColumnMask( 14, 19 ) }, // amulet
+  {  5 , ITEM_RING    , getStatusColumnMask( 20, 25 ) }, // ring
+  {  5 , ITEM_KEY     , getStatusColumnMask( 26, 30 ) }, // key
+  {  6 , ITEM_VICTORY , getStatusColumnMask(  1, 30 ) }, // victory banner
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+// Stand-in for the Adafruit_SSD1306 library: just the frame buffer
+// (8 rows of 128 bytes, one byte holds 8 vertical pixels)
+
+#include <Arduino.h>
+#include "Wire.h"
+
+#define SSD1306_SWITCHCAPVCC  0x02
+
+// called when a frame is transferred to the display
+extern HOST_THREAD_LOCAL void ( *hostDisplayHook )();
+
+class Adafruit_SSD1306
+{
+public:
+  Adafruit_SSD1306( uint8_t /*width*/, uint8_t /*height*/, TwoWire * /*wire*/, int8_t /*resetPin*/ ) {}
+
+  bool begin( uint8_t /*vccState*/, uint8_t /*address*/ ) { return( true ); }
+  uint8_t *getBuffer() { return( buffer ); }
+  // count the transferred frames
+  void display()
+  {
+    frameCount++;
+    if ( hostDisplayHook ) { hostDisplayHook(); }
+  }
+
+  uint8_t buffer[128 * 8];
+  uint32_t frameCount;
+};
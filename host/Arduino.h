@@ -0,0 +1,124 @@
+#pragma once
+
+// Minimal Arduino environment for compiling the game on a PC (Linux, macOS, MinGW).
+// Only what the game uses is provided:
+//   - PROGMEM data lives in RAM, the pgm_read/memcpy_P functions are plain reads
+//   - the pins are variables, so the joystick and the fire button can be set from the host program
+//   - delay() and delayMicroseconds() only advance the simulated time (no waiting),
+//     reading an input costs time, too (analogRead() waits for the ADC)
+//   - the host program can release the inputs and stop the game at given times
+//   - Serial output is discarded unless 'hostSerialOutput' is set (e.g. to stdout)
+//   - the simulated hardware (pins, time, hooks) is thread local, so every thread is a device of its own
+
+// like ARDUINO_ARCH_AVR, ARDUINO_ARCH_SAMD...
+#define ARDUINO_ARCH_HOST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// flash access
+#define PROGMEM
+#define pgm_read_byte( address )   ( *( const uint8_t * )( address ) )
+#define pgm_read_word( address )   ( *( const uint16_t * )( address ) )
+#define pgm_read_dword( address )  ( *( const uint32_t * )( address ) )
+#define memcpy_P  memcpy
+#define strcpy_P  strcpy
+
+class __FlashStringHelper;
+#define F( text )  ( reinterpret_cast<const __FlashStringHelper *>( text ) )
+
+// pins
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define LOW           0
+#define HIGH          1
+#define A0  14
+#define A1  15
+#define A2  16
+#define A3  17
+#define HOST_PINS  20
+
+// thread local storage without the initialization check of C++11 thread_local on every
+// access (it would keep the compiler from folding the delay loops)
+#define HOST_THREAD_LOCAL  __thread
+
+// analog values (0..1023) and digital levels of all pins
+extern HOST_THREAD_LOCAL uint16_t hostAnalogPins[HOST_PINS];
+extern HOST_THREAD_LOCAL uint8_t hostDigitalPins[HOST_PINS];
+
+// simulated time
+extern HOST_THREAD_LOCAL uint32_t hostMicros;
+inline void delay( unsigned long ms ) { hostMicros += ms * 1000; }
+inline void delayMicroseconds( unsigned int us ) { hostMicros += us; }
+inline unsigned long micros() { return( hostMicros ); }
+inline unsigned long millis() { return( hostMicros / 1000 ); }
+
+// time of an input reading (ADC: 13 cycles at 125 kHz)
+#define HOST_ANALOG_READ_US   104
+#define HOST_DIGITAL_READ_US    1
+
+// all inputs are released at this time (0 = never)
+extern HOST_THREAD_LOCAL uint32_t hostInputReleaseTime;
+// the game is stopped at this time by throwing HOST_DEADLINE_EXCEEDED (0 = never)
+extern HOST_THREAD_LOCAL uint32_t hostDeadline;
+class HOST_DEADLINE_EXCEEDED {};
+// called on every write to a digital pin (e.g. to see the sound output)
+extern HOST_THREAD_LOCAL void ( *hostDigitalWriteHook )( uint8_t pin, uint8_t value );
+// called before every input reading (e.g. to press the buttons of a script)
+extern HOST_THREAD_LOCAL void ( *hostPollHook )();
+
+void hostReleaseInputs();
+void hostPollInputs( const uint32_t readTime );
+
+inline void pinMode( uint8_t /*pin*/, uint8_t /*mode*/ ) {}
+inline int analogRead( uint8_t pin ) { hostPollInputs( HOST_ANALOG_READ_US ); return( hostAnalogPins[pin] ); }
+inline int digitalRead( uint8_t pin ) { hostPollInputs( HOST_DIGITAL_READ_US ); return( hostDigitalPins[pin] ); }
+inline void digitalWrite( uint8_t pin, uint8_t value )
+{
+  hostDigitalPins[pin] = value;
+  if ( hostDigitalWriteHook ) { hostDigitalWriteHook( pin, value ); }
+}
+
+// serial port
+#define DEC  10
+#define HEX  16
+
+extern FILE *hostSerialOutput;
+
+class HOST_SERIAL
+{
+public:
+  void begin( unsigned long /*baudRate*/ ) {}
+  int available() { return( 0 ); }
+  int read() { return( -1 ); }
+
+  void print( const char *text ) { write( "%s", text ); }
+  void print( const __FlashStringHelper *text ) { print( reinterpret_cast<const char *>( text ) ); }
+  void print( char c ) { write( "%c", c ); }
+  void print( long number, int base = DEC ) { write( ( base == HEX ) ? "%lX" : "%ld", number ); }
+  void print( unsigned long number, int base = DEC ) { write( ( base == HEX ) ? "%lX" : "%lu", number ); }
+  void print( int number, int base = DEC ) { print( long( number ), base ); }
+  void print( unsigned int number, int base = DEC ) { print( ( unsigned long )number, base ); }
+  void print( unsigned char number, int base = DEC ) { print( ( unsigned long )number, base ); }
+  void print( signed char number, int base = DEC ) { print( long( number ), base ); }
+  void print( short number, int base = DEC ) { print( long( number ), base ); }
+  void print( unsigned short number, int base = DEC ) { print( ( unsigned long )number, base ); }
+
+  void println() { write( "\r\n" ); }
+  template <class T> void println( T value ) { print( value ); println(); }
+  template <class T> void println( T value, int base ) { print( value, base ); println(); }
+
+private:
+  template <class T> void write( const char *format, T value ) { if ( hostSerialOutput ) { fprintf( hostSerialOutput, format, value ); } }
+  void write( const char *text ) { if ( hostSerialOutput ) { fputs( text, hostSerialOutput ); } }
+};
+
+extern HOST_SERIAL Serial;
+
+// sizeof() is an unsigned long on 64 bit hosts (unsigned int on AVR)
+void serialPrint( const unsigned long number );
+void serialPrintln( const unsigned long number );
@@ -0,0 +1,5 @@
+#pragma once
+
+// I2C is not used on the host, the display is a frame buffer (see Adafruit_SSD1306.h)
+class TwoWire {};
+extern TwoWire Wire;
@@ -0,0 +1,4 @@
+#pragma once
+
+// the flash access functions are part of the host's "Arduino.h"
+#include "../Arduino.h"
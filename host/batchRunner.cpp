@@ -0,0 +1,240 @@
+//
+// Runs thousands of independent games on all cores (bot tests, balance simulation, regression runs).
+//
+// Every game is a Dungeon instance with its own inputs (a random bot), frame sink and dice seed
+// (see DUNGEON_HOST_IO in Dungeon.h), the simulated hardware of the host is thread local.
+// Game n always gets the same seeds, so the results don't depend on the number of threads.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -pthread -Ihost -I. *.cpp host/hostArduino.cpp host/batchRunner.cpp -o batchRunner
+//
+// Run:
+//   ./batchRunner [-g <games>] [-j <threads>] [-a <actions>]
+//     -g <games>    number of games (default: 10000)
+//     -j <threads>  number of threads (default: all cores)
+//     -a <actions>  maximum number of bot actions per game (default: 1000)
+//
+// The bot taps a random button at every input poll (up 40%, fire 25%, left/right 15% each, down 5%).
+// A game ends with the death of the player, the victory or after the maximum number of actions.
+// Report: outcomes, monsters killed, items found, actions and frames per game, throughput and
+// a hash over the results of all games (including the hashes of all frames) to compare engine versions.
+//
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "dungeon.h"
+#include "pixelSinks.h"
+
+// game outcomes
+enum
+{
+  OUTCOME_DEATH = 0,
+  OUTCOME_VICTORY,
+  OUTCOME_ACTION_LIMIT,
+  OUTCOMES,
+};
+
+static const char *outcomeNames[OUTCOMES] = { "death", "victory", "action limit" };
+static const char *itemNames[8] = { "compass", "amulet", "ring", "key", "potion", "sword", "shield", "victory" };
+
+// thrown by the bot to end a game
+class GAME_OVER {};
+
+// result of a game
+class GAME_RESULT
+{
+public:
+  uint8_t  outcome;
+  uint8_t  items;
+  uint8_t  monstersKilled;
+  uint32_t actions;
+  uint32_t frames;
+  // hash of all frames and the final state
+  uint32_t hash;
+};
+
+// state of a running game
+class GAME
+{
+public:
+  Dungeon dungeon;
+  DUNGEON_HOST_IO io;
+  GAME_RESULT result;
+  uint32_t botRandom;
+  uint8_t lastInputs;
+  uint32_t maxActions;
+};
+
+/*--------------------------------------------------------*/
+// FNV-1a step
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size )
+{
+  for ( size_t n = 0; n < size; n++ ) { hash = ( hash ^ ( ( const uint8_t * )data )[n] ) * 16777619UL; }
+  return( hash );
+}
+
+/*--------------------------------------------------------*/
+// the bot: a random button is tapped at every poll
+static uint8_t botInputs( Dungeon &dungeon )
+{
+  GAME &game = *( GAME * )dungeon._hostIO->context;
+
+  // release the last button
+  if ( game.lastInputs != INPUT_NONE )
+  {
+    game.lastInputs = INPUT_NONE;
+    return( INPUT_NONE );
+  }
+
+  if ( dungeon._dungeon.playerItems & ITEM_VICTORY )
+  {
+    game.result.outcome = OUTCOME_VICTORY;
+    throw GAME_OVER();
+  }
+  if ( game.result.actions >= game.maxActions )
+  {
+    game.result.outcome = OUTCOME_ACTION_LIMIT;
+    throw GAME_OVER();
+  }
+
+  // xorshift32
+  game.botRandom ^= game.botRandom << 13;
+  game.botRandom ^= game.botRandom >> 17;
+  game.botRandom ^= game.botRandom << 5;
+  const uint8_t choice = game.botRandom % 100;
+
+  if ( choice < 40 ) { game.lastInputs = INPUT_UP; }
+  else if ( choice < 65 ) { game.lastInputs = INPUT_FIRE; }
+  else if ( choice < 80 ) { game.lastInputs = INPUT_LEFT; }
+  else if ( choice < 95 ) { game.lastInputs = INPUT_RIGHT; }
+  else { game.lastInputs = INPUT_DOWN; }
+
+  game.result.actions++;
+  return( game.lastInputs );
+}
+
+/*--------------------------------------------------------*/
+static void renderFrame( Dungeon &dungeon )
+{
+  GAME &game = *( GAME * )dungeon._hostIO->context;
+  game.result.frames++;
+
+  // always render, the renderer resets the flash effects
+  HASH_SINK sink;
+  dungeon.renderImage( sink );
+  game.result.hash = hashBytes( game.result.hash, &sink.hash, sizeof( sink.hash ) );
+
+  // the player's state before a death clears the dungeon
+  if ( dungeon.isPlayerAlive() )
+  {
+    game.result.items = dungeon._dungeon.playerItems;
+    game.result.monstersKilled = 0;
+    for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+    {
+      if ( dungeon._dungeon.monsterStats[n].hitpoints <= 0 ) { game.result.monstersKilled++; }
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+static void playGame( const uint32_t gameNumber, const uint32_t maxActions, GAME_RESULT &result )
+{
+  GAME *game = new GAME();
+  game->io.readInputs = botInputs;
+  game->io.renderFrame = renderFrame;
+  game->io.diceSeed = uint16_t( gameNumber * 40503UL ) | 1;
+  game->io.context = game;
+  game->dungeon._hostIO = &game->io;
+  game->botRandom = gameNumber * 2654435761UL + 1;
+  game->maxActions = maxActions;
+  game->result.hash = 2166136261UL;
+
+  try
+  {
+    // returns after the death of the player
+    game->dungeon.gameLoop();
+    game->result.outcome = OUTCOME_DEATH;
+  }
+  catch ( GAME_OVER & )
+  {
+  }
+
+  game->result.hash = hashBytes( game->result.hash, &game->dungeon._dungeon, sizeof( game->dungeon._dungeon ) );
+  result = game->result;
+  delete game;
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  uint32_t games = 10000;
+  unsigned threads = std::thread::hardware_concurrency();
+  uint32_t maxActions = 1000;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-g" ) && ( n + 1 < argc ) ) { games = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-j" ) && ( n + 1 < argc ) ) { threads = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-a" ) && ( n + 1 < argc ) ) { maxActions = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-g <games>] [-j <threads>] [-a <actions>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+  if ( !threads ) { threads = 1; }
+
+  std::vector<GAME_RESULT> results( games );
+  std::atomic<uint32_t> nextGame( 0 );
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for ( unsigned n = 0; n < threads; n++ )
+  {
+    workers.emplace_back( [&]()
+    {
+      uint32_t gameNumber;
+      while ( ( gameNumber = nextGame++ ) < games )
+      {
+        playGame( gameNumber, maxActions, results[gameNumber] );
+      }
+    } );
+  }
+  for ( std::thread &worker : workers ) { worker.join(); }
+
+  double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+  // summary (in the order of the games, so it doesn't depend on the threads)
+  uint32_t outcomes[OUTCOMES] = { 0 };
+  uint32_t itemCounts[8] = { 0 };
+  uint64_t actions = 0, frames = 0, monstersKilled = 0;
+  uint32_t hash = 2166136261UL;
+
+  for ( const GAME_RESULT &result : results )
+  {
+    outcomes[result.outcome]++;
+    for ( uint8_t item = 0; item < 8; item++ ) { if ( result.items & ( 1 << item ) ) { itemCounts[item]++; } }
+    actions += result.actions;
+    frames += result.frames;
+    monstersKilled += result.monstersKilled;
+    hash = hashBytes( hash, &result.hash, sizeof( result.hash ) );
+  }
+
+  printf( "%u games, %u threads, %.2f s (%.0f games/s, %.0f frames/s)\n", games, threads, time,
+          games / time, frames / time );
+  for ( uint8_t outcome = 0; outcome < OUTCOMES; outcome++ )
+  {
+    printf( "  %-13s %7u (%5.1f%%)\n", outcomeNames[outcome], outcomes[outcome], 100.0 * outcomes[outcome] / games );
+  }
+  printf( "per game: %.1f actions, %.1f frames, %.2f of %u monsters killed\n", double( actions ) / games,
+          double( frames ) / games, double( monstersKilled ) / games, MAX_MONSTERS );
+  printf( "items found:" );
+  for ( uint8_t item = 0; item < 8; item++ ) { printf( " %s %.1f%%", itemNames[item], 100.0 * itemCounts[item] / games ); }
+  printf( "\nresult hash: %08x\n", hash );
+
+  return( 0 );
+}
@@ -0,0 +1,407 @@
+//
+// Monte Carlo simulation of the fights along a route through Level_1 (combat balance).
+//
+// The route (a script like for host/walkthrough.cpp, default: the path to the victory found by
+// host/levelSolver.cpp) is played once, every monster is fought until it's dead. The game state
+// in front of every fight, the items of the route and the potions between the fights are kept.
+// Then the fights are simulated again and again with Dungeon::playerInput() (so playerAttack()
+// and monsterAttack() of the game decide), the hit points are carried from fight to fight.
+// In the game the timing of the inputs is mixed into the dice, so every fight gets a fresh
+// seed here.
+//
+// Configurations vary the equipment and the potions along the route:
+//   equipment: as found on the route, the sword or the shield or both from the start, none at all
+//   potions:   where the route finds them, none at all, every potion of the level (chests and
+//              treasures, even the ones off the route) right before the last fight
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -pthread -Ihost -I. *.cpp host/hostArduino.cpp host/combatSimulator.cpp -o combatSimulator
+//
+// Run:
+//   ./combatSimulator [-s <script>] [-n <runs>] [-j <threads>]
+//     -s <script>   route (L, R, U, D, F, see host/walkthrough.cpp, default: the levelSolver path)
+//     -n <runs>     runs per configuration (default: 1000000)
+//     -j <threads>  number of threads (default: all cores)
+//
+// Report: the fights of the route, then per configuration the chance to survive all fights,
+// the hit points left (mean and percentiles) and the most deadly fight, and for the route
+// as played the deaths per fight and the distribution of the hit points left.
+// The results don't depend on the number of threads.
+//
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hostGame.h"
+#include "LevelDefinitions.h"
+
+// the path to the victory of ./levelSolver
+static const char *defaultRoute =
+  "RURULFUFRRUURUUURUURULUURRFURUUURUULUUULURUUULFURFFRURULUURFRUULURUUULUUURUUUURUUULUFUULURULURUURUURULUURFULFLULUURUL"
+  "UUUULUURUFRRULUURUUUURULUURULFLULUURULUUUULUURUULUUURUUUURRUURUUUURUUUURUURFUF";
+
+// the hit points of the player while the route is played
+#define ROUTE_PLAYER_HP  100
+
+// hit points above this are counted as this
+#define MAX_HP_HISTOGRAM  64
+
+// equipment configurations
+enum
+{
+  EQUIPMENT_ROUTE = 0,
+  EQUIPMENT_SWORD_FIRST,
+  EQUIPMENT_SHIELD_FIRST,
+  EQUIPMENT_BOTH_FIRST,
+  EQUIPMENT_NONE,
+  EQUIPMENTS,
+};
+static const char *equipmentNames[EQUIPMENTS] = { "route", "sword first", "shield first", "both first", "none" };
+
+// potion configurations
+enum
+{
+  POTIONS_ROUTE = 0,
+  POTIONS_NONE,
+  POTIONS_ALL_LAST_FIGHT,
+  POTION_USES,
+};
+static const char *potionNames[POTION_USES] = { "route", "none", "all at last" };
+
+/*--------------------------------------------------------*/
+// a fight of the route
+class ROUTE_FIGHT
+{
+public:
+  // the game state in front of the monster, before the first blow
+  DUNGEON state;
+  uint8_t monster;
+  // potions found since the last fight
+  uint8_t potions;
+};
+
+// results of a configuration
+class COMBAT_RESULT
+{
+public:
+  COMBAT_RESULT() : wins( 0 ), hpSum( 0 ), deaths(), hpHistogram() {}
+
+  void add( const COMBAT_RESULT &result )
+  {
+    wins += result.wins;
+    hpSum += result.hpSum;
+    for ( size_t n = 0; n < deaths.size(); n++ ) { deaths[n] += result.deaths[n]; }
+    for ( uint8_t hp = 0; hp <= MAX_HP_HISTOGRAM; hp++ ) { hpHistogram[hp] += result.hpHistogram[hp]; }
+  }
+
+  // hit points left in percent of the wins
+  uint8_t getPercentile( const uint8_t percent ) const
+  {
+    uint64_t count = 0;
+    for ( uint8_t hp = 0; hp <= MAX_HP_HISTOGRAM; hp++ )
+    {
+      count += hpHistogram[hp];
+      if ( count * 100 >= wins * percent ) { return( hp ); }
+    }
+    return( MAX_HP_HISTOGRAM );
+  }
+
+  uint64_t wins;
+  uint64_t hpSum;
+  // per fight of the route
+  std::vector<uint64_t> deaths;
+  uint64_t hpHistogram[MAX_HP_HISTOGRAM + 1];
+};
+
+static std::vector<ROUTE_FIGHT> fights;
+// potions found after the last fight
+static uint8_t finalPotions;
+// all potions of the level
+static uint8_t levelPotions;
+static int8_t initialHP;
+
+/*--------------------------------------------------------*/
+static const char *getMonsterName( const uint8_t monsterType )
+{
+  switch ( monsterType )
+  {
+    case RAT:      return( "rat" );
+    case SKELETON: return( "skeleton" );
+    case BEHOLDER: return( "beholder" );
+    case MIMIC:    return( "mimic" );
+    default:       return( "monster" );
+  }
+}
+
+/*--------------------------------------------------------*/
+static uint8_t getInputs( const char key )
+{
+  switch ( key )
+  {
+    case 'L': return( INPUT_LEFT );
+    case 'R': return( INPUT_RIGHT );
+    case 'U': return( INPUT_UP );
+    case 'D': return( INPUT_DOWN );
+    case 'F': return( INPUT_FIRE );
+    default:  return( INPUT_NONE );
+  }
+}
+
+/*--------------------------------------------------------*/
+// plays the route with plenty of hit points and collects the fights, returns the items at the end
+static uint8_t playRoute( const char *route )
+{
+  HOST_GAME game;
+  DUNGEON &state = game.dungeon._dungeon;
+  game.dungeon.init();
+  initialHP = state.playerHP;
+  uint8_t potions = 0;
+
+  levelPotions = 0;
+  for ( size_t n = 0; n < sizeof( interactionData ) / sizeof( interactionData[0] ); n++ )
+  {
+    if ( interactionData[n].newItem & ITEM_POTION ) { levelPotions++; }
+  }
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+  {
+    if ( state.monsterStats[n].treasureItemMask & ITEM_POTION ) { levelPotions++; }
+  }
+
+  for ( const char *key = route; *key; key++ )
+  {
+    const DUNGEON before = state;
+    state.playerHP = ROUTE_PLAYER_HP;
+    game.play( getInputs( *key ) );
+
+    // a potion is swallowed right away (see playerInteraction())
+    if ( state.playerHP > ROUTE_PLAYER_HP ) { potions++; }
+
+    for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+    {
+      if ( state.monsterStats[n].hitpoints == before.monsterStats[n].hitpoints ) { continue; }
+
+      ROUTE_FIGHT fight;
+      fight.state = before;
+      fight.monster = n;
+      fight.potions = potions;
+      fights.push_back( fight );
+      potions = 0;
+
+      // fight to the end
+      while ( state.monsterStats[n].hitpoints > 0 )
+      {
+        state.playerHP = ROUTE_PLAYER_HP;
+        game.play( INPUT_FIRE );
+      }
+    }
+  }
+  finalPotions = potions;
+  return( state.playerItems );
+}
+
+/*--------------------------------------------------------*/
+// xorshift32
+static uint32_t nextRandom( uint32_t &random )
+{
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return( random );
+}
+
+/*--------------------------------------------------------*/
+// the sword and the shield of a configuration
+static uint8_t getEquipment( const uint8_t equipment, const uint8_t routeItems )
+{
+  const uint8_t gear = ITEM_SWORD | ITEM_SHIELD;
+  switch ( equipment )
+  {
+    case EQUIPMENT_SWORD_FIRST:  return( ( routeItems & gear ) | ITEM_SWORD );
+    case EQUIPMENT_SHIELD_FIRST: return( ( routeItems & gear ) | ITEM_SHIELD );
+    case EQUIPMENT_BOTH_FIRST:   return( gear );
+    case EQUIPMENT_NONE:         return( 0 );
+    default:                     return( routeItems & gear );
+  }
+}
+
+/*--------------------------------------------------------*/
+// one run through all fights of the route
+static void simulateRun( HOST_GAME &game, const uint8_t equipment, const uint8_t potionUse,
+                         uint32_t random, COMBAT_RESULT &result )
+{
+  DUNGEON &state = game.dungeon._dungeon;
+  int16_t hp = initialHP;
+
+  for ( size_t n = 0; n < fights.size(); n++ )
+  {
+    const ROUTE_FIGHT &fight = fights[n];
+
+    // the dice of the game, a fresh seed for every fight (the input timing in the game)
+    state.dice = uint16_t( nextRandom( random ) ) | 1;
+
+    uint8_t potions = ( potionUse == POTIONS_ROUTE ) ? fight.potions : 0;
+    if ( ( potionUse == POTIONS_ALL_LAST_FIGHT ) && ( n + 1 == fights.size() ) ) { potions = levelPotions; }
+    // like playerInteraction()
+    for ( ; potions; potions-- ) { hp += POTION_HITPOINT_BONUS + game.dungeon.getDice( 8 ); }
+
+    const uint16_t dice = state.dice;
+    state = fight.state;
+    state.dice = dice;
+    state.playerHP = int8_t( std::min( hp, int16_t( 127 ) ) );
+    state.playerItems = ( fight.state.playerItems & ~( ITEM_SWORD | ITEM_SHIELD | ITEM_POTION ) )
+                      | getEquipment( equipment, fight.state.playerItems );
+    // the values of init(), prepareFrame() adds the equipment
+    state.playerDamage = 3;
+    state.playerArmour = 0;
+
+    MONSTER_STATS &monster = state.monsterStats[fight.monster];
+    while ( ( monster.hitpoints > 0 ) && ( state.playerHP > 0 ) ) { game.play( INPUT_FIRE ); }
+
+    if ( state.playerHP <= 0 )
+    {
+      result.deaths[n]++;
+      return;
+    }
+    hp = state.playerHP;
+  }
+
+  if ( potionUse == POTIONS_ROUTE )
+  {
+    for ( uint8_t potions = finalPotions; potions; potions-- ) { hp += POTION_HITPOINT_BONUS + game.dungeon.getDice( 8 ); }
+  }
+
+  result.wins++;
+  result.hpSum += hp;
+  result.hpHistogram[std::min( hp, int16_t( MAX_HP_HISTOGRAM ) )]++;
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *route = defaultRoute;
+  uint32_t runs = 1000000;
+  unsigned threads = std::thread::hardware_concurrency();
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-s" ) && ( n + 1 < argc ) ) { route = argv[++n]; }
+    else if ( !strcmp( argv[n], "-n" ) && ( n + 1 < argc ) ) { runs = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-j" ) && ( n + 1 < argc ) ) { threads = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-s <script>] [-n <runs>] [-j <threads>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+  if ( !threads ) { threads = 1; }
+  if ( !runs ) { runs = 1; }
+
+  const uint8_t routeItems = playRoute( route );
+  uint8_t routePotions = finalPotions;
+  for ( const ROUTE_FIGHT &fight : fights ) { routePotions += fight.potions; }
+  printf( "route: %zu keys, %zu fights, %s, %u of %u potions of the level\n", strlen( route ), fights.size(),
+          ( routeItems & ITEM_VICTORY ) ? "victory" : "no victory", routePotions, levelPotions );
+  if ( fights.empty() )
+  {
+    fprintf( stderr, "*** no fights on the route\n" );
+    return( 1 );
+  }
+  for ( size_t n = 0; n < fights.size(); n++ )
+  {
+    const ROUTE_FIGHT &fight = fights[n];
+    const MONSTER_STATS &monster = fight.state.monsterStats[fight.monster];
+    printf( "  %2zu: %-8s at (%2u, %2u)  hp %3d  damage %+d  %s  %s%s%s\n", n + 1, getMonsterName( monster.monsterType ),
+            monster.position % LEVEL_WIDTH, monster.position / LEVEL_WIDTH, monster.hitpoints, monster.damageBonus,
+            monster.attacksFirst ? "attacks first" : "             ",
+            ( fight.state.playerItems & ITEM_SWORD ) ? "sword " : "", ( fight.state.playerItems & ITEM_SHIELD ) ? "shield " : "",
+            fight.potions ? "potion before" : "" );
+  }
+
+  // all configurations, every one with the same seeds
+  const uint32_t configs = EQUIPMENTS * POTION_USES;
+  std::vector<COMBAT_RESULT> results( configs );
+  for ( COMBAT_RESULT &result : results ) { result.deaths.resize( fights.size(), 0 ); }
+  std::vector<std::vector<COMBAT_RESULT>> threadResults( threads, results );
+  std::atomic<uint64_t> nextRun( 0 );
+  const uint64_t totalRuns = uint64_t( runs ) * configs;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for ( unsigned t = 0; t < threads; t++ )
+  {
+    workers.emplace_back( [&, t]()
+    {
+      HOST_GAME game;
+      for ( ;; )
+      {
+        const uint64_t first = nextRun.fetch_add( 1024 );
+        if ( first >= totalRuns ) { return; }
+        for ( uint64_t n = first; n < std::min( first + 1024, totalRuns ); n++ )
+        {
+          const uint32_t config = uint32_t( n / runs );
+          const uint32_t run = uint32_t( n % runs );
+          // never 0
+          const uint32_t random = ( run + 1 ) * 2654435761UL | 1;
+          simulateRun( game, config / POTION_USES, config % POTION_USES, random, threadResults[t][config] );
+        }
+      }
+    } );
+  }
+  for ( std::thread &worker : workers ) { worker.join(); }
+
+  double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+  for ( unsigned t = 0; t < threads; t++ )
+  {
+    for ( uint32_t config = 0; config < configs; config++ ) { results[config].add( threadResults[t][config] ); }
+  }
+
+  printf( "\n%u configurations x %u runs, %u threads, %.2f s (%.0f runs/s)\n\n", configs, runs, threads, time,
+          totalRuns / time );
+  printf( "  equipment     potions      survive   hp left: mean  p10  p50  p90   most deadly fight\n" );
+  for ( uint32_t config = 0; config < configs; config++ )
+  {
+    const COMBAT_RESULT &result = results[config];
+    size_t deadliest = 0;
+    for ( size_t n = 1; n < fights.size(); n++ ) { if ( result.deaths[n] > result.deaths[deadliest] ) { deadliest = n; } }
+
+    printf( "  %-13s %-11s  %6.2f%%  ", equipmentNames[config / POTION_USES], potionNames[config % POTION_USES],
+            100.0 * result.wins / runs );
+    if ( result.wins )
+    {
+      printf( "        %5.1f  %3u  %3u  %3u", double( result.hpSum ) / result.wins, result.getPercentile( 10 ),
+              result.getPercentile( 50 ), result.getPercentile( 90 ) );
+    }
+    else
+    {
+      printf( "            -    -    -    -" );
+    }
+    if ( result.deaths[deadliest] )
+    {
+      printf( "   %2zu: %s (%.2f%%)", deadliest + 1, getMonsterName( fights[deadliest].state.monsterStats[fights[deadliest].monster].monsterType ),
+              100.0 * result.deaths[deadliest] / runs );
+    }
+    printf( "\n" );
+  }
+
+  // the route as played
+  const COMBAT_RESULT &routeResult = results[EQUIPMENT_ROUTE * POTION_USES + POTIONS_ROUTE];
+  printf( "\nroute as played, deaths per fight:" );
+  for ( size_t n = 0; n < fights.size(); n++ ) { printf( " %zu: %.2f%%", n + 1, 100.0 * routeResult.deaths[n] / runs ); }
+  printf( "\nroute as played, hit points left:\n" );
+  uint64_t maxCount = 1;
+  for ( uint8_t hp = 1; hp <= MAX_HP_HISTOGRAM; hp++ ) { maxCount = std::max( maxCount, routeResult.hpHistogram[hp] ); }
+  for ( uint8_t hp = 1; hp <= MAX_HP_HISTOGRAM; hp++ )
+  {
+    if ( !routeResult.hpHistogram[hp] ) { continue; }
+    printf( "  %3u%s %6.2f%% %s\n", hp, ( hp == MAX_HP_HISTOGRAM ) ? "+" : " ", 100.0 * routeResult.hpHistogram[hp] / runs,
+            std::string( size_t( 50 * routeResult.hpHistogram[hp] / maxCount ), '#' ).c_str() );
+  }
+
+  return( 0 );
+}
@@ -0,0 +1,158 @@
+//
+// Environment API for automated play testing, see dungeonEnv.h for details.
+//
+
+#include "dungeonEnv.h"
+
+/*--------------------------------------------------------*/
+DUNGEON_ENV::DUNGEON_ENV( const bool render ) : game( render ), done( true )
+{
+}
+
+/*--------------------------------------------------------*/
+// runs the game like Dungeon::gameLoop() until it waits for the next action
+void DUNGEON_ENV::waitForAction()
+{
+  do
+  {
+    if ( !game.dungeon.isPlayerAlive() || ( game.dungeon._dungeon.playerItems & ITEM_VICTORY ) )
+    {
+      done = true;
+      return;
+    }
+    game.dungeon.prepareFrame();
+    game.dungeon.renderImage();
+  }
+  // a frame without player action for every flashing effect
+  while ( game.dungeon.endFlashEffect() );
+}
+
+/*--------------------------------------------------------*/
+uint8_t DUNGEON_ENV::getMonstersDefeated() const
+{
+  uint8_t count = 0;
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+  {
+    if ( game.dungeon._dungeon.monsterStats[n].hitpoints <= 0 ) { count++; }
+  }
+  return( count );
+}
+
+/*--------------------------------------------------------*/
+void DUNGEON_ENV::reset( const uint16_t seed )
+{
+  // xorshift doesn't work with 0
+  game.io.diceSeed = seed ? seed : 1;
+  game.frames = 0;
+  done = false;
+  game.dungeon.init();
+  waitForAction();
+}
+
+/*--------------------------------------------------------*/
+DUNGEON_STEP DUNGEON_ENV::step( const uint8_t action )
+{
+  DUNGEON_STEP result = { 0, done };
+  if ( done ) { return( result ); }
+
+  const uint8_t items = game.dungeon._dungeon.playerItems;
+  const uint8_t monstersDefeated = getMonstersDefeated();
+
+  if ( game.dungeon.playerInput( action ) ) { waitForAction(); }
+
+  // new items only (e.g. not the key given back to a door)
+  for ( uint8_t newItems = game.dungeon._dungeon.playerItems & ~items; newItems; newItems &= newItems - 1 )
+  {
+    result.reward += ENV_REWARD_ITEM;
+  }
+  result.reward += ( getMonstersDefeated() - monstersDefeated ) * ENV_REWARD_MONSTER;
+
+  if ( done )
+  {
+    result.reward += game.dungeon.isPlayerAlive() ? ENV_REWARD_VICTORY : ENV_REWARD_DEATH;
+  }
+  result.done = done;
+  return( result );
+}
+
+/*--------------------------------------------------------*/
+DUNGEON_ENV_BATCH::DUNGEON_ENV_BATCH( const uint32_t size, const unsigned threads, const bool render )
+  : threadCount( threads ), job( nullptr ), jobNumber( 0 ), busyWorkers( 0 ), quit( false )
+{
+  for ( uint32_t n = 0; n < size; n++ ) { envs.push_back( new DUNGEON_ENV( render ) ); }
+
+  if ( !threadCount ) { threadCount = std::thread::hardware_concurrency(); }
+  if ( !threadCount ) { threadCount = 1; }
+  if ( threadCount > size ) { threadCount = size ? size : 1; }
+  for ( unsigned thread = 0; thread < threadCount; thread++ )
+  {
+    workers.emplace_back( &DUNGEON_ENV_BATCH::worker, this, thread );
+  }
+}
+
+/*--------------------------------------------------------*/
+DUNGEON_ENV_BATCH::~DUNGEON_ENV_BATCH()
+{
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    quit = true;
+  }
+  jobReady.notify_all();
+  for ( std::thread &thread : workers ) { thread.join(); }
+  for ( DUNGEON_ENV *env : envs ) { delete env; }
+}
+
+/*--------------------------------------------------------*/
+void DUNGEON_ENV_BATCH::worker( const unsigned thread )
+{
+  // the same share of the environments for every job
+  const uint32_t first = uint32_t( uint64_t( envs.size() ) * thread / threadCount );
+  const uint32_t last = uint32_t( uint64_t( envs.size() ) * ( thread + 1 ) / threadCount );
+  uint32_t lastJob = 0;
+
+  for ( ;; )
+  {
+    const std::function<void( uint32_t, uint32_t )> *currentJob;
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      jobReady.wait( lock, [&]() { return( quit || ( jobNumber != lastJob ) ); } );
+      if ( quit ) { return; }
+      lastJob = jobNumber;
+      currentJob = job;
+    }
+
+    ( *currentJob )( first, last );
+
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( !--busyWorkers ) { jobDone.notify_one(); }
+  }
+}
+
+/*--------------------------------------------------------*/
+void DUNGEON_ENV_BATCH::run( const std::function<void( uint32_t first, uint32_t last )> &newJob )
+{
+  std::unique_lock<std::mutex> lock( mutex );
+  job = &newJob;
+  busyWorkers = threadCount;
+  jobNumber++;
+  jobReady.notify_all();
+  jobDone.wait( lock, [&]() { return( !busyWorkers ); } );
+}
+
+/*--------------------------------------------------------*/
+void DUNGEON_ENV_BATCH::reset( const uint16_t seed )
+{
+  run( [&]( uint32_t first, uint32_t last )
+  {
+    for ( uint32_t n = first; n < last; n++ ) { envs[n]->reset( uint16_t( seed + n ) ); }
+  } );
+}
+
+/*--------------------------------------------------------*/
+void DUNGEON_ENV_BATCH::step( const uint8_t *actions, DUNGEON_STEP *results )
+{
+  run( [&]( uint32_t first, uint32_t last )
+  {
+    for ( uint32_t n = first; n < last; n++ ) { results[n] = envs[n]->step( actions[n] ); }
+  } );
+}
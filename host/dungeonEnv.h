@@ -0,0 +1,102 @@
+#pragma once
+
+// Environment API for automated play testing (agents, bots, search) on the host.
+//
+// A DUNGEON_ENV wraps a Dungeon instance (see DUNGEON_HOST_IO in Dungeon.h):
+//   reset( seed )    - starts a new game with the given dice seed
+//   step( action )   - performs a player action (inputs: INPUT_LEFT...), returns reward and done
+//   observeFrame()   - the last frame (128x64, 8 rows of 128 bytes like the display)
+//   observeState()   - the compact game state (DUNGEON)
+// step() runs the game until it waits for the next action again, including the frames
+// of the flashing effects. An action without effect (e.g. INPUT_NONE) doesn't change anything.
+// The game is done after the death of the player or with ITEM_VICTORY.
+//
+// Without rendering (logic only mode) renderImage() is skipped completely, only the
+// flashing effects are reset as the renderer would do. observeFrame() isn't updated then.
+// The game instance is a HOST_GAME (see hostGame.h).
+//
+// DUNGEON_ENV_BATCH steps N environments in lockstep on a thread pool, every
+// environment always runs on the same thread.
+//
+// Build (from the repository root, together with the host program):
+//   g++ -std=gnu++11 -O2 -pthread -Ihost -I. *.cpp host/hostArduino.cpp host/dungeonEnv.cpp <program>.cpp
+
+#include <Arduino.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "hostGame.h"
+
+// rewards of step()
+#define ENV_REWARD_ITEM       10   // per item found
+#define ENV_REWARD_MONSTER     5   // per monster defeated
+#define ENV_REWARD_VICTORY   100
+#define ENV_REWARD_DEATH    -100
+
+// result of step()
+class DUNGEON_STEP
+{
+public:
+  int16_t reward;
+  bool done;
+};
+
+/*--------------------------------------------------------*/
+class DUNGEON_ENV
+{
+public:
+  DUNGEON_ENV( const bool render = true );
+
+  void reset( const uint16_t seed );
+  DUNGEON_STEP step( const uint8_t action );
+
+  const uint8_t *observeFrame() const { return( game.frameBuffer ); }
+  const DUNGEON &observeState() const { return( game.dungeon._dungeon ); }
+  bool isDone() const { return( done ); }
+  // number of frames rendered since reset()
+  uint32_t getFrames() const { return( game.frames ); }
+
+private:
+  void waitForAction();
+  uint8_t getMonstersDefeated() const;
+
+  HOST_GAME game;
+  bool done;
+};
+
+/*--------------------------------------------------------*/
+class DUNGEON_ENV_BATCH
+{
+public:
+  // threads = 0: all cores
+  DUNGEON_ENV_BATCH( const uint32_t size, const unsigned threads = 0, const bool render = true );
+  ~DUNGEON_ENV_BATCH();
+
+  // environment n gets the seed 'seed + n'
+  void reset( const uint16_t seed );
+  // performs actions[n] in environment n, the results go to results[n]
+  void step( const uint8_t *actions, DUNGEON_STEP *results );
+
+  uint32_t size() const { return( uint32_t( envs.size() ) ); }
+  DUNGEON_ENV &operator[]( const uint32_t n ) { return( *envs[n] ); }
+  unsigned getThreads() const { return( threadCount ); }
+
+private:
+  // runs job( first, last ) for every thread's share of the environments and waits for all
+  void run( const std::function<void( uint32_t first, uint32_t last )> &job );
+  void worker( const unsigned thread );
+
+  std::vector<DUNGEON_ENV *> envs;
+  unsigned threadCount;
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable jobReady;
+  std::condition_variable jobDone;
+  const std::function<void( uint32_t first, uint32_t last )> *job;
+  // incremented for every job, so the workers see a new one
+  uint32_t jobNumber;
+  unsigned busyWorkers;
+  bool quit;
+};
@@ -0,0 +1,111 @@
+//
+// Steps a batch of environments (see dungeonEnv.h) with a random agent and measures the throughput.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -pthread -Ihost -I. *.cpp host/hostArduino.cpp host/dungeonEnv.cpp host/envRunner.cpp -o envRunner
+//
+// Run:
+//   ./envRunner [-e <environments>] [-s <steps>] [-j <threads>] [-n]
+//     -e <environments>  number of environments (default: 64)
+//     -s <steps>         steps per environment (default: 10000)
+//     -j <threads>       number of threads (default: all cores)
+//     -n                 logic only, no rendering
+//
+// The agent picks one of the five buttons at random for every step, finished games
+// are reset with a new seed. Report: steps per second, games, rewards and a hash over
+// all rewards and final states, which doesn't depend on the number of threads.
+//
+
+#include <Arduino.h>
+#include <chrono>
+#include "dungeonEnv.h"
+
+static const uint8_t agentActions[] = { INPUT_LEFT, INPUT_RIGHT, INPUT_UP, INPUT_DOWN, INPUT_FIRE };
+
+/*--------------------------------------------------------*/
+// FNV-1a step
+static uint32_t hashBytes( uint32_t hash, const void *data, size_t size )
+{
+  for ( size_t n = 0; n < size; n++ ) { hash = ( hash ^ ( ( const uint8_t * )data )[n] ) * 16777619UL; }
+  return( hash );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  uint32_t envCount = 64;
+  uint32_t steps = 10000;
+  unsigned threads = 0;
+  bool render = true;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-n" ) ) { render = false; }
+    else if ( !strcmp( argv[n], "-e" ) && ( n + 1 < argc ) ) { envCount = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-s" ) && ( n + 1 < argc ) ) { steps = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-j" ) && ( n + 1 < argc ) ) { threads = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-e <environments>] [-s <steps>] [-j <threads>] [-n]\n", argv[0] );
+      return( 2 );
+    }
+  }
+  if ( !envCount ) { envCount = 1; }
+
+  DUNGEON_ENV_BATCH batch( envCount, threads, render );
+  batch.reset( 1 );
+
+  std::vector<uint8_t> actions( envCount );
+  std::vector<DUNGEON_STEP> results( envCount );
+  std::vector<uint32_t> agentRandom( envCount );
+  for ( uint32_t n = 0; n < envCount; n++ ) { agentRandom[n] = n * 2654435761UL + 1; }
+
+  uint32_t games = 0, victories = 0, deaths = 0;
+  int64_t rewards = 0;
+  uint16_t nextSeed = uint16_t( envCount + 1 );
+  uint32_t hash = 2166136261UL;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for ( uint32_t step = 0; step < steps; step++ )
+  {
+    for ( uint32_t n = 0; n < envCount; n++ )
+    {
+      // xorshift32
+      agentRandom[n] ^= agentRandom[n] << 13;
+      agentRandom[n] ^= agentRandom[n] >> 17;
+      agentRandom[n] ^= agentRandom[n] << 5;
+      actions[n] = agentActions[agentRandom[n] % sizeof( agentActions )];
+    }
+
+    batch.step( actions.data(), results.data() );
+
+    for ( uint32_t n = 0; n < envCount; n++ )
+    {
+      rewards += results[n].reward;
+      hash = hashBytes( hash, &results[n].reward, sizeof( results[n].reward ) );
+      if ( results[n].done )
+      {
+        games++;
+        if ( batch[n].observeState().playerHP > 0 ) { victories++; } else { deaths++; }
+        hash = hashBytes( hash, &batch[n].observeState(), sizeof( DUNGEON ) );
+        // the seeds of the following games don't depend on the threads either
+        batch[n].reset( nextSeed++ );
+      }
+    }
+  }
+
+  double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+  const double totalSteps = double( steps ) * envCount;
+
+  printf( "%u environments, %u threads, %s\n", envCount, batch.getThreads(), render ? "rendering" : "logic only" );
+  printf( "%.0f steps in %.2f s: %.0f steps/s\n", totalSteps, time, totalSteps / time );
+  printf( "%u games finished (%u victories, %u deaths), reward per step %.4f\n", games, victories, deaths,
+          double( rewards ) / totalSteps );
+
+  // the running games count, too
+  for ( uint32_t n = 0; n < envCount; n++ ) { hash = hashBytes( hash, &batch[n].observeState(), sizeof( DUNGEON ) ); }
+  printf( "result hash: %08x\n", hash );
+
+  return( 0 );
+}
@@ -0,0 +1,303 @@
+//
+// Golden image regression check for the renderer.
+//
+// Every viewpoint (x, y, direction) of Level_1 is rendered in several game states
+// into a frame buffer, and the hash of every frame is compared with the goldens file.
+// The hash covers the content of the frame buffer (not the order the bytes were sent),
+// so the same goldens apply to page and vertical addressing, orientation kernels, PVS...
+//
+// Build (from the repository root, add the options to be checked, e.g. -D_USE_VERTICAL_ADDRESSING_):
+//   g++ -std=gnu++11 -O2 -Ihost -I. *.cpp host/hostArduino.cpp host/goldenCheck.cpp -o goldenCheck
+//
+// Run:
+//   ./goldenCheck [-g <goldens>] [-u] [-s <dir>] [-r <dir>] [-o <dir>]
+//     -g <goldens>  goldens file (default: host/goldens.txt)
+//     -u            update the goldens file instead of checking it
+//     -s <dir>      save every frame as PBM (use a known good tree for this)
+//     -r <dir>      reference frames (saved with -s) for the diff images
+//     -o <dir>      output directory for the images of mismatching frames (default: .)
+//
+// For every mismatch, <state>_<x>_<y>_<dir>.pbm is written to the output directory.
+// If the reference frame is available, <name>.expected.pbm and <name>.diff.pbm
+// (all differing pixels set) are written, too.
+// The exit code is 0 if all frames match the goldens.
+//
+
+#include <Arduino.h>
+#include "dungeon.h"
+#include "pixelSinks.h"
+
+// game state to be checked
+class GOLDEN_STATE
+{
+public:
+  const char *name;
+  // modifies the freshly initialized dungeon
+  void ( *setup )( Dungeon &dungeon );
+  // called before every frame (for effects which are reset by the renderer)
+  void ( *prepareFrame )( Dungeon &dungeon );
+};
+
+static Dungeon dungeon;
+static uint8_t frameBuffer[128 * 8];
+
+/*--------------------------------------------------------*/
+// the amulet of true sight removes all fake walls
+static void takeAmulet( Dungeon &dungeon )
+{
+  INTERACTION_INFO info;
+  memset( &info, 0, sizeof( info ) );
+  info.newItem = ITEM_AMULET;
+  dungeon.openChest( info );
+}
+
+/*--------------------------------------------------------*/
+// flips every lever of the level (by the regular interaction)
+static void flipLevers( Dungeon &dungeon )
+{
+  for ( uint16_t position = 0; position < dungeon.getLevelWidth() * dungeon.getLevelHeight(); position++ )
+  {
+    uint8_t *cell = dungeon._dungeon.currentLevel + position;
+    uint8_t cellValue = *cell;
+    if ( ( ( cellValue & OBJECT_MASK ) == LVR_LEFT ) || ( ( cellValue & OBJECT_MASK ) == LVR_RIGHT ) )
+    {
+      dungeon.playerInteraction( cell, cellValue );
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+// removes all monsters (like a won fight does)
+static void killMonsters( Dungeon &dungeon )
+{
+  MONSTER_STATS *monster = dungeon._dungeon.monsterStats;
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++, monster++ )
+  {
+    monster->hitpoints = 0;
+    dungeon._dungeon.currentLevel[monster->position] = EMPTY;
+    dungeon._dungeon.playerItems |= monster->treasureItemMask;
+  }
+  dungeon.levelModified();
+}
+
+/*--------------------------------------------------------*/
+static void solveLevel( Dungeon &dungeon )
+{
+  takeAmulet( dungeon );
+  flipLevers( dungeon );
+  killMonsters( dungeon );
+  dungeon._dungeon.playerItems |= ITEM_COMPASS | ITEM_RING | ITEM_KEY | ITEM_SWORD | ITEM_SHIELD;
+  dungeon._dungeon.playerHP = 99;
+}
+
+/*--------------------------------------------------------*/
+static void setXorEffect( Dungeon &dungeon )
+{
+  dungeon._dungeon.displayXorEffect = 0xff;
+  dungeon._dungeon.playerHP = 1;
+}
+
+/*--------------------------------------------------------*/
+static void setInvertEffects( Dungeon &dungeon )
+{
+  dungeon._dungeon.invertMonsterEffect = 0xff;
+  dungeon._dungeon.invertStatusEffect = 0xff;
+}
+
+static const GOLDEN_STATE goldenStates[] =
+{
+  { "start",    nullptr,       nullptr },
+  { "amulet",   takeAmulet,    nullptr },
+  { "levers",   flipLevers,    nullptr },
+  { "monsters", killMonsters,  nullptr },
+  { "solved",   solveLevel,    nullptr },
+  { "effects",  setXorEffect,  setInvertEffects },
+};
+
+/*--------------------------------------------------------*/
+// FNV-1a hash of the frame buffer
+static uint32_t getFrameHash( const uint8_t *buffer )
+{
+  uint32_t hash = 2166136261UL;
+  for ( uint16_t n = 0; n < sizeof( frameBuffer ); n++ )
+  {
+    hash = ( hash ^ buffer[n] ) * 16777619UL;
+  }
+  return( hash );
+}
+
+/*--------------------------------------------------------*/
+static void getFrameName( char *name, size_t size, const char *directory, const GOLDEN_STATE &state,
+                          uint8_t x, uint8_t y, uint8_t dir, const char *suffix )
+{
+  snprintf( name, size, "%s/%s_%02u_%02u_%u%s.pbm", directory, state.name, x, y, dir, suffix );
+}
+
+/*--------------------------------------------------------*/
+static bool writeFrame( const char *fileName, const uint8_t *buffer )
+{
+  FILE *file = fopen( fileName, "w" );
+  if ( !file ) { perror( fileName ); return( false ); }
+
+  fprintf( file, "P1\n128 64\n" );
+  for ( uint8_t y = 0; y < 64; y++ )
+  {
+    for ( uint8_t x = 0; x < 128; x++ )
+    {
+      fprintf( file, "%u ", ( buffer[( y / 8 ) * 128 + x] >> ( y & 7 ) ) & 1 );
+    }
+    fprintf( file, "\n" );
+  }
+  fclose( file );
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// reads a frame written by writeFrame()
+static bool readFrame( const char *fileName, uint8_t *buffer )
+{
+  FILE *file = fopen( fileName, "r" );
+  if ( !file ) { return( false ); }
+
+  unsigned width, height;
+  bool ok = ( fscanf( file, "P1 %u %u", &width, &height ) == 2 ) && ( width == 128 ) && ( height == 64 );
+
+  memset( buffer, 0, 128 * 8 );
+  for ( uint8_t y = 0; ok && ( y < 64 ); y++ )
+  {
+    for ( uint8_t x = 0; ok && ( x < 128 ); x++ )
+    {
+      unsigned pixel;
+      ok = ( fscanf( file, "%u", &pixel ) == 1 );
+      if ( pixel ) { buffer[( y / 8 ) * 128 + x] |= 1 << ( y & 7 ); }
+    }
+  }
+  fclose( file );
+  return( ok );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *goldensName = "host/goldens.txt";
+  const char *saveDirectory = nullptr;
+  const char *referenceDirectory = nullptr;
+  const char *outputDirectory = ".";
+  bool update = false;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-u" ) ) { update = true; }
+    else if ( !strcmp( argv[n], "-g" ) && ( n + 1 < argc ) ) { goldensName = argv[++n]; }
+    else if ( !strcmp( argv[n], "-s" ) && ( n + 1 < argc ) ) { saveDirectory = argv[++n]; }
+    else if ( !strcmp( argv[n], "-r" ) && ( n + 1 < argc ) ) { referenceDirectory = argv[++n]; }
+    else if ( !strcmp( argv[n], "-o" ) && ( n + 1 < argc ) ) { outputDirectory = argv[++n]; }
+    else
+    {
+      fprintf( stderr, "usage: %s [-g <goldens>] [-u] [-s <dir>] [-r <dir>] [-o <dir>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  FILE *goldens = fopen( goldensName, update ? "w" : "r" );
+  if ( !goldens ) { perror( goldensName ); return( 2 ); }
+  if ( update ) { fprintf( goldens, "# frame hashes (FNV-1a): <state> <x> <y> <direction> <hash>\n" ); }
+
+  uint32_t frameCount = 0;
+  uint32_t mismatchCount = 0;
+
+  for ( const GOLDEN_STATE &state : goldenStates )
+  {
+    uint32_t stateMismatches = 0;
+
+    for ( uint8_t y = 0; y < dungeon.getLevelHeight(); y++ )
+    {
+      for ( uint8_t x = 0; x < dungeon.getLevelWidth(); x++ )
+      {
+        for ( uint8_t dir = 0; dir < MAX_ORIENTATION; dir++ )
+        {
+          // every frame starts from the same state, so the frames don't depend on each other
+          dungeon.init();
+          if ( state.setup ) { state.setup( dungeon ); }
+          dungeon._dungeon.playerX = x;
+          dungeon._dungeon.playerY = y;
+          dungeon._dungeon.dir = dir;
+          if ( state.prepareFrame ) { state.prepareFrame( dungeon ); }
+
+          memset( frameBuffer, 0, sizeof( frameBuffer ) );
+          FRAMEBUFFER_SINK sink( frameBuffer );
+          dungeon.renderImage( sink );
+          uint32_t hash = getFrameHash( frameBuffer );
+          frameCount++;
+
+          char fileName[256];
+          if ( saveDirectory )
+          {
+            getFrameName( fileName, sizeof( fileName ), saveDirectory, state, x, y, dir, "" );
+            writeFrame( fileName, frameBuffer );
+          }
+
+          if ( update )
+          {
+            fprintf( goldens, "%s %u %u %u %08x\n", state.name, x, y, dir, hash );
+            continue;
+          }
+
+          // skip comments
+          char line[128];
+          do
+          {
+            if ( !fgets( line, sizeof( line ), goldens ) ) { line[0] = 0; break; }
+          } while ( line[0] == '#' );
+
+          char goldenName[32];
+          unsigned goldenX, goldenY, goldenDir, goldenHash;
+          if ( ( sscanf( line, "%31s %u %u %u %x", goldenName, &goldenX, &goldenY, &goldenDir, &goldenHash ) != 5 )
+            || strcmp( goldenName, state.name ) || ( goldenX != x ) || ( goldenY != y ) || ( goldenDir != dir ) )
+          {
+            fprintf( stderr, "%s: no golden for %s (%u, %u, %u) - regenerate with -u\n", goldensName, state.name, x, y, dir );
+            return( 2 );
+          }
+
+          if ( hash != goldenHash )
+          {
+            printf( "MISMATCH %s (%u, %u, %u): %08x instead of %08x\n", state.name, x, y, dir, hash, goldenHash );
+            stateMismatches++;
+
+            getFrameName( fileName, sizeof( fileName ), outputDirectory, state, x, y, dir, "" );
+            writeFrame( fileName, frameBuffer );
+
+            uint8_t expected[128 * 8];
+            char referenceName[256];
+            if ( referenceDirectory )
+            {
+              getFrameName( referenceName, sizeof( referenceName ), referenceDirectory, state, x, y, dir, "" );
+              if ( readFrame( referenceName, expected ) )
+              {
+                getFrameName( fileName, sizeof( fileName ), outputDirectory, state, x, y, dir, ".expected" );
+                writeFrame( fileName, expected );
+                for ( uint16_t n = 0; n < sizeof( expected ); n++ ) { expected[n] ^= frameBuffer[n]; }
+                getFrameName( fileName, sizeof( fileName ), outputDirectory, state, x, y, dir, ".diff" );
+                writeFrame( fileName, expected );
+              }
+            }
+          }
+        }
+      }
+    }
+
+    if ( !update ) { printf( "%-10s %s\n", state.name, stateMismatches ? "FAILED" : "ok" ); }
+    mismatchCount += stateMismatches;
+  }
+
+  fclose( goldens );
+
+  if ( update )
+  {
+    printf( "%u goldens written to %s\n", frameCount, goldensName );
+    return( 0 );
+  }
+
+  printf( "%u frames checked, %u mismatches\n", frameCount, mismatchCount );
+  return( mismatchCount ? 1 : 0 );
+}
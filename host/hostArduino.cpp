@@ -0,0 +1,74 @@
+//
+// State of the host's Arduino environment (see Arduino.h)
+//
+
+#include <Arduino.h>
+#include "Wire.h"
+#include "tinyJoypadUtils.h"
+
+// joystick centered (the TinyJoypad reads ~1023 if no direction is pressed), buttons not pressed
+HOST_THREAD_LOCAL uint16_t hostAnalogPins[HOST_PINS] = { 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+                                                         1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023 };
+HOST_THREAD_LOCAL uint8_t hostDigitalPins[HOST_PINS] = { HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+                                                         HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH };
+
+HOST_THREAD_LOCAL uint32_t hostMicros;
+HOST_THREAD_LOCAL uint32_t hostInputReleaseTime;
+HOST_THREAD_LOCAL uint32_t hostDeadline;
+HOST_THREAD_LOCAL void ( *hostDigitalWriteHook )( uint8_t pin, uint8_t value );
+HOST_THREAD_LOCAL void ( *hostDisplayHook )();
+HOST_THREAD_LOCAL void ( *hostPollHook )();
+
+FILE *hostSerialOutput;
+HOST_SERIAL Serial;
+TwoWire Wire;
+
+/*-------------------------------------------------------*/
+// joystick centered, buttons not pressed
+void hostReleaseInputs()
+{
+  for ( uint8_t pin = 0; pin < HOST_PINS; pin++ )
+  {
+    hostAnalogPins[pin] = 1023;
+    hostDigitalPins[pin] = HIGH;
+  }
+}
+
+/*-------------------------------------------------------*/
+// called before every input reading
+void hostPollInputs( const uint32_t readTime )
+{
+  hostMicros += readTime;
+  if ( hostPollHook ) { hostPollHook(); }
+
+  if ( hostInputReleaseTime && ( hostMicros >= hostInputReleaseTime ) )
+  {
+    hostReleaseInputs();
+    hostInputReleaseTime = 0;
+  }
+  if ( hostDeadline && ( hostMicros >= hostDeadline ) )
+  {
+    hostDeadline = 0;
+    throw HOST_DEADLINE_EXCEEDED();
+  }
+}
+
+/*-------------------------------------------------------*/
+void serialPrint( const unsigned long number )
+{
+#ifdef USE_SERIAL_PRINT
+  Serial.print( number );
+#else
+  (void)number;
+#endif
+}
+
+/*-------------------------------------------------------*/
+void serialPrintln( const unsigned long number )
+{
+#ifdef USE_SERIAL_PRINT
+  Serial.println( number );
+#else
+  (void)number;
+#endif
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// A game instance without display and joypad for the host tools (see DUNGEON_HOST_IO in Dungeon.h).
+//
+// The game only polls the inputs while it waits for a button to be released, so the
+// tools pass the actions directly to Dungeon::playerInput() (or use play()).
+// With rendering, every frame goes into 'frameBuffer' (128x64, 8 rows of 128 bytes like
+// the display). Without it (logic only), renderImage() just resets the flashing effects
+// like the renderer would do.
+// The instance must not be copied, the dungeon refers to its I/O.
+//
+// Used by host/dungeonEnv.cpp, host/levelSolver.cpp, host/combatSimulator.cpp,
+// host/rewindCheck.cpp and host/hotReload.cpp (header only, nothing to add to the build).
+
+#include <Arduino.h>
+#include "dungeon.h"
+#include "pixelSinks.h"
+
+/*--------------------------------------------------------*/
+class HOST_GAME
+{
+public:
+  HOST_GAME( const bool render = false ) : frames( 0 ), io(), dungeon(), render( render )
+  {
+    memset( frameBuffer, 0, sizeof( frameBuffer ) );
+    io.readInputs = readInputs;
+    io.renderFrame = renderFrame;
+    io.diceSeed = 1;
+    io.context = this;
+    dungeon._hostIO = &io;
+  }
+  HOST_GAME( const HOST_GAME & ) = delete;
+  HOST_GAME &operator=( const HOST_GAME & ) = delete;
+
+  // one action like in the game loop, returns true if it has changed the game
+  bool play( const uint8_t inputs )
+  {
+    dungeon.prepareFrame();
+    dungeon.endFlashEffect();
+    return( dungeon.playerInput( inputs ) );
+  }
+
+  // frames rendered (or skipped in logic only mode)
+  uint32_t frames;
+  DUNGEON_HOST_IO io;
+  Dungeon dungeon;
+  bool render;
+  uint8_t frameBuffer[128 * 8];
+
+private:
+  static uint8_t readInputs( Dungeon & /*dungeon*/ ) { return( INPUT_NONE ); }
+
+  static void renderFrame( Dungeon &dungeon )
+  {
+    HOST_GAME &game = *( HOST_GAME * )dungeon._hostIO->context;
+    game.frames++;
+
+    if ( game.render )
+    {
+      FRAMEBUFFER_SINK sink( game.frameBuffer );
+      dungeon.renderImage( sink );
+    }
+    else
+    {
+      // like the renderer
+      dungeon._dungeon.invertMonsterEffect = 0;
+      dungeon._dungeon.invertStatusEffect = 0;
+    }
+  }
+};
@@ -0,0 +1,210 @@
+//
+// Plays a level from a level pack (see levelPack.h) and reloads it whenever the pack changes.
+//
+// A bot plays the level in real time (random buttons, like host/batchRunner.cpp), the frames
+// go into a frame buffer. Before every frame the pack is checked for changes, a new version
+// restarts the game with the new level before the frame is rendered. Every reload is reported
+// with the time it took. Recompile the level with
+//   ./levelCompiler -p <pack> levels/Level_1.txt
+// while it's running to see it.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -Ihost -I. *.cpp host/hostArduino.cpp host/levelPack.cpp host/hotReload.cpp -o hotReload
+//
+// Run:
+//   ./hotReload [-l <level>] [-r <fps>] [-f <frames>] [-o <pbm>] <pack>
+//     -l <level>   level of the pack (default: 0)
+//     -r <fps>     frames per second (default: 30)
+//     -f <frames>  stop after this number of frames (default: never)
+//     -o <pbm>     write the first frame after every reload to this file
+//   ./hotReload -c [-l <level>] <pack>
+//     compares the level with the compiled-in tables (LevelDefinitions.h) and renders
+//     every viewpoint with both, exits with 1 on differences
+//
+
+#include <Arduino.h>
+#include <chrono>
+#include <thread>
+#include "hostGame.h"
+#include "LevelDefinitions.h"
+#include "levelPack.h"
+
+/*--------------------------------------------------------*/
+// a bot pressing random buttons (like host/batchRunner.cpp)
+class RANDOM_BOT
+{
+public:
+  RANDOM_BOT() : random( 1 ) {}
+
+  uint8_t nextInputs()
+  {
+    // xorshift32
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    const uint8_t choice = random % 100;
+    if ( choice < 40 ) { return( INPUT_UP ); }
+    if ( choice < 65 ) { return( INPUT_FIRE ); }
+    if ( choice < 80 ) { return( INPUT_LEFT ); }
+    if ( choice < 95 ) { return( INPUT_RIGHT ); }
+    return( INPUT_DOWN );
+  }
+
+private:
+  uint32_t random;
+};
+
+/*--------------------------------------------------------*/
+// one frame like in the game loop with a random action
+static void playFrame( HOST_GAME &game, RANDOM_BOT &bot )
+{
+  if ( !game.dungeon.isPlayerAlive() || ( game.dungeon._dungeon.playerItems & ITEM_VICTORY ) )
+  {
+    // next game
+    game.io.diceSeed = uint16_t( game.io.diceSeed * 40503UL ) | 1;
+    game.dungeon.init();
+  }
+  game.dungeon.prepareFrame();
+  game.dungeon.renderImage();
+  if ( !game.dungeon.endFlashEffect() ) { game.dungeon.playerInput( bot.nextInputs() ); }
+}
+
+/*--------------------------------------------------------*/
+static bool writeFrame( const char *fileName, const uint8_t *buffer )
+{
+  FILE *file = fopen( fileName, "w" );
+  if ( !file ) { perror( fileName ); return( false ); }
+
+  fprintf( file, "P1\n128 64\n" );
+  for ( uint8_t y = 0; y < 64; y++ )
+  {
+    for ( uint8_t x = 0; x < 128; x++ )
+    {
+      fprintf( file, "%u ", ( buffer[( y / 8 ) * 128 + x] >> ( y & 7 ) ) & 1 );
+    }
+    fprintf( file, "\n" );
+  }
+  fclose( file );
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// compares a level of the pack with the compiled-in one, returns the number of differences
+static uint32_t compareLevel( const LEVEL_DATA &level )
+{
+  uint32_t differences = 0;
+
+  // the tables, byte for byte
+  const bool sameStart = ( level.startX == LEVEL_START_X ) && ( level.startY == LEVEL_START_Y ) && ( level.startDir == LEVEL_START_DIR );
+  const bool sameLevel = !memcmp( level.level, Level_1, sizeof( Level_1 ) );
+  const bool sameInteractions = ( level.interactions * sizeof( INTERACTION_INFO ) == sizeof( interactionData ) )
+                             && !memcmp( level.interactionData, interactionData, sizeof( interactionData ) );
+  const bool sameSpecialCells = ( level.specialCells * sizeof( SPECIAL_CELL_INFO ) == sizeof( specialCellFX ) )
+                             && !memcmp( level.specialCellFX, specialCellFX, sizeof( specialCellFX ) );
+  const bool sameMonsters = !memcmp( level.monsterStats, monsterStats, sizeof( monsterStats ) );
+  printf( "start: %s, Level_1: %s, interactionData: %s, specialCellFX: %s, monsterStats: %s\n", sameStart ? "same" : "DIFFERENT",
+          sameLevel ? "same" : "DIFFERENT", sameInteractions ? "same" : "DIFFERENT", sameSpecialCells ? "same" : "DIFFERENT",
+          sameMonsters ? "same" : "DIFFERENT" );
+  differences += !sameStart + !sameLevel + !sameInteractions + !sameSpecialCells + !sameMonsters;
+#ifdef _USE_PRECOMPUTED_PVS_
+  const bool sameSets = !memcmp( level.potentiallyVisibleSet, levelPotentiallyVisibleSet, sizeof( levelPotentiallyVisibleSet ) );
+  printf( "levelPotentiallyVisibleSet: %s\n", sameSets ? "same" : "DIFFERENT" );
+  differences += !sameSets;
+#endif
+
+  // every viewpoint with both
+  HOST_GAME *builtin = new HOST_GAME( true );
+  HOST_GAME *packed = new HOST_GAME( true );
+  packed->dungeon._levelData = &level;
+  uint32_t frames = 0, mismatches = 0;
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    for ( uint8_t dir = 0; dir < MAX_ORIENTATION; dir++ )
+    {
+      for ( HOST_GAME *game : { builtin, packed } )
+      {
+        game->dungeon.init();
+        game->dungeon._dungeon.playerX = position % LEVEL_WIDTH;
+        game->dungeon._dungeon.playerY = position / LEVEL_WIDTH;
+        game->dungeon._dungeon.dir = dir;
+        game->dungeon.renderImage();
+      }
+      frames++;
+      if ( memcmp( builtin->frameBuffer, packed->frameBuffer, sizeof( builtin->frameBuffer ) ) ) { mismatches++; }
+    }
+  }
+  printf( "%u frames rendered with both, %u mismatches\n", frames, mismatches );
+  delete builtin;
+  delete packed;
+
+  return( differences + mismatches );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *path = nullptr;
+  const char *frameFile = nullptr;
+  unsigned level = 0;
+  unsigned fps = 30;
+  uint32_t maxFrames = 0;
+  bool compare = false;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-l" ) && ( n + 1 < argc ) ) { level = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-r" ) && ( n + 1 < argc ) ) { fps = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-f" ) && ( n + 1 < argc ) ) { maxFrames = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-o" ) && ( n + 1 < argc ) ) { frameFile = argv[++n]; }
+    else if ( !strcmp( argv[n], "-c" ) ) { compare = true; }
+    else if ( ( argv[n][0] != '-' ) && !path ) { path = argv[n]; }
+    else { path = nullptr; break; }
+  }
+  if ( !path || !fps )
+  {
+    fprintf( stderr, "usage: %s [-l <level>] [-r <fps>] [-f <frames>] [-o <pbm>] <pack>\n       %s -c [-l <level>] <pack>\n",
+             argv[0], argv[0] );
+    return( 2 );
+  }
+
+  LEVEL_PACK pack;
+  if ( !pack.open( path ) || !pack.getLevel( level ) )
+  {
+    fprintf( stderr, "*** %s\n", *pack.getError() ? pack.getError() : "there's no such level" );
+    return( 1 );
+  }
+  printf( "%s: %u levels, level %u mapped\n", path, pack.getLevelCount(), level );
+
+  if ( compare ) { return( compareLevel( *pack.getLevel( level ) ) ? 1 : 0 ); }
+
+  HOST_GAME *game = new HOST_GAME( true );
+  RANDOM_BOT bot;
+  game->dungeon._levelData = pack.getLevel( level );
+  game->dungeon.init();
+
+  const auto frameTime = std::chrono::microseconds( 1000000 / fps );
+  auto nextFrame = std::chrono::steady_clock::now();
+  for ( uint32_t frame = 0; !maxFrames || ( frame < maxFrames ); frame++ )
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const bool reloaded = pack.update( game->dungeon, uint8_t( level ) );
+    const double reloadTime = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    playFrame( *game, bot );
+
+    if ( reloaded )
+    {
+      const double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+      printf( "frame %u: %s reloaded (%u levels) in %.0f us, first frame after %.0f us (budget %.0f us)\n", frame, path,
+              pack.getLevelCount(), 1e6 * reloadTime, 1e6 * time, 1e6 / fps );
+      fflush( stdout );
+      if ( frameFile ) { writeFrame( frameFile, game->frameBuffer ); }
+    }
+
+    nextFrame += frameTime;
+    std::this_thread::sleep_until( nextFrame );
+  }
+
+  delete game;
+  return( 0 );
+}
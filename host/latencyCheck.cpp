@@ -0,0 +1,226 @@
+//
+// Button to photon latency of the game logic.
+//
+// From every free cell and direction of Level_1, every possible input is injected
+// (turn, step, blocked step, attack, lever) and checkPlayerMovement() and the following
+// renderImage() are run like in the game loop. The report shows the latency distribution
+// per action type:
+//   frame - input to the transfer of the resulting frame to the display
+//   sound - input to the first sound output (the only feedback of a blocked step)
+//
+// The time is simulated (see host/Arduino.h): the sound effects and their delays,
+// the waiting loops and the ADC conversions are counted, the computations are not.
+// Use the simavr harness (simavr/tinyDungeonSim.c) for cycle exact numbers of the real firmware.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -Ihost -I. *.cpp host/hostArduino.cpp host/latencyCheck.cpp -o latencyCheck
+//
+// Run:
+//   ./latencyCheck [-p <ms>] [-t <ms>]
+//     -p <ms>  duration of a button press (default: 100 ms)
+//     -t <ms>  latency target: the exit code is 1 if the worst case latency
+//              of any action type (frame, or sound if there is no frame) exceeds it
+//
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <algorithm>
+#include <vector>
+#include "dungeon.h"
+
+// joystick readings (see isLeftPressed() and friends in TinyJoypadUtils.cpp)
+#define JOYSTICK_HIGH  850   // left or down
+#define JOYSTICK_LOW   625   // right or up
+
+// the game waits for input after the action, so it's stopped after this time
+#define DEADLINE_US  ( 3 * 1000000UL )
+#define NO_TIME      0xffffffffUL
+
+// action types
+enum
+{
+  ACTION_TURN = 0,
+  ACTION_STEP,
+  ACTION_BLOCKED_STEP,
+  ACTION_ATTACK,
+  ACTION_LEVER,
+  ACTION_TYPES,
+};
+
+static const char *actionNames[ACTION_TYPES] = { "turn", "step", "blocked", "attack", "lever" };
+
+// latencies of an action type [us]
+class ACTION_LATENCIES
+{
+public:
+  std::vector<uint32_t> frame;
+  std::vector<uint32_t> sound;
+  uint32_t samples;
+};
+
+static Dungeon dungeon;
+static ACTION_LATENCIES latencies[ACTION_TYPES];
+static uint32_t firstFrameTime;
+static uint32_t firstSoundTime;
+
+/*--------------------------------------------------------*/
+static void displayHook()
+{
+  if ( firstFrameTime == NO_TIME ) { firstFrameTime = hostMicros; }
+}
+
+/*--------------------------------------------------------*/
+static void digitalWriteHook( uint8_t pin, uint8_t value )
+{
+  if ( ( pin == SOUND_PIN ) && value && ( firstSoundTime == NO_TIME ) ) { firstSoundTime = hostMicros; }
+}
+
+/*--------------------------------------------------------*/
+// injects an input at viewpoint (x, y, dir) and records the latencies
+static void measureAction( const uint8_t actionType, const int8_t x, const int8_t y, const uint8_t dir,
+                           const uint8_t inputPin, const uint16_t inputValue, const uint32_t pressTime )
+{
+  dungeon.init();
+  dungeon._dungeon.playerX = x;
+  dungeon._dungeon.playerY = y;
+  dungeon._dungeon.dir = dir;
+
+  // the frame before the action (as in the game loop)
+  hostReleaseInputs();
+  dungeon.renderImage();
+
+  // press...
+  hostMicros = 0;
+  firstFrameTime = NO_TIME;
+  firstSoundTime = NO_TIME;
+  if ( inputPin == FIRE_BUTTON ) { hostDigitalPins[inputPin] = LOW; }
+  else { hostAnalogPins[inputPin] = inputValue; }
+  // ...and release
+  hostInputReleaseTime = pressTime;
+  hostDeadline = DEADLINE_US;
+
+  try
+  {
+    dungeon.checkPlayerMovement();
+    dungeon.renderImage();
+  }
+  catch ( HOST_DEADLINE_EXCEEDED & )
+  {
+    // still waiting for input (e.g. after a blocked step)
+  }
+  hostDeadline = 0;
+  hostInputReleaseTime = 0;
+
+  ACTION_LATENCIES &action = latencies[actionType];
+  action.samples++;
+  if ( firstFrameTime != NO_TIME ) { action.frame.push_back( firstFrameTime ); }
+  if ( firstSoundTime != NO_TIME ) { action.sound.push_back( firstSoundTime ); }
+}
+
+/*--------------------------------------------------------*/
+// returns the percentile of sorted values [us]
+static uint32_t getPercentile( const std::vector<uint32_t> &values, const unsigned percentile )
+{
+  return( values[( values.size() - 1 ) * percentile / 100] );
+}
+
+/*--------------------------------------------------------*/
+static void printDistribution( const char *name, std::vector<uint32_t> &values )
+{
+  if ( values.empty() )
+  {
+    printf( "  %-6s -\n", name );
+    return;
+  }
+  std::sort( values.begin(), values.end() );
+
+  uint64_t sum = 0;
+  for ( uint32_t value : values ) { sum += value; }
+
+  printf( "  %-6s min %7.1f  p50 %7.1f  p90 %7.1f  p99 %7.1f  max %7.1f  mean %7.1f ms\n", name,
+          values.front() / 1000.0, getPercentile( values, 50 ) / 1000.0, getPercentile( values, 90 ) / 1000.0,
+          getPercentile( values, 99 ) / 1000.0, values.back() / 1000.0, sum / 1000.0 / values.size() );
+
+  // histogram with 20 ms buckets
+  const uint32_t bucketSize = 20000;
+  for ( uint32_t bucket = values.front() / bucketSize; bucket <= values.back() / bucketSize; bucket++ )
+  {
+    size_t count = std::count_if( values.begin(), values.end(), [&]( uint32_t value ) { return( value / bucketSize == bucket ); } );
+    if ( !count ) { continue; }
+    printf( "         %4u-%4u ms %5zu ", bucket * 20, bucket * 20 + 19, count );
+    for ( size_t n = 0; n < ( count * 50 + values.size() - 1 ) / values.size(); n++ ) { putchar( '#' ); }
+    printf( "\n" );
+  }
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  uint32_t pressTime = 100000;
+  uint32_t target = 0;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-p" ) && ( n + 1 < argc ) ) { pressTime = atoi( argv[++n] ) * 1000UL; }
+    else if ( !strcmp( argv[n], "-t" ) && ( n + 1 < argc ) ) { target = atoi( argv[++n] ) * 1000UL; }
+    else
+    {
+      fprintf( stderr, "usage: %s [-p <ms>] [-t <ms>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  hostDisplayHook = displayHook;
+  hostDigitalWriteHook = digitalWriteHook;
+
+  for ( int8_t y = 0; y < dungeon.getLevelHeight(); y++ )
+  {
+    for ( int8_t x = 0; x < dungeon.getLevelWidth(); x++ )
+    {
+      for ( uint8_t dir = 0; dir < MAX_ORIENTATION; dir++ )
+      {
+        dungeon.init();
+        // only cells the player can stand on
+        if ( *dungeon.getCellRaw( x, y, 0, 0, dir ) & FLAG_SOLID ) { continue; }
+
+        const uint8_t front = *dungeon.getCellRaw( x, y, +1, 0, dir );
+        const uint8_t back = *dungeon.getCellRaw( x, y, -1, 0, dir );
+
+        measureAction( ACTION_TURN, x, y, dir, LEFT_RIGHT_BUTTON, JOYSTICK_HIGH, pressTime );
+        measureAction( ACTION_TURN, x, y, dir, LEFT_RIGHT_BUTTON, JOYSTICK_LOW, pressTime );
+        measureAction( ( front & FLAG_SOLID ) ? ACTION_BLOCKED_STEP : ACTION_STEP, x, y, dir, UP_DOWN_BUTTON, JOYSTICK_LOW, pressTime );
+        measureAction( ( back & FLAG_SOLID ) ? ACTION_BLOCKED_STEP : ACTION_STEP, x, y, dir, UP_DOWN_BUTTON, JOYSTICK_HIGH, pressTime );
+
+        if ( front & FLAG_MONSTER )
+        {
+          measureAction( ACTION_ATTACK, x, y, dir, FIRE_BUTTON, 0, pressTime );
+        }
+        else if ( ( ( front & OBJECT_MASK ) == LVR_LEFT ) || ( ( front & OBJECT_MASK ) == LVR_RIGHT ) )
+        {
+          measureAction( ACTION_LEVER, x, y, dir, FIRE_BUTTON, 0, pressTime );
+        }
+      }
+    }
+  }
+
+  printf( "button to photon latency (button pressed for %u ms, computation time not included)\n", pressTime / 1000 );
+
+  bool targetMissed = false;
+  for ( uint8_t actionType = 0; actionType < ACTION_TYPES; actionType++ )
+  {
+    ACTION_LATENCIES &action = latencies[actionType];
+    printf( "%s: %u samples, %zu with a frame\n", actionNames[actionType], action.samples, action.frame.size() );
+    printDistribution( "frame", action.frame );
+    printDistribution( "sound", action.sound );
+
+    // worst case of the visible (or at least audible) feedback
+    const std::vector<uint32_t> &feedback = action.frame.empty() ? action.sound : action.frame;
+    if ( target && !feedback.empty() && ( feedback.back() > target ) )
+    {
+      printf( "  *** latency target of %u ms missed\n", target / 1000 );
+      targetMissed = true;
+    }
+  }
+
+  return( targetMissed ? 1 : 0 );
+}
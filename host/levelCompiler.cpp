@@ -0,0 +1,1052 @@
+//
+// Compiles a level description (a text file, see levels/Level_1.txt) into LevelDefinitions.h.
+//
+// The description has a map with one character per cell and tables for the monsters, the
+// interactions (levers, chests, doors, the fountain) and the special cells (teleporters,
+// spinners), all with x/y coordinates. The compiler checks that everything fits together
+// (monsters on monster cells, levers not pointing at walls, interactions which can match at
+// all, teleporters to passable cells...) and writes the PROGMEM tables of the game in their
+// usual format, plus the data derived from them:
+//   - LEVEL_START_X/Y/DIR for Dungeon::init()
+//   - the potentially visible sets of every cell and direction (levelPotentiallyVisibleSet[],
+//     used with _USE_PRECOMPUTED_PVS_), calculated by the engine with every cell open which
+//     can ever be opened, so they hold for every state of the level
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -D_USE_POTENTIALLY_VISIBLE_SET_ -Ihost -I. *.cpp host/hostArduino.cpp host/levelCompiler.cpp -o levelCompiler
+//
+// Run:
+//   ./levelCompiler [-o <header>] [-p <pack>] <level>   compile the level (default output: the header on stdout)
+//   ./levelCompiler -p <pack> <level>...                 a level pack for the host build (see host/levelPack.h)
+//   ./levelCompiler -d                                   print the tables of this build's LevelDefinitions.h as a level
+//
+// Report (stderr): errors and warnings with line numbers, the table sizes and whether
+// the tables are the same as the ones of this build. Returns 1 if there are errors.
+//
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdarg>
+#include <string>
+#include <vector>
+#include "dungeon.h"
+#include "LevelDefinitions.h"
+#include "levelPack.h"
+
+#ifndef _USE_POTENTIALLY_VISIBLE_SET_
+  #error "Please compile with -D_USE_POTENTIALLY_VISIBLE_SET_ (the engine calculates the sets)"
+#endif
+
+// what the renderer treats as a wall (see Dungeon::calculateVisibleCells())
+#define isWallCell( value )  ( ( ( value ) & WALL_MASK ) == ( WALL & ~FLAG_SOLID ) )
+
+static const char *itemNames[8] = { "compass", "amulet", "ring", "key", "potion", "sword", "shield", "victory" };
+static const char *itemSymbols[8] = { "ITEM_COMPASS", "ITEM_AMULET", "ITEM_RING", "ITEM_KEY", "ITEM_POTION", "ITEM_SWORD",
+                                      "ITEM_SHIELD", "ITEM_VICTORY" };
+static const char *dirNames[MAX_ORIENTATION] = { "north", "east", "south", "west" };
+static const char *dirSymbols[MAX_ORIENTATION] = { "NORTH", "EAST", "SOUTH", "WEST" };
+
+// a character of the map
+class CELL_SYMBOL
+{
+public:
+  char symbol;
+  uint8_t value;
+  // in the generated table
+  const char *name;
+};
+
+static const CELL_SYMBOL cellSymbols[] =
+{
+  { '.', EMPTY,                       "0"              },
+  { '#', WALL,                        "WALL"           },
+  { 'f', FAKE_WALL,                   "FAKE_WALL"      },
+  { 'D', WALL | DOOR,                 "WALL|DOOR"      },
+  { '<', WALL | LVR_LEFT,             "WALL|LVR_LEFT"  },
+  { '>', WALL | LVR_RIGHT,            "WALL|LVR_RIGHT" },
+  { '=', BARS,                        "BARS"           },
+  { 'c', CLOSED_CHEST,                "CLOSED_CHEST"   },
+  { 'o', OPEN_CHEST,                  "OPEN_CHEST"     },
+  { 'F', FOUNTAIN,                    "FOUNTAIN"       },
+  // empty cells, the contents come from the tables
+  { 'r', RAT,                         "/*RAT*/ 0"      },
+  { 's', SKELETON,                    "/*SKELETON*/ 0" },
+  { 'b', BEHOLDER,                    "/*BEHOLDER*/ 0" },
+  { 'm', MIMIC,                       "/*MIMIC*/ 0"    },
+  { 'T', TELEPORTER,                  "/*TELEPORT*/ 0" },
+  { 'S', SPINNER,                     "/*SPINNER*/ 0"  },
+};
+#define FIRST_TABLE_SYMBOL  10
+
+// names of cell values (interactions)
+class VALUE_NAME
+{
+public:
+  uint8_t value;
+  const char *name;
+};
+
+static const VALUE_NAME valueNames[] =
+{
+  { EMPTY, "EMPTY" }, { WALL, "WALL" }, { FAKE_WALL, "FAKE_WALL" }, { DOOR, "DOOR" }, { LVR_LEFT, "LVR_LEFT" },
+  { LVR_RIGHT, "LVR_RIGHT" }, { CLOSED_CHEST, "CLOSED_CHEST" }, { OPEN_CHEST, "OPEN_CHEST" }, { FOUNTAIN, "FOUNTAIN" },
+  { BARS, "BARS" },
+};
+
+static const VALUE_NAME monsterNames[] =
+{
+  { RAT, "rat" }, { SKELETON, "skeleton" }, { BEHOLDER, "beholder" }, { MIMIC, "mimic" },
+};
+
+/*--------------------------------------------------------*/
+// the level as described
+class LEVEL_DESCRIPTION
+{
+public:
+  LEVEL_DESCRIPTION() : name( "Level_1" ), startX( 1 ), startY( 1 ), startDir( EAST ), rows( 0 )
+  {
+    memset( cells, EMPTY, sizeof( cells ) );
+    memset( symbols, '.', sizeof( symbols ) );
+  }
+
+  std::string name;
+  uint8_t startX, startY, startDir;
+  uint8_t cells[MAX_LEVEL_BYTES];
+  char symbols[MAX_LEVEL_BYTES];
+  uint8_t rows;
+  std::vector<INTERACTION_INFO> interactions;
+  std::vector<SPECIAL_CELL_INFO> specialCells;
+  std::vector<MONSTER_STATS> monsters;
+  // source lines of the table entries
+  std::vector<int> interactionLines, specialCellLines, monsterLines;
+};
+
+static const char *fileName = "";
+static int errors = 0;
+static int warnings = 0;
+
+/*--------------------------------------------------------*/
+static void error( const int line, const char *format, ... )
+{
+  va_list args;
+  va_start( args, format );
+  // line 0: the level as a whole
+  if ( line ) { fprintf( stderr, "%s:%d: error: ", fileName, line ); }
+  else { fprintf( stderr, "%s: error: ", fileName ); }
+  vfprintf( stderr, format, args );
+  fprintf( stderr, "\n" );
+  va_end( args );
+  errors++;
+}
+
+/*--------------------------------------------------------*/
+static void warning( const int line, const char *format, ... )
+{
+  va_list args;
+  va_start( args, format );
+  // line 0: the level as a whole
+  if ( line ) { fprintf( stderr, "%s:%d: warning: ", fileName, line ); }
+  else { fprintf( stderr, "%s: warning: ", fileName ); }
+  vfprintf( stderr, format, args );
+  fprintf( stderr, "\n" );
+  va_end( args );
+  warnings++;
+}
+
+/*--------------------------------------------------------*/
+static std::string trim( const std::string &text )
+{
+  const size_t first = text.find_first_not_of( " \t\r\n" );
+  if ( first == std::string::npos ) { return( "" ); }
+  return( text.substr( first, text.find_last_not_of( " \t\r\n" ) - first + 1 ) );
+}
+
+/*--------------------------------------------------------*/
+static std::vector<std::string> split( const std::string &text, const char *separators )
+{
+  std::vector<std::string> tokens;
+  size_t position = 0;
+  for ( ;; )
+  {
+    position = text.find_first_not_of( separators, position );
+    if ( position == std::string::npos ) { return( tokens ); }
+    const size_t end = text.find_first_of( separators, position );
+    tokens.push_back( text.substr( position, end - position ) );
+    if ( end == std::string::npos ) { return( tokens ); }
+    position = end;
+  }
+}
+
+/*--------------------------------------------------------*/
+static bool parseNumber( const std::string &text, const long minValue, const long maxValue, long &value )
+{
+  char *end;
+  value = strtol( text.c_str(), &end, 0 );
+  return( !text.empty() && !*end && ( value >= minValue ) && ( value <= maxValue ) );
+}
+
+/*--------------------------------------------------------*/
+// a position from two tokens
+static bool parsePosition( const int line, const std::string &x, const std::string &y, uint8_t &position )
+{
+  long valueX, valueY;
+  if ( !parseNumber( x, 0, LEVEL_WIDTH - 1, valueX ) || !parseNumber( y, 0, LEVEL_HEIGHT - 1, valueY ) )
+  {
+    error( line, "invalid position (%s, %s)", x.c_str(), y.c_str() );
+    return( false );
+  }
+  position = uint8_t( valueX + valueY * LEVEL_WIDTH );
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// a cell value like "LVR_LEFT", "WALL|DOOR" or "0x58"
+static bool parseValue( const int line, const std::string &text, uint8_t &value )
+{
+  value = 0;
+  for ( const std::string &token : split( text, "|" ) )
+  {
+    bool found = false;
+    for ( const VALUE_NAME &name : valueNames )
+    {
+      if ( token == name.name ) { value |= name.value; found = true; }
+    }
+    long number;
+    if ( !found && parseNumber( token, 0, 255, number ) ) { value |= uint8_t( number ); found = true; }
+    if ( !found )
+    {
+      error( line, "unknown cell value '%s'", token.c_str() );
+      return( false );
+    }
+  }
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// items like "key|compass" or "-"
+static bool parseItems( const int line, const std::string &text, uint8_t &items )
+{
+  items = 0;
+  if ( text == "-" ) { return( true ); }
+  for ( const std::string &token : split( text, "|" ) )
+  {
+    bool found = false;
+    for ( uint8_t item = 0; item < 8; item++ )
+    {
+      if ( token == itemNames[item] ) { items |= 1 << item; found = true; }
+    }
+    if ( !found )
+    {
+      error( line, "unknown item '%s'", token.c_str() );
+      return( false );
+    }
+  }
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+static const CELL_SYMBOL *findSymbol( const char symbol )
+{
+  for ( const CELL_SYMBOL &cellSymbol : cellSymbols ) { if ( cellSymbol.symbol == symbol ) { return( &cellSymbol ); } }
+  return( nullptr );
+}
+
+/*--------------------------------------------------------*/
+static bool readLevel( const char *path, LEVEL_DESCRIPTION &level )
+{
+  FILE *file = fopen( path, "r" );
+  if ( !file )
+  {
+    fprintf( stderr, "*** can't open %s\n", path );
+    return( false );
+  }
+
+  std::string section;
+  char buffer[1024];
+  int line = 0;
+
+  while ( fgets( buffer, sizeof( buffer ), file ) )
+  {
+    line++;
+    std::string text( buffer );
+    // ';' starts a comment ('#' is a wall)
+    if ( text.find( ';' ) != std::string::npos ) { text.erase( text.find( ';' ) ); }
+    text = trim( text );
+    if ( text.empty() ) { continue; }
+
+    if ( text[0] == '[' )
+    {
+      section = trim( text.substr( 1, text.find( ']' ) - 1 ) );
+      if ( ( section != "level" ) && ( section != "map" ) && ( section != "monsters" ) && ( section != "interactions" )
+        && ( section != "teleporters" ) && ( section != "spinners" ) )
+      {
+        error( line, "unknown section [%s]", section.c_str() );
+      }
+      continue;
+    }
+
+    const std::vector<std::string> tokens = split( text, " \t" );
+
+    if ( section == "level" )
+    {
+      const size_t equals = text.find( '=' );
+      const std::string key = trim( text.substr( 0, equals ) );
+      const std::vector<std::string> values = split( ( equals == std::string::npos ) ? "" : text.substr( equals + 1 ), " \t" );
+      if ( ( key == "name" ) && ( values.size() == 1 ) )
+      {
+        level.name = values[0];
+      }
+      else if ( ( key == "start" ) && ( values.size() == 3 ) )
+      {
+        uint8_t position;
+        if ( parsePosition( line, values[0], values[1], position ) )
+        {
+          level.startX = position % LEVEL_WIDTH;
+          level.startY = position / LEVEL_WIDTH;
+        }
+        level.startDir = MAX_ORIENTATION;
+        for ( uint8_t dir = 0; dir < MAX_ORIENTATION; dir++ ) { if ( values[2] == dirNames[dir] ) { level.startDir = dir; } }
+        if ( level.startDir == MAX_ORIENTATION )
+        {
+          error( line, "unknown direction '%s'", values[2].c_str() );
+          level.startDir = EAST;
+        }
+      }
+      else
+      {
+        error( line, "expected 'name = <name>' or 'start = <x> <y> <direction>'" );
+      }
+    }
+    else if ( section == "map" )
+    {
+      if ( level.rows >= LEVEL_HEIGHT ) { error( line, "more than %u rows", LEVEL_HEIGHT ); continue; }
+      if ( text.size() != LEVEL_WIDTH ) { error( line, "%zu cells instead of %u", text.size(), LEVEL_WIDTH ); }
+      for ( uint8_t x = 0; ( x < LEVEL_WIDTH ) && ( x < text.size() ); x++ )
+      {
+        const uint8_t position = x + level.rows * LEVEL_WIDTH;
+        const CELL_SYMBOL *symbol = findSymbol( text[x] );
+        if ( !symbol )
+        {
+          error( line, "unknown cell '%c' at (%u, %u)", text[x], x, level.rows );
+          continue;
+        }
+        level.symbols[position] = symbol->symbol;
+        level.cells[position] = ( symbol >= cellSymbols + FIRST_TABLE_SYMBOL ) ? uint8_t( EMPTY ) : symbol->value;
+      }
+      level.rows++;
+    }
+    else if ( section == "monsters" )
+    {
+      // x y type hp damage first treasure
+      MONSTER_STATS monster;
+      long hitpoints, damage;
+      if ( tokens.size() != 7 )
+      {
+        error( line, "expected: <x> <y> <type> <hp> <damage> <yes|no> <treasure>" );
+        continue;
+      }
+      if ( !parsePosition( line, tokens[0], tokens[1], monster.position ) ) { continue; }
+      monster.monsterType = EMPTY;
+      for ( const VALUE_NAME &name : monsterNames ) { if ( tokens[2] == name.name ) { monster.monsterType = name.value; } }
+      if ( monster.monsterType == EMPTY ) { error( line, "unknown monster '%s'", tokens[2].c_str() ); continue; }
+      if ( !parseNumber( tokens[3], 1, 127, hitpoints ) ) { error( line, "hit points must be 1..127" ); continue; }
+      if ( !parseNumber( tokens[4], -128, 127, damage ) ) { error( line, "invalid damage bonus '%s'", tokens[4].c_str() ); continue; }
+      if ( ( tokens[5] != "yes" ) && ( tokens[5] != "no" ) ) { error( line, "attacks first: 'yes' or 'no'" ); continue; }
+      if ( !parseItems( line, tokens[6], monster.treasureItemMask ) ) { continue; }
+      monster.hitpoints = int8_t( hitpoints );
+      monster.damageBonus = int8_t( damage );
+      monster.attacksFirst = ( tokens[5] == "yes" );
+      level.monsters.push_back( monster );
+      level.monsterLines.push_back( line );
+    }
+    else if ( section == "interactions" )
+    {
+      // x y status next items targetX targetY value
+      INTERACTION_INFO info;
+      if ( tokens.size() != 8 )
+      {
+        error( line, "expected: <x> <y> <status> <next status> <items> <target x> <target y> <target value>" );
+        continue;
+      }
+      if ( !parsePosition( line, tokens[0], tokens[1], info.currentPosition )
+        || !parseValue( line, tokens[2], info.currentStatus ) || !parseValue( line, tokens[3], info.nextStatus )
+        || !parseItems( line, tokens[4], info.newItem ) || !parsePosition( line, tokens[5], tokens[6], info.modifiedPosition )
+        || !parseValue( line, tokens[7], info.modifiedPositionCellValue ) )
+      {
+        continue;
+      }
+      level.interactions.push_back( info );
+      level.interactionLines.push_back( line );
+    }
+    else if ( section == "teleporters" )
+    {
+      // x y targetX targetY
+      SPECIAL_CELL_INFO info;
+      uint8_t target;
+      if ( tokens.size() != 4 ) { error( line, "expected: <x> <y> <target x> <target y>" ); continue; }
+      if ( !parsePosition( line, tokens[0], tokens[1], info.position ) || !parsePosition( line, tokens[2], tokens[3], target ) )
+      {
+        continue;
+      }
+      info.specialFX = TELEPORTER;
+      info.value_1 = target % LEVEL_WIDTH;
+      info.value_2 = target / LEVEL_WIDTH;
+      level.specialCells.push_back( info );
+      level.specialCellLines.push_back( line );
+    }
+    else if ( section == "spinners" )
+    {
+      // x y turn
+      SPECIAL_CELL_INFO info;
+      long turn;
+      if ( tokens.size() != 3 ) { error( line, "expected: <x> <y> <turn (+1..+3)>" ); continue; }
+      if ( !parsePosition( line, tokens[0], tokens[1], info.position ) ) { continue; }
+      if ( !parseNumber( tokens[2], 1, 3, turn ) ) { error( line, "the turn must be +1..+3 (quarter turns to the right)" ); continue; }
+      info.specialFX = SPINNER;
+      info.value_1 = uint8_t( turn );
+      info.value_2 = 0;
+      level.specialCells.push_back( info );
+      level.specialCellLines.push_back( line );
+    }
+    else
+    {
+      error( line, "data outside of a section" );
+    }
+  }
+  fclose( file );
+
+  if ( level.rows != LEVEL_HEIGHT ) { error( line, "the map has %u rows instead of %u", level.rows, LEVEL_HEIGHT ); }
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+static bool isPassable( const uint8_t value )
+{
+  return( ( value & FLAG_SOLID ) != FLAG_SOLID );
+}
+
+/*--------------------------------------------------------*/
+static bool addValue( std::vector<uint8_t> &cell, const uint8_t value )
+{
+  if ( std::find( cell.begin(), cell.end(), value ) != cell.end() ) { return( false ); }
+  cell.push_back( value );
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+// all values a cell can have, as far as the interactions can tell
+static void getPossibleValues( const LEVEL_DESCRIPTION &level, std::vector<std::vector<uint8_t>> &values )
+{
+  values.assign( MAX_LEVEL_BYTES, std::vector<uint8_t>() );
+  for ( uint16_t n = 0; n < MAX_LEVEL_BYTES; n++ ) { values[n].push_back( level.cells[n] ); }
+  // a monster leaves an empty cell
+  for ( const MONSTER_STATS &monster : level.monsters ) { values[monster.position].assign( { monster.monsterType, EMPTY } ); }
+
+  bool changed = true;
+  while ( changed )
+  {
+    changed = false;
+    for ( const INTERACTION_INFO &info : level.interactions )
+    {
+      std::vector<uint8_t> &cell = values[info.currentPosition];
+      for ( size_t n = 0; n < cell.size(); n++ )
+      {
+        if ( ( cell[n] & OBJECT_MASK ) != info.currentStatus ) { continue; }
+        // like Dungeon::playerInteraction()
+        changed |= addValue( cell, uint8_t( ( cell[n] - info.currentStatus ) | info.nextStatus ) );
+        if ( info.currentStatus == DOOR ) { changed |= addValue( cell, EMPTY ); }
+        changed |= addValue( values[info.modifiedPosition], info.modifiedPositionCellValue );
+        // the amulet removes all fake walls (see Dungeon::openChest())
+        if ( info.newItem == ITEM_AMULET )
+        {
+          for ( std::vector<uint8_t> &other : values )
+          {
+            if ( std::find( other.begin(), other.end(), FAKE_WALL ) != other.end() ) { changed |= addValue( other, EMPTY ); }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+#define X( position )  unsigned( ( position ) % LEVEL_WIDTH )
+#define Y( position )  unsigned( ( position ) / LEVEL_WIDTH )
+
+static void validateLevel( LEVEL_DESCRIPTION &level )
+{
+  const uint8_t start = level.startX + level.startY * LEVEL_WIDTH;
+  if ( !isPassable( level.cells[start] ) || ( level.symbols[start] != '.' ) )
+  {
+    error( 0, "the start (%u, %u) isn't an empty cell", level.startX, level.startY );
+  }
+
+  // monsters
+  if ( level.monsters.size() != MAX_MONSTERS )
+  {
+    error( 0, "%zu monsters, but MAX_MONSTERS (dungeonTypes.h) is %u", level.monsters.size(), MAX_MONSTERS );
+  }
+  for ( size_t n = 0; n < level.monsters.size(); n++ )
+  {
+    const MONSTER_STATS &monster = level.monsters[n];
+    const CELL_SYMBOL *symbol = findSymbol( level.symbols[monster.position] );
+    // a monster may guard a special cell, its effect starts after the fight
+    if ( ( symbol->value != monster.monsterType ) && ( symbol->symbol != 'T' ) && ( symbol->symbol != 'S' ) )
+    {
+      error( level.monsterLines[n], "the monster at (%u, %u) is on a '%c' cell (%s)", X( monster.position ), Y( monster.position ),
+             symbol->symbol, symbol->name );
+    }
+    for ( size_t other = 0; other < n; other++ )
+    {
+      if ( level.monsters[other].position == monster.position )
+      {
+        error( level.monsterLines[n], "a second monster at (%u, %u)", X( monster.position ), Y( monster.position ) );
+      }
+    }
+  }
+
+  // special cells
+  for ( size_t n = 0; n < level.specialCells.size(); n++ )
+  {
+    const SPECIAL_CELL_INFO &info = level.specialCells[n];
+    const char symbol = ( info.specialFX == TELEPORTER ) ? 'T' : 'S';
+    if ( level.symbols[info.position] != symbol )
+    {
+      error( level.specialCellLines[n], "(%u, %u) isn't a '%c' cell", X( info.position ), Y( info.position ), symbol );
+    }
+    if ( info.specialFX == TELEPORTER )
+    {
+      const uint8_t target = info.value_1 + info.value_2 * LEVEL_WIDTH;
+      bool monster = false;
+      for ( const MONSTER_STATS &stats : level.monsters ) { if ( stats.position == target ) { monster = true; } }
+      if ( !isPassable( level.cells[target] ) || monster )
+      {
+        error( level.specialCellLines[n], "the teleporter at (%u, %u) leads into the solid cell (%u, %u)", X( info.position ),
+               Y( info.position ), info.value_1, info.value_2 );
+      }
+      if ( ( level.symbols[target] == 'T' ) || ( level.symbols[target] == 'S' ) )
+      {
+        warning( level.specialCellLines[n], "the teleporter at (%u, %u) leads onto another special cell (it has no effect there)",
+                 X( info.position ), Y( info.position ) );
+      }
+    }
+    for ( size_t other = 0; other < n; other++ )
+    {
+      if ( level.specialCells[other].position == info.position )
+      {
+        error( level.specialCellLines[n], "a second special cell at (%u, %u)", X( info.position ), Y( info.position ) );
+      }
+    }
+  }
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    if ( ( level.symbols[position] != 'T' ) && ( level.symbols[position] != 'S' ) ) { continue; }
+    bool found = false;
+    for ( const SPECIAL_CELL_INFO &info : level.specialCells ) { if ( info.position == position ) { found = true; } }
+    if ( !found ) { error( 0, "the '%c' cell at (%u, %u) has no entry", level.symbols[position], X( position ), Y( position ) ); }
+  }
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    const CELL_SYMBOL *symbol = findSymbol( level.symbols[position] );
+    if ( ( symbol < cellSymbols + FIRST_TABLE_SYMBOL ) || !( symbol->value & FLAG_MONSTER ) ) { continue; }
+    bool found = false;
+    for ( const MONSTER_STATS &monster : level.monsters ) { if ( monster.position == position ) { found = true; } }
+    if ( !found ) { error( 0, "the monster cell '%c' at (%u, %u) has no entry", level.symbols[position], X( position ), Y( position ) ); }
+  }
+
+  // interactions
+  std::vector<std::vector<uint8_t>> values;
+  getPossibleValues( level, values );
+  std::vector<bool> hasInteraction( MAX_LEVEL_BYTES, false );
+  for ( size_t n = 0; n < level.interactions.size(); n++ )
+  {
+    const INTERACTION_INFO &info = level.interactions[n];
+    const int line = level.interactionLines[n];
+
+    bool canMatch = false;
+    for ( const uint8_t value : values[info.currentPosition] ) { if ( ( value & OBJECT_MASK ) == info.currentStatus ) { canMatch = true; } }
+    if ( !canMatch )
+    {
+      // dead data, dropped
+      warning( line, "the interaction at (%u, %u) is never done (the cell is never 0x%02x), it's left out", X( info.currentPosition ),
+               Y( info.currentPosition ), info.currentStatus );
+      level.interactions.erase( level.interactions.begin() + n );
+      level.interactionLines.erase( level.interactionLines.begin() + n );
+      n--;
+      continue;
+    }
+    hasInteraction[info.currentPosition] = true;
+
+    // opening a wall is fine (secret passages), but turning it into bars or another lever is a wrong target
+    if ( ( level.cells[info.modifiedPosition] == WALL ) && !isPassable( info.modifiedPositionCellValue ) )
+    {
+      error( line, "the interaction at (%u, %u) points at the wall at (%u, %u)", X( info.currentPosition ), Y( info.currentPosition ),
+             X( info.modifiedPosition ), Y( info.modifiedPosition ) );
+    }
+    bool monster = false;
+    for ( const MONSTER_STATS &stats : level.monsters ) { if ( stats.position == info.modifiedPosition ) { monster = true; } }
+    if ( monster )
+    {
+      error( line, "the interaction at (%u, %u) changes the monster at (%u, %u)", X( info.currentPosition ), Y( info.currentPosition ),
+             X( info.modifiedPosition ), Y( info.modifiedPosition ) );
+    }
+    for ( size_t other = 0; other < n; other++ )
+    {
+      if ( ( level.interactions[other].currentPosition == info.currentPosition ) && ( level.interactions[other].currentStatus == info.currentStatus ) )
+      {
+        warning( line, "a second interaction for (%u, %u) in the same state (both are done)", X( info.currentPosition ),
+                 Y( info.currentPosition ) );
+      }
+    }
+    // sorted tables can be searched faster
+    if ( n && ( level.interactions[n - 1].currentPosition > info.currentPosition ) )
+    {
+      warning( line, "the interactions aren't sorted by position" );
+    }
+  }
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    const char symbol = level.symbols[position];
+    if ( !hasInteraction[position] && ( ( symbol == '<' ) || ( symbol == '>' ) || ( symbol == 'c' ) || ( symbol == 'D' ) || ( symbol == 'F' ) ) )
+    {
+      warning( 0, "the '%c' cell at (%u, %u) has no interaction", symbol, X( position ), Y( position ) );
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+// the potentially visible sets with every cell open which can be opened
+static void calculatePotentiallyVisibleSets( const LEVEL_DESCRIPTION &level, std::vector<uint16_t> &sets )
+{
+  std::vector<std::vector<uint8_t>> values;
+  getPossibleValues( level, values );
+
+  Dungeon *dungeon = new Dungeon();
+  DUNGEON &state = dungeon->_dungeon;
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    state.currentLevel[position] = level.cells[position];
+    for ( const uint8_t value : values[position] ) { if ( !isWallCell( value ) ) { state.currentLevel[position] = EMPTY; } }
+  }
+
+  sets.resize( MAX_LEVEL_BYTES * MAX_ORIENTATION );
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    for ( uint8_t dir = 0; dir < MAX_ORIENTATION; dir++ )
+    {
+      state.playerX = position % LEVEL_WIDTH;
+      state.playerY = position / LEVEL_WIDTH;
+      state.dir = dir;
+      sets[position * MAX_ORIENTATION + dir] = dungeon->calculateVisibleCells();
+    }
+  }
+  delete dungeon;
+}
+
+/*--------------------------------------------------------*/
+static std::string getValueName( const uint8_t value )
+{
+  if ( value == EMPTY ) { return( "0" ); }
+  for ( const VALUE_NAME &name : valueNames ) { if ( name.value == value ) { return( name.name ); } }
+  for ( const CELL_SYMBOL &symbol : cellSymbols ) { if ( symbol.value == value ) { return( symbol.name ); } }
+  char text[8];
+  snprintf( text, sizeof( text ), "0x%02x", value );
+  return( text );
+}
+
+/*--------------------------------------------------------*/
+static std::string getItemSymbols( const uint8_t items )
+{
+  std::string text;
+  for ( uint8_t item = 0; item < 8; item++ )
+  {
+    if ( !( items & ( 1 << item ) ) ) { continue; }
+    if ( !text.empty() ) { text += " | "; }
+    text += itemSymbols[item];
+  }
+  return( text.empty() ? "0" : text );
+}
+
+/*--------------------------------------------------------*/
+static std::string getPositionText( const uint8_t position )
+{
+  char text[32];
+  snprintf( text, sizeof( text ), "%2u + %2u * LEVEL_WIDTH", X( position ), Y( position ) );
+  return( text );
+}
+
+/*--------------------------------------------------------*/
+static void writeHeader( FILE *file, const LEVEL_DESCRIPTION &level, const char *source, const std::vector<uint16_t> &sets )
+{
+  fprintf( file, "#pragma once\n\n" );
+  fprintf( file, "// Generated by host/levelCompiler.cpp from %s - please edit the level there!\n\n", source );
+  fprintf( file, "#include <Arduino.h>\n#include \"dungeonTypes.h\"\n#include \"externBitmaps.h\"\n\n" );
+
+  fprintf( file, "// start of the player\n" );
+  fprintf( file, "#define LEVEL_START_X    %u\n", level.startX );
+  fprintf( file, "#define LEVEL_START_Y    %u\n", level.startY );
+  fprintf( file, "#define LEVEL_START_DIR  %s\n\n", dirSymbols[level.startDir] );
+
+  fprintf( file, "// simple level - 1 byte per cell\n" );
+  fprintf( file, "const uint8_t %s[] PROGMEM = \n{\n/*      ", level.name.c_str() );
+  for ( uint8_t x = 0; x < LEVEL_WIDTH; x++ ) { fprintf( file, "%9u       ", x ); }
+  fprintf( file, " */\n" );
+  for ( uint8_t y = 0; y < LEVEL_HEIGHT; y++ )
+  {
+    fprintf( file, "/* %2u */ ", y );
+    for ( uint8_t x = 0; x < LEVEL_WIDTH; x++ )
+    {
+      const uint8_t position = x + y * LEVEL_WIDTH;
+      const CELL_SYMBOL *symbol = findSymbol( level.symbols[position] );
+      std::string name = symbol->name;
+      if ( ( x == level.startX ) && ( y == level.startY ) ) { name = "/*START*/ 0"; }
+      fprintf( file, "%14s, ", name.c_str() );
+    }
+    fprintf( file, "/* %2u */\n", y );
+  }
+  fprintf( file, "};\n\n" );
+
+  fprintf( file, "// interaction data (6 bytes per event)\n" );
+  fprintf( file, "const INTERACTION_INFO interactionData[] PROGMEM =\n{\n" );
+  fprintf( file, "  // currentPos            currentStatus  nextStatus     newItem                        modifiedPos            modifiedPosCellValue\n" );
+  for ( const INTERACTION_INFO &info : level.interactions )
+  {
+    fprintf( file, "  { %s, %-12s , %-12s , %-28s , %s, %-12s },\n", getPositionText( info.currentPosition ).c_str(),
+             getValueName( info.currentStatus ).c_str(), getValueName( info.nextStatus ).c_str(),
+             getItemSymbols( info.newItem ).c_str(), getPositionText( info.modifiedPosition ).c_str(),
+             getValueName( info.modifiedPositionCellValue ).c_str() );
+  }
+  fprintf( file, "};\n\n" );
+
+  fprintf( file, "// special cell effects (4 bytes per FX)\n" );
+  fprintf( file, "const SPECIAL_CELL_INFO specialCellFX[] PROGMEM =\n{\n" );
+  fprintf( file, "  // cell type , position              , value_1, value_2\n" );
+  for ( const SPECIAL_CELL_INFO &info : level.specialCells )
+  {
+    if ( info.specialFX == TELEPORTER )
+    {
+      fprintf( file, "  { TELEPORTER , %s,   %2u   ,   %2u    },\n", getPositionText( info.position ).c_str(), info.value_1, info.value_2 );
+    }
+    else
+    {
+      fprintf( file, "  { SPINNER    , %s,   %+2d   ,    0    },\n", getPositionText( info.position ).c_str(), info.value_1 );
+    }
+  }
+  fprintf( file, "};\n\n" );
+
+  fprintf( file, "// monster stats (6 bytes per monster - must fit into RAM - or EEPROM?)\n" );
+  fprintf( file, "const MONSTER_STATS monsterStats[MAX_MONSTERS] PROGMEM =\n{\n" );
+  fprintf( file, "  // position            monsterType  hp  bonusDamage  attacksFirst  treasureItemMask\n" );
+  for ( const MONSTER_STATS &monster : level.monsters )
+  {
+    const char *name = "";
+    for ( const VALUE_NAME &monsterName : monsterNames ) { if ( monsterName.value == monster.monsterType ) { name = monsterName.name; } }
+    std::string type = getValueName( monster.monsterType );
+    type = type.substr( 2, type.find( '*', 2 ) - 2 );
+    fprintf( file, "  { %s, %-10s , %3d ,    %+3d     ,      %u       , %-42s }, // %s\n", getPositionText( monster.position ).c_str(),
+             type.c_str(), monster.hitpoints, monster.damageBonus, monster.attacksFirst, getItemSymbols( monster.treasureItemMask ).c_str(),
+             name );
+  }
+  fprintf( file, "};\n\n" );
+
+  fprintf( file, "#ifdef _USE_PRECOMPUTED_PVS_\n" );
+  fprintf( file, "// potentially visible sets for every cell and direction (see Dungeon::calculateVisibleCells()),\n" );
+  fprintf( file, "// calculated with every cell open which can be opened, so they are valid in every state\n" );
+  fprintf( file, "const uint16_t levelPotentiallyVisibleSet[MAX_LEVEL_BYTES * MAX_ORIENTATION] PROGMEM =\n{\n" );
+  for ( size_t n = 0; n < sets.size(); n++ )
+  {
+    fprintf( file, "%s0x%04x,%s", ( n % 16 ) ? " " : "  ", sets[n], ( n % 16 == 15 ) ? "\n" : "" );
+  }
+  fprintf( file, "};\n#endif\n" );
+}
+
+/*--------------------------------------------------------*/
+static void writeLevel( FILE *file, const LEVEL_DESCRIPTION &level )
+{
+  fprintf( file, "; Tiny Dungeon level, compiled into LevelDefinitions.h by host/levelCompiler.cpp\n" );
+  fprintf( file, ";\n" );
+  fprintf( file, "; Map: one character per cell, x from left to right, y from top to bottom\n" );
+  fprintf( file, ";   .  empty         #  wall         f  fake wall    D  door (wall)    <  >  lever left/right (wall)\n" );
+  fprintf( file, ";   =  bars          c  closed chest o  open chest   F  fountain\n" );
+  fprintf( file, ";   r  s  b  m  rat, skeleton, beholder, mimic ([monsters])\n" );
+  fprintf( file, ";   T  teleporter ([teleporters])            S  spinner ([spinners])\n" );
+  fprintf( file, "; Cell values: EMPTY, WALL, FAKE_WALL, DOOR, LVR_LEFT, LVR_RIGHT, CLOSED_CHEST, OPEN_CHEST,\n" );
+  fprintf( file, ";   FOUNTAIN, BARS, numbers, combined with '|'\n" );
+  fprintf( file, "; Items: compass, amulet, ring, key, potion, sword, shield, victory, combined with '|', or '-'\n\n" );
+
+  fprintf( file, "[level]\n" );
+  fprintf( file, "name  = %s\n", level.name.c_str() );
+  fprintf( file, "start = %u %u %s\n\n", level.startX, level.startY, dirNames[level.startDir] );
+
+  fprintf( file, "[map]\n;      " );
+  for ( uint8_t x = 0; x < LEVEL_WIDTH; x++ ) { fprintf( file, "%x", x ); }
+  fprintf( file, "\n" );
+  for ( uint8_t y = 0; y < LEVEL_HEIGHT; y++ )
+  {
+    fprintf( file, "        %.*s  ; %2u\n", LEVEL_WIDTH, level.symbols + y * LEVEL_WIDTH, y );
+  }
+
+  fprintf( file, "\n[monsters]\n; x   y   type       hp  damage  first  treasure\n" );
+  for ( const MONSTER_STATS &monster : level.monsters )
+  {
+    const char *name = "";
+    for ( const VALUE_NAME &monsterName : monsterNames ) { if ( monsterName.value == monster.monsterType ) { name = monsterName.name; } }
+    std::string treasure;
+    for ( uint8_t item = 0; item < 8; item++ )
+    {
+      if ( !( monster.treasureItemMask & ( 1 << item ) ) ) { continue; }
+      treasure += ( treasure.empty() ? "" : "|" ) + std::string( itemNames[item] );
+    }
+    fprintf( file, " %2u  %2u   %-9s %3d    %+3d    %-4s   %s\n", X( monster.position ), Y( monster.position ), name,
+             monster.hitpoints, monster.damageBonus, monster.attacksFirst ? "yes" : "no", treasure.empty() ? "-" : treasure.c_str() );
+  }
+
+  fprintf( file, "\n[interactions]\n; x   y   status        next          items               target x y  value\n" );
+  for ( const INTERACTION_INFO &info : level.interactions )
+  {
+    std::string items;
+    for ( uint8_t item = 0; item < 8; item++ )
+    {
+      if ( !( info.newItem & ( 1 << item ) ) ) { continue; }
+      items += ( items.empty() ? "" : "|" ) + std::string( itemNames[item] );
+    }
+    std::string next = getValueName( info.nextStatus ), value = getValueName( info.modifiedPositionCellValue );
+    if ( next == "0" ) { next = "EMPTY"; }
+    if ( value == "0" ) { value = "EMPTY"; }
+    fprintf( file, " %2u  %2u   %-12s  %-12s  %-18s  %2u %2u      %s\n", X( info.currentPosition ), Y( info.currentPosition ),
+             getValueName( info.currentStatus ).c_str(), next.c_str(), items.empty() ? "-" : items.c_str(),
+             X( info.modifiedPosition ), Y( info.modifiedPosition ), value.c_str() );
+  }
+
+  fprintf( file, "\n[teleporters]\n; x   y   target x y\n" );
+  for ( const SPECIAL_CELL_INFO &info : level.specialCells )
+  {
+    if ( info.specialFX == TELEPORTER ) { fprintf( file, " %2u  %2u   %2u %2u\n", X( info.position ), Y( info.position ), info.value_1, info.value_2 ); }
+  }
+  fprintf( file, "\n[spinners]\n; x   y   turn (quarter turns to the right)\n" );
+  for ( const SPECIAL_CELL_INFO &info : level.specialCells )
+  {
+    if ( info.specialFX == SPINNER ) { fprintf( file, " %2u  %2u   %+d\n", X( info.position ), Y( info.position ), info.value_1 ); }
+  }
+}
+
+/*--------------------------------------------------------*/
+// the tables of this build (LevelDefinitions.h) as a level description
+static bool getBuiltinLevel( LEVEL_DESCRIPTION &level )
+{
+#ifdef LEVEL_START_X
+  level.startX = LEVEL_START_X;
+  level.startY = LEVEL_START_Y;
+  level.startDir = LEVEL_START_DIR;
+#endif
+  level.interactions.assign( interactionData, interactionData + sizeof( interactionData ) / sizeof( interactionData[0] ) );
+  level.specialCells.assign( specialCellFX, specialCellFX + sizeof( specialCellFX ) / sizeof( specialCellFX[0] ) );
+  level.monsters.assign( monsterStats, monsterStats + MAX_MONSTERS );
+  level.rows = LEVEL_HEIGHT;
+
+  bool valid = true;
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    const CELL_SYMBOL *symbol = nullptr;
+    for ( uint8_t n = 0; n < FIRST_TABLE_SYMBOL; n++ ) { if ( cellSymbols[n].value == Level_1[position] ) { symbol = cellSymbols + n; } }
+    if ( !symbol )
+    {
+      fprintf( stderr, "*** no symbol for the cell value 0x%02x at (%u, %u)\n", Level_1[position], X( position ), Y( position ) );
+      valid = false;
+      continue;
+    }
+    level.cells[position] = symbol->value;
+    level.symbols[position] = symbol->symbol;
+  }
+  // the cell under a monster is overwritten by Dungeon::init()
+  for ( const MONSTER_STATS &monster : level.monsters )
+  {
+    level.cells[monster.position] = EMPTY;
+    for ( uint8_t n = FIRST_TABLE_SYMBOL; n < sizeof( cellSymbols ) / sizeof( cellSymbols[0] ); n++ )
+    {
+      if ( cellSymbols[n].value == monster.monsterType ) { level.symbols[monster.position] = cellSymbols[n].symbol; }
+    }
+  }
+  for ( const SPECIAL_CELL_INFO &info : level.specialCells )
+  {
+    level.symbols[info.position] = ( info.specialFX == TELEPORTER ) ? 'T' : 'S';
+  }
+  return( valid );
+}
+
+/*--------------------------------------------------------*/
+// the level like Dungeon::init() sets it up
+static void getInitialLevel( const uint8_t *cells, const MONSTER_STATS *monsters, uint8_t *level )
+{
+  memcpy( level, cells, MAX_LEVEL_BYTES );
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ ) { level[monsters[n].position] = monsters[n].monsterType; }
+}
+
+/*--------------------------------------------------------*/
+// compares the tables with the ones of this build
+static void compareTables( const LEVEL_DESCRIPTION &level )
+{
+  std::string differences;
+  if ( level.monsters.size() == MAX_MONSTERS )
+  {
+    uint8_t compiled[MAX_LEVEL_BYTES], builtin[MAX_LEVEL_BYTES];
+    getInitialLevel( level.cells, level.monsters.data(), compiled );
+    getInitialLevel( Level_1, monsterStats, builtin );
+    if ( memcmp( compiled, builtin, MAX_LEVEL_BYTES ) ) { differences += " level"; }
+    if ( memcmp( level.monsters.data(), monsterStats, sizeof( monsterStats ) ) ) { differences += " monsterStats"; }
+  }
+  else
+  {
+    differences += " level monsterStats";
+  }
+  if ( ( level.interactions.size() * sizeof( INTERACTION_INFO ) != sizeof( interactionData ) )
+    || memcmp( level.interactions.data(), interactionData, sizeof( interactionData ) ) )
+  {
+    differences += " interactionData";
+  }
+  if ( ( level.specialCells.size() * sizeof( SPECIAL_CELL_INFO ) != sizeof( specialCellFX ) )
+    || memcmp( level.specialCells.data(), specialCellFX, sizeof( specialCellFX ) ) )
+  {
+    differences += " specialCellFX";
+  }
+  const uint8_t start = level.startX + level.startY * LEVEL_WIDTH;
+#ifdef LEVEL_START_X
+  if ( ( start != LEVEL_START_X + LEVEL_START_Y * LEVEL_WIDTH ) || ( level.startDir != LEVEL_START_DIR ) ) { differences += " start"; }
+#else
+  if ( ( start != 1 + 1 * LEVEL_WIDTH ) || ( level.startDir != EAST ) ) { differences += " start"; }
+#endif
+
+  if ( differences.empty() ) { fprintf( stderr, "the game data is the same as in this build's LevelDefinitions.h\n" ); }
+  else { fprintf( stderr, "different from this build's LevelDefinitions.h:%s\n", differences.c_str() ); }
+}
+
+/*--------------------------------------------------------*/
+// a level pack for the host build (see host/levelPack.h): the same bytes as the PROGMEM tables
+static bool writePack( const char *path, const std::vector<LEVEL_DESCRIPTION> &levels, const std::vector<std::vector<uint16_t>> &sets )
+{
+  // written under another name first, so a running game never maps a half written pack
+  const std::string temporaryPath = std::string( path ) + ".tmp";
+  FILE *file = fopen( temporaryPath.c_str(), "wb" );
+  if ( !file )
+  {
+    fprintf( stderr, "*** can't write %s\n", temporaryPath.c_str() );
+    return( false );
+  }
+
+  LEVEL_PACK_HEADER header;
+  memcpy( header.magic, LEVEL_PACK_MAGIC, sizeof( header.magic ) );
+  header.version = LEVEL_PACK_VERSION;
+  header.levels = uint8_t( levels.size() );
+  header.levelWidth = LEVEL_WIDTH;
+  header.levelHeight = LEVEL_HEIGHT;
+  fwrite( &header, sizeof( header ), 1, file );
+
+  for ( size_t n = 0; n < levels.size(); n++ )
+  {
+    const LEVEL_DESCRIPTION &level = levels[n];
+    LEVEL_PACK_ENTRY entry;
+    entry.startX = level.startX;
+    entry.startY = level.startY;
+    entry.startDir = level.startDir;
+    entry.interactions = uint8_t( level.interactions.size() );
+    entry.specialCells = uint8_t( level.specialCells.size() );
+    entry.monsters = uint8_t( level.monsters.size() );
+    entry.size = getLevelPackTablesSize( entry.interactions, entry.specialCells );
+    fwrite( &entry, sizeof( entry ), 1, file );
+
+    const long start = ftell( file );
+    fwrite( level.cells, MAX_LEVEL_BYTES, 1, file );
+    fwrite( level.interactions.data(), sizeof( INTERACTION_INFO ), level.interactions.size(), file );
+    fwrite( level.specialCells.data(), sizeof( SPECIAL_CELL_INFO ), level.specialCells.size(), file );
+    fwrite( level.monsters.data(), sizeof( MONSTER_STATS ), level.monsters.size(), file );
+    if ( ( ftell( file ) - start ) & 1 ) { fputc( 0, file ); }
+    fwrite( sets[n].data(), sizeof( uint16_t ), sets[n].size(), file );
+  }
+
+  const bool written = !ferror( file );
+  if ( ( fclose( file ) != 0 ) || !written || rename( temporaryPath.c_str(), path ) )
+  {
+    fprintf( stderr, "*** can't write %s\n", path );
+    remove( temporaryPath.c_str() );
+    return( false );
+  }
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *output = nullptr;
+  const char *pack = nullptr;
+  std::vector<const char *> inputs;
+  bool dump = false;
+  bool usage = false;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-o" ) && ( n + 1 < argc ) ) { output = argv[++n]; }
+    else if ( !strcmp( argv[n], "-p" ) && ( n + 1 < argc ) ) { pack = argv[++n]; }
+    else if ( !strcmp( argv[n], "-d" ) ) { dump = true; }
+    else if ( argv[n][0] != '-' ) { inputs.push_back( argv[n] ); }
+    else { usage = true; }
+  }
+  // the header holds one level, a pack any number
+  if ( usage || ( dump == !inputs.empty() ) || ( ( inputs.size() > 1 ) && ( output || !pack ) ) || ( inputs.size() > 255 ) )
+  {
+    fprintf( stderr, "usage: %s [-o <header>] [-p <pack>] <level>\n       %s -p <pack> <level>...\n       %s -d\n", argv[0],
+             argv[0], argv[0] );
+    return( 2 );
+  }
+
+  if ( dump )
+  {
+    LEVEL_DESCRIPTION level;
+    if ( !getBuiltinLevel( level ) ) { return( 1 ); }
+    writeLevel( stdout, level );
+    return( 0 );
+  }
+
+  std::vector<LEVEL_DESCRIPTION> levels( inputs.size() );
+  std::vector<std::vector<uint16_t>> sets( inputs.size() );
+  for ( size_t n = 0; n < inputs.size(); n++ )
+  {
+    LEVEL_DESCRIPTION &level = levels[n];
+    const int lastWarnings = warnings;
+    fileName = inputs[n];
+    if ( !readLevel( inputs[n], level ) ) { return( 1 ); }
+    if ( !errors ) { validateLevel( level ); }
+    if ( errors )
+    {
+      fprintf( stderr, "%d errors, %d warnings\n", errors, warnings );
+      return( 1 );
+    }
+    calculatePotentiallyVisibleSets( level, sets[n] );
+
+    fprintf( stderr, "%s: %d warnings\n", inputs[n], warnings - lastWarnings );
+    fprintf( stderr, "%s %u bytes, interactionData %zu bytes (%zu), specialCellFX %zu bytes (%zu), monsterStats %zu bytes (%zu),\n"
+                     "levelPotentiallyVisibleSet %zu bytes (with _USE_PRECOMPUTED_PVS_ or in a pack)\n",
+             level.name.c_str(), MAX_LEVEL_BYTES, level.interactions.size() * sizeof( INTERACTION_INFO ), level.interactions.size(),
+             level.specialCells.size() * sizeof( SPECIAL_CELL_INFO ), level.specialCells.size(),
+             level.monsters.size() * sizeof( MONSTER_STATS ), level.monsters.size(), sets[n].size() * sizeof( uint16_t ) );
+    compareTables( level );
+  }
+
+  if ( output || !pack )
+  {
+    FILE *file = output ? fopen( output, "w" ) : stdout;
+    if ( !file )
+    {
+      fprintf( stderr, "*** can't write %s\n", output );
+      return( 1 );
+    }
+    writeHeader( file, levels[0], inputs[0], sets[0] );
+    if ( output ) { fclose( file ); }
+  }
+  if ( pack )
+  {
+    if ( !writePack( pack, levels, sets ) ) { return( 1 ); }
+    fprintf( stderr, "%s: %zu levels\n", pack, levels.size() );
+  }
+
+  return( 0 );
+}
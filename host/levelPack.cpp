@@ -0,0 +1,195 @@
+//
+// Level packs for the host build, see levelPack.h for details.
+//
+
+#include <cstdarg>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "levelPack.h"
+
+/*--------------------------------------------------------*/
+LEVEL_PACK::LEVEL_PACK() : data( nullptr ), size( 0 )
+{
+  memset( &fileKey, 0, sizeof( fileKey ) );
+  memset( &failedKey, 0, sizeof( failedKey ) );
+}
+
+/*--------------------------------------------------------*/
+LEVEL_PACK::~LEVEL_PACK()
+{
+  close();
+}
+
+/*--------------------------------------------------------*/
+void LEVEL_PACK::close()
+{
+  if ( data ) { munmap( data, size ); }
+  data = nullptr;
+  size = 0;
+  levels.clear();
+}
+
+/*--------------------------------------------------------*/
+bool LEVEL_PACK::setError( const char *format, ... )
+{
+  char text[256];
+  va_list args;
+  va_start( args, format );
+  vsnprintf( text, sizeof( text ), format, args );
+  va_end( args );
+  error = text;
+  return( false );
+}
+
+/*--------------------------------------------------------*/
+bool LEVEL_PACK::getFileKey( const char *path, FILE_KEY &key )
+{
+  struct stat info;
+  memset( &key, 0, sizeof( key ) );
+  if ( stat( path, &info ) ) { return( false ); }
+  key.device = info.st_dev;
+  key.inode = info.st_ino;
+  key.size = info.st_size;
+  key.modified = int64_t( info.st_mtim.tv_sec ) * 1000000000 + info.st_mtim.tv_nsec;
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+bool LEVEL_PACK::open( const char *newPath )
+{
+  FILE_KEY key;
+  const int file = ::open( newPath, O_RDONLY );
+  struct stat info;
+  if ( ( file < 0 ) || fstat( file, &info ) )
+  {
+    if ( file >= 0 ) { ::close( file ); }
+    getFileKey( newPath, failedKey );
+    return( setError( "%s: %s", newPath, strerror( errno ) ) );
+  }
+  memset( &key, 0, sizeof( key ) );
+  key.device = info.st_dev;
+  key.inode = info.st_ino;
+  key.size = info.st_size;
+  key.modified = int64_t( info.st_mtim.tv_sec ) * 1000000000 + info.st_mtim.tv_nsec;
+
+  const size_t newSize = size_t( info.st_size );
+  void *newData = ( newSize >= sizeof( LEVEL_PACK_HEADER ) ) ? mmap( nullptr, newSize, PROT_READ, MAP_PRIVATE, file, 0 ) : MAP_FAILED;
+  ::close( file );
+  if ( newData == MAP_FAILED )
+  {
+    failedKey = key;
+    return( setError( "%s: can't map %zu bytes", newPath, newSize ) );
+  }
+
+  // check the header and the tables
+  const uint8_t *bytes = ( const uint8_t * )newData;
+  const LEVEL_PACK_HEADER &header = *( const LEVEL_PACK_HEADER * )bytes;
+  std::vector<LEVEL_DATA> newLevels;
+  bool valid = true;
+
+  if ( memcmp( header.magic, LEVEL_PACK_MAGIC, sizeof( header.magic ) ) || ( header.version != LEVEL_PACK_VERSION ) )
+  {
+    valid = setError( "%s: not a level pack (version %u)", newPath, LEVEL_PACK_VERSION );
+  }
+  else if ( ( header.levelWidth != LEVEL_WIDTH ) || ( header.levelHeight != LEVEL_HEIGHT ) || !header.levels )
+  {
+    valid = setError( "%s: %u levels of %ux%u cells, the game has %ux%u", newPath, header.levels, header.levelWidth,
+                      header.levelHeight, LEVEL_WIDTH, LEVEL_HEIGHT );
+  }
+
+  size_t offset = sizeof( LEVEL_PACK_HEADER );
+  for ( uint8_t n = 0; valid && ( n < header.levels ); n++ )
+  {
+    if ( offset + sizeof( LEVEL_PACK_ENTRY ) > newSize )
+    {
+      valid = setError( "%s: level %u is missing", newPath, n );
+      break;
+    }
+    const LEVEL_PACK_ENTRY &entry = *( const LEVEL_PACK_ENTRY * )( bytes + offset );
+    offset += sizeof( LEVEL_PACK_ENTRY );
+
+    if ( ( entry.monsters != MAX_MONSTERS ) || ( entry.size != getLevelPackTablesSize( entry.interactions, entry.specialCells ) )
+      || ( offset + entry.size > newSize ) )
+    {
+      valid = setError( "%s: level %u is broken (%u monsters, %u of %zu bytes)", newPath, n, entry.monsters, entry.size,
+                        newSize - offset );
+      break;
+    }
+    if ( ( entry.startX >= LEVEL_WIDTH ) || ( entry.startY >= LEVEL_HEIGHT ) || ( entry.startDir >= MAX_ORIENTATION ) )
+    {
+      valid = setError( "%s: level %u starts at (%u, %u) dir %u", newPath, n, entry.startX, entry.startY, entry.startDir );
+      break;
+    }
+
+    // the tables, used in place
+    LEVEL_DATA level;
+    const uint8_t *table = bytes + offset;
+    level.level = table;
+    table += MAX_LEVEL_BYTES;
+    level.interactionData = ( const INTERACTION_INFO * )table;
+    table += entry.interactions * sizeof( INTERACTION_INFO );
+    level.specialCellFX = ( const SPECIAL_CELL_INFO * )table;
+    table += entry.specialCells * sizeof( SPECIAL_CELL_INFO );
+    level.monsterStats = ( const MONSTER_STATS * )table;
+    table += MAX_MONSTERS * sizeof( MONSTER_STATS );
+    level.potentiallyVisibleSet = ( const uint16_t * )( bytes + ( ( table - bytes + 1 ) & ~1 ) );
+    level.interactions = entry.interactions;
+    level.specialCells = entry.specialCells;
+    level.startX = entry.startX;
+    level.startY = entry.startY;
+    level.startDir = entry.startDir;
+
+    // teleporters must stay in the level
+    for ( uint8_t cell = 0; cell < entry.specialCells; cell++ )
+    {
+      const SPECIAL_CELL_INFO &info = level.specialCellFX[cell];
+      if ( ( info.specialFX == TELEPORTER ) && ( ( info.value_1 >= LEVEL_WIDTH ) || ( info.value_2 >= LEVEL_HEIGHT ) ) )
+      {
+        valid = setError( "%s: level %u: teleporter to (%u, %u)", newPath, n, info.value_1, info.value_2 );
+      }
+    }
+    newLevels.push_back( level );
+    offset += entry.size;
+  }
+  if ( valid && ( offset != newSize ) )
+  {
+    valid = setError( "%s: %zu bytes after the last level", newPath, newSize - offset );
+  }
+
+  if ( !valid )
+  {
+    munmap( newData, newSize );
+    failedKey = key;
+    return( false );
+  }
+
+  // replace the current pack
+  close();
+  path = newPath;
+  data = newData;
+  size = newSize;
+  fileKey = key;
+  levels.swap( newLevels );
+  error.clear();
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+bool LEVEL_PACK::update( Dungeon &dungeon, const uint8_t level )
+{
+  FILE_KEY key;
+  if ( path.empty() || !getFileKey( path.c_str(), key ) || ( key == fileKey ) || ( key == failedKey ) ) { return( false ); }
+
+  // the old mapping is gone after open(), so the dungeon switches over right here
+  const std::string currentPath = path;
+  if ( !open( currentPath.c_str() ) )
+  {
+    fprintf( stderr, "*** %s, keeping the current level\n", getError() );
+    return( false );
+  }
+  dungeon._levelData = getLevel( level ) ? getLevel( level ) : getLevel( 0 );
+  dungeon.init();
+  return( true );
+}
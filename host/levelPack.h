@@ -0,0 +1,113 @@
+#pragma once
+
+// Level packs for the host build: the level tables in a binary file, so the level content
+// can be changed without compiling the game again.
+//
+// A pack holds the tables of LevelDefinitions.h byte for byte as the level compiler writes
+// them into PROGMEM (host/levelCompiler.cpp -p <pack>), one level after another.
+// LEVEL_PACK maps the file into memory and points the LEVEL_DATA of every level right into
+// the mapping, nothing is copied. A Dungeon uses a level with '_levelData = pack.getLevel( n )'
+// before init().
+//
+// Hot reload: update( dungeon ) (once per frame) checks the file for changes. A changed file
+// is mapped again and the game restarts with the new level before the next frame; a file which
+// can't be used is reported and the game goes on with the old one. Write new packs to a temporary
+// file and rename it (like the level compiler does), so the mapped file is never half written.
+//
+// Format (little endian like the MCUs, all tables start at even offsets):
+//   LEVEL_PACK_HEADER
+//   per level:
+//     LEVEL_PACK_ENTRY
+//     Level_N[MAX_LEVEL_BYTES]
+//     interactionData[interactions]
+//     specialCellFX[specialCells]
+//     monsterStats[MAX_MONSTERS]
+//     (a padding byte if the size so far is odd)
+//     levelPotentiallyVisibleSet[MAX_LEVEL_BYTES * MAX_ORIENTATION]
+//
+// Build (from the repository root, together with the host program):
+//   g++ -std=gnu++11 -O2 -Ihost -I. *.cpp host/hostArduino.cpp host/levelPack.cpp <program>.cpp
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "dungeon.h"
+
+#define LEVEL_PACK_MAGIC    "TDLP"
+#define LEVEL_PACK_VERSION  1
+
+class LEVEL_PACK_HEADER
+{
+public:
+  char magic[4];
+  uint8_t version;
+  uint8_t levels;
+  uint8_t levelWidth;
+  uint8_t levelHeight;
+};
+
+class LEVEL_PACK_ENTRY
+{
+public:
+  uint8_t startX;
+  uint8_t startY;
+  uint8_t startDir;
+  uint8_t interactions;
+  uint8_t specialCells;
+  uint8_t monsters;
+  // bytes of the tables after the entry
+  uint16_t size;
+};
+
+/*--------------------------------------------------------*/
+// size of the tables of a level (without the entry)
+inline uint16_t getLevelPackTablesSize( const uint8_t interactions, const uint8_t specialCells )
+{
+  uint16_t size = MAX_LEVEL_BYTES + interactions * sizeof( INTERACTION_INFO ) + specialCells * sizeof( SPECIAL_CELL_INFO )
+                + MAX_MONSTERS * sizeof( MONSTER_STATS );
+  return( ( ( size + 1 ) & ~1 ) + MAX_LEVEL_BYTES * MAX_ORIENTATION * sizeof( uint16_t ) );
+}
+
+/*--------------------------------------------------------*/
+class LEVEL_PACK
+{
+public:
+  LEVEL_PACK();
+  ~LEVEL_PACK();
+
+  // maps the pack, the current one stays if the file can't be used (see getError())
+  bool open( const char *path );
+  void close();
+
+  uint8_t getLevelCount() const { return( uint8_t( levels.size() ) ); }
+  const LEVEL_DATA *getLevel( const uint8_t n ) const { return( ( n < levels.size() ) ? &levels[n] : nullptr ); }
+  const char *getError() const { return( error.c_str() ); }
+
+  // hot reload: if the file has changed, maps it again and restarts 'dungeon'
+  // with level 'level' of it (or the first one), returns true then
+  bool update( Dungeon &dungeon, const uint8_t level = 0 );
+
+private:
+  // identifies a version of the file
+  class FILE_KEY
+  {
+  public:
+    bool operator==( const FILE_KEY &other ) const { return( memcmp( this, &other, sizeof( *this ) ) == 0 ); }
+    uint64_t device;
+    uint64_t inode;
+    int64_t size;
+    int64_t modified;
+  };
+
+  static bool getFileKey( const char *path, FILE_KEY &key );
+  bool setError( const char *format, ... );
+
+  std::string path;
+  void *data;
+  size_t size;
+  FILE_KEY fileKey;
+  // the last version which couldn't be used (not tried again)
+  FILE_KEY failedKey;
+  std::vector<LEVEL_DATA> levels;
+  std::string error;
+};
@@ -0,0 +1,818 @@
+//
+// Explores all reachable game states of Level_1 and finds the dead ends (deadlocks).
+//
+// A state is the player's position, the items and every cell that can change: levers, chests,
+// doors, bars, fake walls and monsters (the 'dynamic cells', found from interactionData,
+// the monsters and the fake walls). The direction isn't part of the state, the player can
+// always turn. Positions which can be reached from each other by walking (the strongly
+// connected areas of the level, with the teleporters and spinners of specialCellFX) are one
+// state, so a state changes by
+//   - walking into another area (e.g. through a one way teleporter) or
+//   - pressing fire in front of a dynamic cell (levers, chests, doors, monsters, the fountain).
+// Both are done by the game itself (Dungeon::playerInput()), so the interactionData effects
+// are exact. Fights are always won: the dice and the hit points are not part of the state,
+// so deadlocks by death are out of scope (that's a job for the batch runner).
+//
+// The states are bit packed into 64 bits and explored breadth first (level by level on
+// all cores). The result doesn't depend on the number of threads.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -pthread -Ihost -I. *.cpp host/hostArduino.cpp host/levelSolver.cpp -o levelSolver
+//
+// Run:
+//   ./levelSolver [-j <threads>] [-k <examples>] [-m <max states>]
+//     -j <threads>     number of threads (default: all cores)
+//     -k <examples>    number of dead end examples to print (default: 5)
+//     -m <max states>  stop after this many states (default: 20000000)
+//
+// Report: number of states, the path to ITEM_VICTORY with the fewest state changes (as a script
+// for host/walkthrough.cpp, fights take more than one 'F' in the real game), the dead ends (states
+// from which the victory can't be reached anymore) with the moves leading into them, and the
+// items and monsters which can't be reached at all.
+//
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "hostGame.h"
+#include "LevelDefinitions.h"
+
+// the hit points of the player in every state
+#define SOLVER_PLAYER_HP  100
+
+#define NO_STATE  0xffffffffffffffffULL
+#define NO_NODE   0xffffffffUL
+#define NO_CELL   0xffff
+
+// key bits: area 0..7 (smallest cell of the area), items 8..15, dynamic cells from 16 on
+#define KEY_ITEMS_SHIFT  8
+#define KEY_CELL_SHIFT   16
+#define getKeyArea( key )   uint8_t( key )
+#define getKeyItems( key )  uint8_t( ( key ) >> KEY_ITEMS_SHIFT )
+
+// actions of the state changes: direction 0..3 and
+#define ACTION_FIRE  0x04
+
+static const char *itemNames[8] = { "compass", "amulet", "ring", "key", "potion", "sword", "shield", "victory" };
+static const char *dirNames[4] = { "north", "east", "south", "west" };
+
+/*--------------------------------------------------------*/
+// a cell which can change, with all of its possible values
+class DYNAMIC_CELL
+{
+public:
+  uint8_t position;
+  uint8_t bits;
+  uint8_t shift;
+  std::vector<uint8_t> values;
+
+  bool addValue( const uint8_t value )
+  {
+    if ( std::find( values.begin(), values.end(), value ) != values.end() ) { return( false ); }
+    values.push_back( value );
+    return( true );
+  }
+};
+
+// a reached state
+class STATE_NODE
+{
+public:
+  uint64_t key;
+  uint32_t parent;
+  // the player's cell and action (direction | ACTION_FIRE) in the parent state
+  uint8_t cell;
+  uint8_t action;
+};
+
+// a state change
+class STATE_EDGE
+{
+public:
+  uint32_t from;
+  uint8_t cell;
+  uint8_t action;
+  uint64_t to;
+};
+
+static std::vector<DYNAMIC_CELL> dynamicCells;
+static int8_t dynamicCellIndex[MAX_LEVEL_BYTES];
+// the game state after init()
+static DUNGEON initialState;
+static uint8_t keyBits;
+
+// the cell in front of the player and where a step ends (teleporters!) for every cell and direction
+static uint8_t moveFront[MAX_LEVEL_BYTES][4];
+static uint8_t moveLanding[MAX_LEVEL_BYTES][4];
+
+/*--------------------------------------------------------*/
+// performs the action at the given position
+static void playAt( HOST_GAME &game, const uint8_t cell, const uint8_t dir, const uint8_t inputs )
+{
+  game.dungeon._dungeon.playerX = cell % LEVEL_WIDTH;
+  game.dungeon._dungeon.playerY = cell / LEVEL_WIDTH;
+  game.dungeon._dungeon.dir = dir;
+  game.dungeon.prepareFrame();
+  game.dungeon.playerInput( inputs );
+}
+
+/*--------------------------------------------------------*/
+static uint8_t getPlayerCell( const HOST_GAME &game )
+{
+  return( game.dungeon._dungeon.playerX + game.dungeon._dungeon.playerY * LEVEL_WIDTH );
+}
+
+/*--------------------------------------------------------*/
+static DYNAMIC_CELL &getDynamicCell( const uint8_t position )
+{
+  if ( dynamicCellIndex[position] < 0 )
+  {
+    DYNAMIC_CELL cell;
+    cell.position = position;
+    cell.addValue( initialState.currentLevel[position] );
+    dynamicCellIndex[position] = int8_t( dynamicCells.size() );
+    dynamicCells.push_back( cell );
+  }
+  return( dynamicCells[dynamicCellIndex[position]] );
+}
+
+/*--------------------------------------------------------*/
+// collects all cells that can change and their values (a superset, like playerInteraction() works)
+static void findDynamicCells()
+{
+  const size_t interactions = sizeof( interactionData ) / sizeof( interactionData[0] );
+
+  memset( dynamicCellIndex, -1, sizeof( dynamicCellIndex ) );
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+  {
+    // defeated
+    getDynamicCell( initialState.monsterStats[n].position ).addValue( EMPTY );
+  }
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    // removed by the amulet
+    if ( initialState.currentLevel[position] == FAKE_WALL ) { getDynamicCell( position ).addValue( EMPTY ); }
+  }
+
+  // repeat until nothing changes
+  bool changed = true;
+  while ( changed )
+  {
+    changed = false;
+    for ( size_t n = 0; n < interactions; n++ )
+    {
+      const INTERACTION_INFO &info = interactionData[n];
+      DYNAMIC_CELL &cell = getDynamicCell( info.currentPosition );
+      for ( size_t v = 0; v < cell.values.size(); v++ )
+      {
+        const uint8_t value = cell.values[v];
+        if ( ( value & OBJECT_MASK ) != info.currentStatus ) { continue; }
+        changed |= cell.addValue( ( value - info.currentStatus ) | info.nextStatus );
+        // opened with the key
+        if ( value == ( DOOR | FLAG_SOLID ) ) { changed |= cell.addValue( EMPTY ); }
+      }
+      changed |= getDynamicCell( info.modifiedPosition ).addValue( info.modifiedPositionCellValue );
+    }
+  }
+
+  keyBits = KEY_CELL_SHIFT;
+  for ( DYNAMIC_CELL &cell : dynamicCells )
+  {
+    cell.bits = 0;
+    while ( ( 1U << cell.bits ) < cell.values.size() ) { cell.bits++; }
+    cell.shift = keyBits;
+    keyBits += cell.bits;
+  }
+}
+
+/*--------------------------------------------------------*/
+// the steps don't depend on the level state (only if they are possible)
+static void findMoves()
+{
+  HOST_GAME game;
+  for ( uint16_t cell = 0; cell < MAX_LEVEL_BYTES; cell++ )
+  {
+    for ( uint8_t dir = 0; dir < 4; dir++ )
+    {
+      DUNGEON &state = game.dungeon._dungeon;
+      state = initialState;
+      memset( state.currentLevel, EMPTY, sizeof( state.currentLevel ) );
+      moveFront[cell][dir] = game.dungeon.getCellRaw( cell % LEVEL_WIDTH, cell / LEVEL_WIDTH, +1, 0, dir ) - state.currentLevel;
+      playAt( game, uint8_t( cell ), dir, INPUT_UP );
+      moveLanding[cell][dir] = getPlayerCell( game );
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+static bool isPassable( const uint8_t *level, const uint8_t cell )
+{
+  // like checkPlayerMovement()
+  return( ( level[cell] & FLAG_SOLID ) != FLAG_SOLID );
+}
+
+/*--------------------------------------------------------*/
+// finds the area of a cell: all cells which can be reached from it and back
+class AREA_FINDER
+{
+public:
+  AREA_FINDER() : stamp( 0 ) { memset( marks, 0, sizeof( marks ) ); }
+
+  // returns the smallest cell of the area, the cells are in 'area'
+  uint8_t find( const uint8_t *level, const uint8_t start )
+  {
+    // all reachable cells and the reverse steps between them
+    stamp += 2;
+    reachable.clear();
+    reachable.push_back( start );
+    marks[start] = stamp;
+    firstEdge[start] = NO_CELL;
+    edgeCount = 0;
+    for ( size_t n = 0; n < reachable.size(); n++ )
+    {
+      const uint8_t cell = reachable[n];
+      for ( uint8_t dir = 0; dir < 4; dir++ )
+      {
+        if ( !isPassable( level, moveFront[cell][dir] ) ) { continue; }
+        const uint8_t target = moveLanding[cell][dir];
+        if ( marks[target] < stamp )
+        {
+          marks[target] = stamp;
+          firstEdge[target] = NO_CELL;
+          reachable.push_back( target );
+        }
+        edgeFrom[edgeCount] = cell;
+        nextEdge[edgeCount] = firstEdge[target];
+        firstEdge[target] = edgeCount++;
+      }
+    }
+
+    // all of them which lead back to the start
+    area.clear();
+    area.push_back( start );
+    marks[start] = stamp + 1;
+    uint8_t smallest = start;
+    for ( size_t n = 0; n < area.size(); n++ )
+    {
+      for ( uint16_t edge = firstEdge[area[n]]; edge != NO_CELL; edge = nextEdge[edge] )
+      {
+        const uint8_t cell = edgeFrom[edge];
+        if ( marks[cell] == stamp )
+        {
+          marks[cell] = stamp + 1;
+          area.push_back( cell );
+          smallest = std::min( smallest, cell );
+        }
+      }
+    }
+    return( smallest );
+  }
+
+  bool isInArea( const uint8_t cell ) const { return( marks[cell] == stamp + 1 ); }
+
+  std::vector<uint8_t> area;
+
+private:
+  uint32_t marks[MAX_LEVEL_BYTES];
+  uint32_t stamp;
+  std::vector<uint8_t> reachable;
+  uint16_t firstEdge[MAX_LEVEL_BYTES];
+  uint16_t nextEdge[MAX_LEVEL_BYTES * 4];
+  uint8_t edgeFrom[MAX_LEVEL_BYTES * 4];
+  uint16_t edgeCount;
+};
+
+/*--------------------------------------------------------*/
+// the level and the items (without the area)
+static uint64_t packState( const DUNGEON &state )
+{
+  uint64_t key = uint64_t( state.playerItems ) << KEY_ITEMS_SHIFT;
+
+  for ( const DYNAMIC_CELL &cell : dynamicCells )
+  {
+    const uint8_t value = state.currentLevel[cell.position];
+    const size_t index = std::find( cell.values.begin(), cell.values.end(), value ) - cell.values.begin();
+    if ( index == cell.values.size() )
+    {
+      fprintf( stderr, "*** unexpected value 0x%02x in cell (%u, %u)\n", value,
+               cell.position % LEVEL_WIDTH, cell.position / LEVEL_WIDTH );
+      exit( 2 );
+    }
+    key |= uint64_t( index ) << cell.shift;
+  }
+  return( key );
+}
+
+/*--------------------------------------------------------*/
+// the level and the items, the player stands in the area
+static void unpackState( const uint64_t key, DUNGEON &state )
+{
+  state = initialState;
+  state.playerX = getKeyArea( key ) % LEVEL_WIDTH;
+  state.playerY = getKeyArea( key ) / LEVEL_WIDTH;
+  state.playerItems = getKeyItems( key );
+  state.playerHP = SOLVER_PLAYER_HP;
+
+  for ( const DYNAMIC_CELL &cell : dynamicCells )
+  {
+    state.currentLevel[cell.position] = cell.values[( key >> cell.shift ) & ( ( 1U << cell.bits ) - 1 )];
+  }
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+  {
+    // a monster dies with the first blow
+    state.monsterStats[n].hitpoints = ( state.currentLevel[state.monsterStats[n].position] == EMPTY ) ? 0 : 1;
+  }
+}
+
+/*--------------------------------------------------------*/
+// key -> node index (open addressing, written between the BFS levels only)
+class STATE_MAP
+{
+public:
+  STATE_MAP() : count( 0 ) { resize( 1 << 16 ); }
+
+  uint32_t find( const uint64_t key ) const
+  {
+    for ( size_t n = hash( key ); ; n = ( n + 1 ) & mask )
+    {
+      if ( keys[n] == key ) { return( nodes[n] ); }
+      if ( keys[n] == NO_STATE ) { return( NO_NODE ); }
+    }
+  }
+
+  void insert( const uint64_t key, const uint32_t node )
+  {
+    if ( ( count + 1 ) * 2 > keys.size() ) { resize( keys.size() * 2 ); }
+    size_t n = hash( key );
+    while ( keys[n] != NO_STATE ) { n = ( n + 1 ) & mask; }
+    keys[n] = key;
+    nodes[n] = node;
+    count++;
+  }
+
+private:
+  size_t hash( uint64_t key ) const
+  {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return( size_t( key ) & mask );
+  }
+
+  void resize( const size_t size )
+  {
+    std::vector<uint64_t> oldKeys( size, NO_STATE );
+    std::vector<uint32_t> oldNodes( size );
+    oldKeys.swap( keys );
+    oldNodes.swap( nodes );
+    mask = size - 1;
+    count = 0;
+    for ( size_t n = 0; n < oldKeys.size(); n++ )
+    {
+      if ( oldKeys[n] != NO_STATE ) { insert( oldKeys[n], oldNodes[n] ); }
+    }
+  }
+
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> nodes;
+  size_t mask;
+  size_t count;
+};
+
+static std::vector<STATE_NODE> nodes;
+static STATE_MAP stateMap;
+static std::atomic<bool> potionFound( false );
+
+/*--------------------------------------------------------*/
+// the states and changes found by a thread
+class EXPANSION
+{
+public:
+  std::vector<STATE_NODE> candidates;
+  std::vector<STATE_EDGE> edges;
+
+  void add( const uint32_t from, const uint8_t cell, const uint8_t action, const uint64_t to )
+  {
+    // one change per target state is enough
+    for ( size_t n = edges.size(); n-- > firstEdge; ) { if ( edges[n].to == to ) { return; } }
+    STATE_EDGE edge = { from, cell, action, to };
+    edges.push_back( edge );
+    if ( stateMap.find( to ) == NO_NODE )
+    {
+      STATE_NODE candidate = { to, from, cell, action };
+      candidates.push_back( candidate );
+    }
+  }
+
+  size_t firstEdge;
+};
+
+/*--------------------------------------------------------*/
+// expands the nodes up to <last> (blocks of 64 from <nextNode>)
+static void expandNodes( std::atomic<uint32_t> &nextNode, const uint32_t last, EXPANSION &expansion )
+{
+  HOST_GAME game;
+  AREA_FINDER area, targetArea;
+  DUNGEON state;
+
+  for ( ;; )
+  {
+    const uint32_t first = nextNode.fetch_add( 64 );
+    if ( first >= last ) { return; }
+
+    for ( uint32_t node = first; node < std::min( first + 64, last ); node++ )
+    {
+      const uint64_t key = nodes[node].key;
+      // the victory is the end
+      if ( getKeyItems( key ) & ITEM_VICTORY ) { continue; }
+
+      unpackState( key, state );
+      area.find( state.currentLevel, getKeyArea( key ) );
+      expansion.firstEdge = expansion.edges.size();
+
+      for ( const uint8_t cell : area.area )
+      {
+        for ( uint8_t dir = 0; dir < 4; dir++ )
+        {
+          // walking into another area
+          const uint8_t front = moveFront[cell][dir];
+          if ( isPassable( state.currentLevel, front ) && !area.isInArea( moveLanding[cell][dir] ) )
+          {
+            const uint8_t target = targetArea.find( state.currentLevel, moveLanding[cell][dir] );
+            expansion.add( node, cell, dir, ( key & ~0xffULL ) | target );
+          }
+
+          // fire in front of a dynamic cell
+          if ( dynamicCellIndex[front] < 0 ) { continue; }
+          game.dungeon._dungeon = state;
+          playAt( game, cell, dir, INPUT_FIRE );
+          // a potion is swallowed right away
+          if ( game.dungeon._dungeon.playerHP > SOLVER_PLAYER_HP ) { potionFound = true; }
+
+          uint64_t successor = packState( game.dungeon._dungeon );
+          if ( ( successor | getKeyArea( key ) ) == key ) { continue; }
+          successor |= targetArea.find( game.dungeon._dungeon.currentLevel, getPlayerCell( game ) );
+          expansion.add( node, cell, dir | ACTION_FIRE, successor );
+        }
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+// the keys to turn from one direction to another
+static void addTurns( std::string &script, const uint8_t from, const uint8_t to )
+{
+  switch ( ( to - from ) & 0x03 )
+  {
+    case 1: script += 'R'; break;
+    case 2: script += "RR"; break;
+    case 3: script += 'L'; break;
+    default: break;
+  }
+}
+
+/*--------------------------------------------------------*/
+// the keys from the start to the end of the state change into <node>
+static std::string getScript( const uint32_t node, const int extraCell = -1, const uint8_t extraAction = 0 )
+{
+  std::vector<uint32_t> chain;
+  for ( uint32_t n = node; nodes[n].parent != NO_NODE; n = nodes[n].parent ) { chain.push_back( n ); }
+  std::reverse( chain.begin(), chain.end() );
+
+  // the changes and an optional one
+  std::vector<std::pair<uint8_t, uint8_t>> changes;
+  for ( const uint32_t n : chain ) { changes.push_back( std::make_pair( nodes[n].cell, nodes[n].action ) ); }
+  if ( extraCell >= 0 ) { changes.push_back( std::make_pair( uint8_t( extraCell ), extraAction ) ); }
+
+  // replay them with the real positions and directions
+  HOST_GAME game;
+  DUNGEON &state = game.dungeon._dungeon;
+  unpackState( nodes[0].key, state );
+  state.playerX = initialState.playerX;
+  state.playerY = initialState.playerY;
+  state.dir = initialState.dir;
+
+  std::string script;
+  for ( const std::pair<uint8_t, uint8_t> &change : changes )
+  {
+    // shortest walk to the cell of the change
+    std::vector<uint16_t> previous( MAX_LEVEL_BYTES, NO_CELL );
+    std::vector<uint8_t> queue( 1, getPlayerCell( game ) );
+    previous[getPlayerCell( game )] = getPlayerCell( game );
+    for ( size_t q = 0; ( q < queue.size() ) && ( previous[change.first] == NO_CELL ); q++ )
+    {
+      for ( uint8_t dir = 0; dir < 4; dir++ )
+      {
+        const uint8_t target = moveLanding[queue[q]][dir];
+        if ( isPassable( state.currentLevel, moveFront[queue[q]][dir] ) && ( previous[target] == NO_CELL ) )
+        {
+          previous[target] = queue[q] | ( dir << 8 );
+          queue.push_back( target );
+        }
+      }
+    }
+    std::vector<std::pair<uint8_t, uint8_t>> steps;
+    for ( uint8_t cell = change.first; cell != getPlayerCell( game ); cell = uint8_t( previous[cell] ) )
+    {
+      steps.push_back( std::make_pair( uint8_t( previous[cell] ), uint8_t( previous[cell] >> 8 ) ) );
+    }
+    std::reverse( steps.begin(), steps.end() );
+
+    for ( const std::pair<uint8_t, uint8_t> &step : steps )
+    {
+      addTurns( script, state.dir, step.second );
+      script += 'U';
+      playAt( game, step.first, step.second, INPUT_UP );
+    }
+
+    const uint8_t dir = change.second & 0x03;
+    addTurns( script, state.dir, dir );
+    script += ( change.second & ACTION_FIRE ) ? 'F' : 'U';
+    playAt( game, change.first, dir, ( change.second & ACTION_FIRE ) ? INPUT_FIRE : INPUT_UP );
+    // a monster dies with the first blow
+    for ( uint8_t n = 0; n < MAX_MONSTERS; n++ ) { if ( state.monsterStats[n].hitpoints > 0 ) { state.monsterStats[n].hitpoints = 1; } }
+    state.playerHP = SOLVER_PLAYER_HP;
+  }
+  return( script );
+}
+
+/*--------------------------------------------------------*/
+// plays a script like getScript() (monsters die with the first blow), returns the items at the end
+static uint8_t playScript( const std::string &script )
+{
+  HOST_GAME game;
+  DUNGEON &state = game.dungeon._dungeon;
+  unpackState( nodes[0].key, state );
+  state.playerX = initialState.playerX;
+  state.playerY = initialState.playerY;
+  state.dir = initialState.dir;
+
+  for ( const char key : script )
+  {
+    const uint8_t inputs = ( key == 'L' ) ? INPUT_LEFT : ( key == 'R' ) ? INPUT_RIGHT : ( key == 'U' ) ? INPUT_UP
+                         : ( key == 'D' ) ? INPUT_DOWN : INPUT_FIRE;
+    playAt( game, getPlayerCell( game ), state.dir, inputs );
+    for ( uint8_t n = 0; n < MAX_MONSTERS; n++ ) { if ( state.monsterStats[n].hitpoints > 0 ) { state.monsterStats[n].hitpoints = 1; } }
+    state.playerHP = SOLVER_PLAYER_HP;
+  }
+  return( state.playerItems );
+}
+
+/*--------------------------------------------------------*/
+static void printItems( const uint8_t items )
+{
+  if ( !items ) { printf( " none" ); }
+  for ( uint8_t item = 0; item < 8; item++ ) { if ( items & ( 1 << item ) ) { printf( " %s", itemNames[item] ); } }
+}
+
+/*--------------------------------------------------------*/
+// what changed between two states
+static void printChanges( const uint64_t fromKey, const uint64_t toKey )
+{
+  DUNGEON from, to;
+  unpackState( fromKey, from );
+  unpackState( toKey, to );
+
+  if ( getKeyArea( fromKey ) != getKeyArea( toKey ) )
+  {
+    printf( "      area of (%d, %d) -> area of (%d, %d)\n", from.playerX, from.playerY, to.playerX, to.playerY );
+  }
+  if ( from.playerItems != to.playerItems )
+  {
+    printf( "      items:" ); printItems( from.playerItems ); printf( " ->" ); printItems( to.playerItems ); printf( "\n" );
+  }
+  for ( const DYNAMIC_CELL &cell : dynamicCells )
+  {
+    if ( from.currentLevel[cell.position] != to.currentLevel[cell.position] )
+    {
+      printf( "      cell (%u, %u): 0x%02x -> 0x%02x\n", cell.position % LEVEL_WIDTH, cell.position / LEVEL_WIDTH,
+              from.currentLevel[cell.position], to.currentLevel[cell.position] );
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  unsigned threads = std::thread::hardware_concurrency();
+  unsigned examples = 5;
+  uint32_t maxStates = 20000000;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-j" ) && ( n + 1 < argc ) ) { threads = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-k" ) && ( n + 1 < argc ) ) { examples = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-m" ) && ( n + 1 < argc ) ) { maxStates = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-j <threads>] [-k <examples>] [-m <max states>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+  if ( !threads ) { threads = 1; }
+
+  // the start of the game
+  {
+    HOST_GAME game;
+    game.dungeon.init();
+    initialState = game.dungeon._dungeon;
+  }
+
+  findDynamicCells();
+  findMoves();
+  printf( "Level_1: %zu dynamic cells, %u bits per state\n", dynamicCells.size(), keyBits );
+  if ( keyBits > 64 )
+  {
+    fprintf( stderr, "*** the state doesn't fit into 64 bits\n" );
+    return( 2 );
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  // breadth first search, level by level
+  {
+    AREA_FINDER area;
+    const uint8_t startCell = initialState.playerX + initialState.playerY * LEVEL_WIDTH;
+    STATE_NODE root = { packState( initialState ) | area.find( initialState.currentLevel, startCell ), NO_NODE, 0, 0 };
+    nodes.push_back( root );
+    stateMap.insert( root.key, 0 );
+  }
+
+  std::vector<EXPANSION> expansions( threads );
+  uint32_t levelStart = 0;
+  uint32_t depth = 0;
+  bool complete = true;
+  while ( levelStart < nodes.size() )
+  {
+    const uint32_t levelEnd = uint32_t( nodes.size() );
+
+    std::atomic<uint32_t> nextNode( levelStart );
+    std::vector<std::thread> workers;
+    for ( unsigned n = 0; n < threads; n++ )
+    {
+      expansions[n].candidates.clear();
+      workers.emplace_back( expandNodes, std::ref( nextNode ), levelEnd, std::ref( expansions[n] ) );
+    }
+    for ( std::thread &worker : workers ) { worker.join(); }
+
+    // the same nodes in the same order for any number of threads
+    std::vector<STATE_NODE> level;
+    for ( EXPANSION &expansion : expansions )
+    {
+      level.insert( level.end(), expansion.candidates.begin(), expansion.candidates.end() );
+    }
+    std::sort( level.begin(), level.end(), []( const STATE_NODE &a, const STATE_NODE &b )
+    {
+      if ( a.key != b.key ) { return( a.key < b.key ); }
+      if ( a.parent != b.parent ) { return( a.parent < b.parent ); }
+      return( ( a.cell != b.cell ) ? ( a.cell < b.cell ) : ( a.action < b.action ) );
+    } );
+    for ( size_t n = 0; n < level.size(); n++ )
+    {
+      if ( n && ( level[n].key == level[n - 1].key ) ) { continue; }
+      stateMap.insert( level[n].key, uint32_t( nodes.size() ) );
+      nodes.push_back( level[n] );
+    }
+
+    levelStart = levelEnd;
+    if ( levelStart < nodes.size() ) { depth++; }
+    if ( nodes.size() > maxStates )
+    {
+      printf( "*** stopped after %zu states (-m), the results are incomplete\n", nodes.size() );
+      complete = false;
+      break;
+    }
+  }
+
+  double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+  size_t edgeCount = 0;
+  for ( EXPANSION &expansion : expansions ) { edgeCount += expansion.edges.size(); }
+  printf( "%zu states, %zu state changes, %u changes deep, %.2f s with %u threads\n", nodes.size(), edgeCount, depth,
+          time, threads );
+
+  // the victory
+  uint32_t victory = NO_NODE;
+  for ( uint32_t n = 0; n < nodes.size(); n++ )
+  {
+    if ( getKeyItems( nodes[n].key ) & ITEM_VICTORY ) { victory = n; break; }
+  }
+  if ( victory != NO_NODE )
+  {
+    const std::string script = getScript( victory );
+    printf( "\npath to the victory (%zu keys): %s\n", script.size(), script.c_str() );
+    if ( !( playScript( script ) & ITEM_VICTORY ) ) { printf( "*** the path doesn't reach the victory\n" ); }
+  }
+  else
+  {
+    printf( "\n*** the victory can't be reached\n" );
+  }
+
+  // the states which can reach the victory (backwards from the victory states)
+  const uint32_t nodeCount = uint32_t( nodes.size() );
+  std::vector<uint32_t> firstPredecessor( nodeCount + 1, 0 );
+  std::vector<uint32_t> edgeTargets;
+  std::vector<const STATE_EDGE *> edges;
+  for ( EXPANSION &expansion : expansions )
+  {
+    for ( const STATE_EDGE &edge : expansion.edges )
+    {
+      const uint32_t target = stateMap.find( edge.to );
+      if ( target == NO_NODE ) { continue; }
+      edges.push_back( &edge );
+      edgeTargets.push_back( target );
+      firstPredecessor[target + 1]++;
+    }
+  }
+  for ( uint32_t n = 0; n < nodeCount; n++ ) { firstPredecessor[n + 1] += firstPredecessor[n]; }
+  std::vector<uint32_t> predecessors( firstPredecessor[nodeCount] );
+  {
+    std::vector<uint32_t> fill( firstPredecessor.begin(), firstPredecessor.end() - 1 );
+    for ( size_t n = 0; n < edges.size(); n++ ) { predecessors[fill[edgeTargets[n]]++] = edges[n]->from; }
+  }
+
+  std::vector<bool> canWin( nodeCount, false );
+  std::vector<uint32_t> queue;
+  for ( uint32_t n = 0; n < nodeCount; n++ )
+  {
+    if ( getKeyItems( nodes[n].key ) & ITEM_VICTORY ) { canWin[n] = true; queue.push_back( n ); }
+  }
+  for ( size_t q = 0; q < queue.size(); q++ )
+  {
+    for ( uint32_t p = firstPredecessor[queue[q]]; p < firstPredecessor[queue[q] + 1]; p++ )
+    {
+      if ( !canWin[predecessors[p]] ) { canWin[predecessors[p]] = true; queue.push_back( predecessors[p] ); }
+    }
+  }
+
+  // dead ends and the moves into them (from a winnable state), the earliest first
+  uint32_t deadEnds = 0;
+  for ( uint32_t n = 0; n < nodeCount; n++ ) { if ( !canWin[n] ) { deadEnds++; } }
+  std::vector<size_t> deadlyEdges;
+  for ( size_t n = 0; n < edges.size(); n++ )
+  {
+    if ( canWin[edges[n]->from] && !canWin[edgeTargets[n]] ) { deadlyEdges.push_back( n ); }
+  }
+  std::sort( deadlyEdges.begin(), deadlyEdges.end(), [&]( const size_t a, const size_t b )
+  {
+    return( ( edges[a]->from != edges[b]->from ) ? ( edges[a]->from < edges[b]->from ) : ( edgeTargets[a] < edgeTargets[b] ) );
+  } );
+  // the same cell and action in another state is the same mistake
+  std::vector<uint16_t> deadlyMoves;
+  std::vector<size_t> deadlyMoveExamples;
+  for ( const size_t n : deadlyEdges )
+  {
+    const uint16_t move = edges[n]->cell | ( edges[n]->action << 8 );
+    if ( std::find( deadlyMoves.begin(), deadlyMoves.end(), move ) != deadlyMoves.end() ) { continue; }
+    deadlyMoves.push_back( move );
+    deadlyMoveExamples.push_back( n );
+  }
+
+  if ( !complete ) { printf( "(the following numbers only cover the explored states)\n" ); }
+  printf( "\ndead ends: %u of %u states (%.1f%%) can't reach the victory anymore\n", deadEnds, nodeCount,
+          100.0 * deadEnds / nodeCount );
+  if ( !deadlyMoves.empty() )
+  {
+    printf( "%zu different moves lead into a dead end (%zu state changes), the earliest ones:\n", deadlyMoves.size(),
+            deadlyEdges.size() );
+  }
+  for ( size_t n = 0; n < std::min( size_t( examples ), deadlyMoveExamples.size() ); n++ )
+  {
+    const STATE_EDGE &edge = *edges[deadlyMoveExamples[n]];
+    const std::string script = getScript( edge.from, edge.cell, edge.action );
+    printf( "  '%c' at (%u, %u) facing %s, keys: %s\n", ( edge.action & ACTION_FIRE ) ? 'F' : 'U',
+            edge.cell % LEVEL_WIDTH, edge.cell / LEVEL_WIDTH, dirNames[edge.action & 0x03], script.c_str() );
+    printChanges( nodes[edge.from].key, edge.to );
+  }
+
+  // items and monsters
+  uint8_t possibleItems = 0;
+  for ( size_t n = 0; n < sizeof( interactionData ) / sizeof( interactionData[0] ); n++ ) { possibleItems |= interactionData[n].newItem; }
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ ) { possibleItems |= initialState.monsterStats[n].treasureItemMask; }
+  uint8_t foundItems = potionFound ? ITEM_POTION : 0;
+  std::vector<bool> monsterDefeated( MAX_MONSTERS, false );
+  DUNGEON state;
+  for ( uint32_t n = 0; n < nodeCount; n++ )
+  {
+    foundItems |= getKeyItems( nodes[n].key );
+    unpackState( nodes[n].key, state );
+    for ( uint8_t m = 0; m < MAX_MONSTERS; m++ ) { if ( state.monsterStats[m].hitpoints <= 0 ) { monsterDefeated[m] = true; } }
+  }
+  printf( "\nunreachable items:" ); printItems( possibleItems & ~foundItems ); printf( "\n" );
+  printf( "unreachable monsters:" );
+  bool allMonsters = true;
+  for ( uint8_t m = 0; m < MAX_MONSTERS; m++ )
+  {
+    if ( monsterDefeated[m] ) { continue; }
+    allMonsters = false;
+    printf( " (%u, %u)", initialState.monsterStats[m].position % LEVEL_WIDTH, initialState.monsterStats[m].position / LEVEL_WIDTH );
+  }
+  printf( "%s\n", allMonsters ? " none" : "" );
+
+  return( ( victory != NO_NODE ) ? 0 : 1 );
+}
@@ -0,0 +1,181 @@
+//
+// Micro benchmarks on the host (see microBenchmarks.h for the kernels and the corpus).
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -D_ENABLE_MICRO_BENCHMARKS_ -Ihost -I. *.cpp host/hostArduino.cpp host/microBenchmarks.cpp -o microBenchmarks
+//
+// Run:
+//   ./microBenchmarks [-b <budgets>] [-u] [-t <percent>] [-r <runs>]
+//     -b <budgets>  budgets file (one line per kernel: <name> <time>)
+//     -u            write the measured times as new budgets
+//     -t <percent>  allowed regression (default: 10%)
+//     -r <runs>     number of runs, the fastest one counts (default: 100)
+//
+// The times are nanoseconds for all calls of a kernel, so budgets are only
+// comparable on the same machine and there are no committed host budgets:
+// write the ones of your machine with -u before a change and check with the
+// default threshold after it. The gate is the cycle exact budgets for the
+// ATtiny85 in simavr/microBudgets.txt (see simavr/tinyDungeonSim.c).
+// The exit code is 1 if any kernel exceeds its budget by more than the threshold.
+//
+
+#include <Arduino.h>
+#include <chrono>
+#include "dungeon.h"
+#include "microBenchmarks.h"
+
+#ifndef _ENABLE_MICRO_BENCHMARKS_
+  #error "Please compile with -D_ENABLE_MICRO_BENCHMARKS_"
+#endif
+
+// kernel names (in the order of the kernel numbers, see microBenchmarks.h)
+static const char *kernelNames[MICRO_BENCHMARKS] =
+{
+  nullptr,
+  "walls",
+  "cellLookup",
+  "scaleD1",
+  "scaleD2",
+  "scaleD3",
+  "interaction",
+  "findMonster",
+  "sendPixels",
+  "sendRun",
+};
+
+// results of a single run
+class KERNEL_RESULT
+{
+public:
+  uint32_t calls;
+  uint64_t time;
+};
+
+static Dungeon dungeon;
+static KERNEL_RESULT currentRun[MICRO_BENCHMARKS];
+static uint8_t currentKernel;
+static std::chrono::steady_clock::time_point kernelStart;
+
+/*--------------------------------------------------------*/
+void microBenchmarkBegin( const uint8_t kernel )
+{
+  currentKernel = kernel;
+  kernelStart = std::chrono::steady_clock::now();
+}
+
+/*--------------------------------------------------------*/
+void microBenchmarkEnd()
+{
+  auto duration = std::chrono::steady_clock::now() - kernelStart;
+  currentRun[currentKernel].time += std::chrono::duration_cast<std::chrono::nanoseconds>( duration ).count();
+  currentRun[currentKernel].calls++;
+}
+
+/*--------------------------------------------------------*/
+// returns the budget of a kernel (0 if there is none)
+static uint64_t getBudget( FILE *budgets, const char *kernelName )
+{
+  char line[128];
+  rewind( budgets );
+  while ( fgets( line, sizeof( line ), budgets ) )
+  {
+    char name[32];
+    unsigned long long budget;
+    if ( ( line[0] != '#' ) && ( sscanf( line, "%31s %llu", name, &budget ) == 2 ) && !strcmp( name, kernelName ) )
+    {
+      return( budget );
+    }
+  }
+  return( 0 );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *budgetsName = nullptr;
+  bool update = false;
+  unsigned threshold = 10;
+  unsigned runs = 100;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-u" ) ) { update = true; }
+    else if ( !strcmp( argv[n], "-b" ) && ( n + 1 < argc ) ) { budgetsName = argv[++n]; }
+    else if ( !strcmp( argv[n], "-t" ) && ( n + 1 < argc ) ) { threshold = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-r" ) && ( n + 1 < argc ) ) { runs = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-b <budgets>] [-u] [-t <percent>] [-r <runs>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+  if ( update && !budgetsName )
+  {
+    fprintf( stderr, "-u requires a budgets file (-b)\n" );
+    return( 2 );
+  }
+
+  // the fastest run of every kernel counts
+  KERNEL_RESULT best[MICRO_BENCHMARKS];
+  memset( best, 0, sizeof( best ) );
+
+  for ( unsigned run = 0; run < runs; run++ )
+  {
+    memset( currentRun, 0, sizeof( currentRun ) );
+    runMicroBenchmarks( dungeon );
+
+    for ( uint8_t kernel = 1; kernel < MICRO_BENCHMARKS; kernel++ )
+    {
+      if ( !run || ( currentRun[kernel].time < best[kernel].time ) ) { best[kernel] = currentRun[kernel]; }
+    }
+  }
+
+  FILE *budgets = nullptr;
+  if ( budgetsName )
+  {
+    budgets = fopen( budgetsName, update ? "w" : "r" );
+    if ( !budgets ) { perror( budgetsName ); return( 2 ); }
+    if ( update ) { fprintf( budgets, "# micro benchmark budgets [ns]: <kernel> <time of all calls>\n" ); }
+  }
+
+  printf( "kernel         calls   time [ns]  per call [ns]  budget [ns]\n" );
+  bool regression = false;
+
+  for ( uint8_t kernel = 1; kernel < MICRO_BENCHMARKS; kernel++ )
+  {
+    const KERNEL_RESULT &result = best[kernel];
+    printf( "%-12s %7u %11llu %14llu", kernelNames[kernel], result.calls, ( unsigned long long )result.time,
+            ( unsigned long long )( result.calls ? result.time / result.calls : 0 ) );
+
+    if ( budgets && update )
+    {
+      fprintf( budgets, "%s %llu\n", kernelNames[kernel], ( unsigned long long )result.time );
+    }
+    else if ( budgets )
+    {
+      uint64_t budget = getBudget( budgets, kernelNames[kernel] );
+      if ( !budget )
+      {
+        printf( "            -  (no budget)" );
+      }
+      else
+      {
+        printf( " %12llu", ( unsigned long long )budget );
+        if ( result.time * 100 > budget * ( 100 + threshold ) )
+        {
+          printf( "  REGRESSION (+%llu%%)", ( unsigned long long )( result.time * 100 / budget - 100 ) );
+          regression = true;
+        }
+        else if ( result.time * 100 < budget * ( 100 - threshold ) )
+        {
+          printf( "  improved, update the budget?" );
+        }
+      }
+    }
+    printf( "\n" );
+  }
+
+  if ( budgets ) { fclose( budgets ); }
+
+  return( regression ? 1 : 0 );
+}
@@ -0,0 +1,153 @@
+//
+// Checks the rewind buffer (see rewindBuffer.h) against full snapshots and measures its size.
+//
+// Random games: the state after every action is kept as a full snapshot, too. From time to
+// time (and after every death, with the dungeon cleared like in the game) the game steps back
+// a random number of actions, the state must be the same as the snapshot of that time.
+// The game goes on from there, so the buffer is written over and over again.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -D_ENABLE_REWIND_ -Ihost -I. *.cpp host/hostArduino.cpp host/rewindCheck.cpp -o rewindCheck
+//   (add -DREWIND_BUFFER_SIZE=1024 for the size of the MCUs)
+//
+// Run:
+//   ./rewindCheck [-g <games>] [-a <actions>]
+//     -g <games>    number of games (default: 100)
+//     -a <actions>  actions per game (default: 10000)
+//
+// Report: mismatches, the bytes per action in the buffer, the number of actions
+// which fit into it and the time per action (including the game logic).
+//
+
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+#include "hostGame.h"
+
+#ifndef _ENABLE_REWIND_
+  #error "Please compile with -D_ENABLE_REWIND_"
+#endif
+
+// the longest rewind
+#define MAX_REWIND  40
+
+static const uint8_t agentActions[] = { INPUT_LEFT, INPUT_RIGHT, INPUT_UP, INPUT_UP, INPUT_DOWN, INPUT_FIRE };
+
+/*--------------------------------------------------------*/
+// xorshift32
+static uint32_t nextRandom( uint32_t &random )
+{
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return( random );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  uint32_t games = 100;
+  uint32_t actionsPerGame = 10000;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( !strcmp( argv[n], "-g" ) && ( n + 1 < argc ) ) { games = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-a" ) && ( n + 1 < argc ) ) { actionsPerGame = atoi( argv[++n] ); }
+    else
+    {
+      fprintf( stderr, "usage: %s [-g <games>] [-a <actions>]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  HOST_GAME *game = new HOST_GAME();
+  Dungeon &dungeon = game->dungeon;
+  REWIND_BUFFER &buffer = dungeon._rewindBuffer;
+  std::vector<DUNGEON> snapshots;
+
+  uint64_t actions = 0, rewinds = 0, actionsUndone = 0, deaths = 0, mismatches = 0;
+  uint64_t bufferedActions = 0, bufferedBytes = 0;
+  uint16_t maxActionSize = 0;
+  uint32_t random = 1;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for ( uint32_t gameNumber = 0; gameNumber < games; gameNumber++ )
+  {
+    game->io.diceSeed = uint16_t( gameNumber * 40503UL ) | 1;
+    dungeon.init();
+    snapshots.assign( 1, dungeon._dungeon );
+
+    for ( uint32_t n = 0; n < actionsPerGame; n++ )
+    {
+      const uint16_t bytesUsed = buffer.getBytesUsed();
+      const uint16_t bufferActions = buffer.getActions();
+
+      if ( game->play( agentActions[nextRandom( random ) % sizeof( agentActions )] ) )
+      {
+        actions++;
+        snapshots.push_back( dungeon._dungeon );
+        // nothing dropped: the size of this action
+        if ( buffer.getActions() == bufferActions + 1 )
+        {
+          maxActionSize = std::max( maxActionSize, uint16_t( buffer.getBytesUsed() - bytesUsed ) );
+        }
+      }
+      bufferedActions += buffer.getActions();
+      bufferedBytes += buffer.getBytesUsed();
+
+      const bool dead = !dungeon.isPlayerAlive();
+      if ( !dead && ( nextRandom( random ) % 32 ) ) { continue; }
+
+      if ( dead )
+      {
+        deaths++;
+        // like rewindAfterDeath()
+        dungeon.clear();
+      }
+
+      const uint16_t wanted = 1 + nextRandom( random ) % MAX_REWIND;
+      const uint16_t available = buffer.getActions();
+      const uint16_t undone = dungeon.rewind( wanted );
+      rewinds++;
+      actionsUndone += undone;
+
+      if ( undone != std::min( wanted, available ) )
+      {
+        printf( "*** game %u, action %u: %u of %u actions undone, %u were in the buffer\n", gameNumber, n, undone,
+                wanted, available );
+        mismatches++;
+      }
+      if ( !undone )
+      {
+        // nothing left (dead right after the start), start again
+        dungeon.init();
+        snapshots.assign( 1, dungeon._dungeon );
+        continue;
+      }
+
+      snapshots.resize( snapshots.size() - undone );
+      if ( memcmp( &dungeon._dungeon, &snapshots.back(), sizeof( DUNGEON ) ) )
+      {
+        printf( "*** game %u, action %u: the state after %u actions back differs from the snapshot\n", gameNumber, n,
+                undone );
+        mismatches++;
+        snapshots.back() = dungeon._dungeon;
+      }
+    }
+  }
+
+  double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+  const uint64_t steps = uint64_t( games ) * actionsPerGame;
+
+  printf( "%u games, %llu actions, %llu deaths, %llu rewinds (%llu actions undone): %llu mismatches\n", games,
+          ( unsigned long long )actions, ( unsigned long long )deaths, ( unsigned long long )rewinds,
+          ( unsigned long long )actionsUndone, ( unsigned long long )mismatches );
+  printf( "buffer: %u bytes, %.1f bytes per action (largest %u), %.0f actions in it on average (state: %zu bytes)\n",
+          REWIND_BUFFER_SIZE, bufferedActions ? double( bufferedBytes ) / bufferedActions : 0.0, maxActionSize,
+          double( bufferedActions ) / steps, sizeof( DUNGEON ) );
+  printf( "%.3f us per action (game logic, recording, rewinds)\n", 1e6 * time / steps );
+
+  delete game;
+  return( mismatches ? 1 : 0 );
+}
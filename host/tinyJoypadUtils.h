@@ -0,0 +1,4 @@
+#pragma once
+
+// the sources include "tinyJoypadUtils.h", which only works on case insensitive file systems
+#include "../TinyJoypadUtils.h"
@@ -0,0 +1,258 @@
+//
+// Records and replays walkthroughs (input recordings, see inputRecorder.h).
+//
+// Recording plays a script on the host and saves the recorded inputs. The recording
+// is replayed right away and the game state must be the same as after the script.
+// Replaying runs the recorded game as fast as possible, so a walkthrough
+// is a repeatable workload for benchmarks and a correctness check of the engine.
+//
+// Build (from the repository root):
+//   g++ -std=gnu++11 -O2 -D_ENABLE_INPUT_RECORDER_ -Ihost -I. *.cpp host/hostArduino.cpp host/walkthrough.cpp -o walkthrough
+//
+// Run:
+//   ./walkthrough -r <script> <recording>   play the script and record it
+//   ./walkthrough [-n <runs>] <recording>   replay the recording (fastest of <runs>, default: 10)
+//
+// Script characters (like in simavr/tinyDungeonSim.c, each one is an action):
+//   L, R, U, D  - joystick left, right, up, down
+//   F           - fire button
+//   .           - just wait
+// A button is tapped: it's released after the next frame (at most 100 ms), the next action
+// follows after 300 ms without frames and sound. The game doesn't wait for the release of a
+// lever or chest, so a held button would switch a lever again in every frame of the host.
+//
+// Report: frames, player state and the hash of the whole game state (FNV-1a of _dungeon),
+// which only matches if the engine still plays the game exactly the same way.
+// A walkthrough must end with ITEM_VICTORY, otherwise recording and replay fail.
+// Recordings from the EEPROM of a device can be replayed, too (e.g. dumped with avrdude).
+//
+// levels/Level_1.rec is a walkthrough that survives: the shield and the sword come first (see
+// host/combatSimulator.cpp), the potion of the chest at (14, 6) right before the beholder. The
+// extra fight with the skeleton at (7, 8) changes the dice of the beholder fight (they only
+// depend on the recorded seed), the player reaches the fountain with 7 hit points.
+// It was recorded with './walkthrough -r <script> levels/Level_1.rec' and this script:
+//   DRUFUFDDLUUUULFRUFDDLDDLURDDFURUUUUFFDLDDLDDDLDLUUULFFURFFLDLULUURFLDDLDLUUULUUULDDDDLUUULUFUULU
+//   LDLDLUULDDLULUURFULFLULUULDLDDLDDLUUUFFULUUULDDDDUULDDDRFLUUULUUDDDDRUUUFLDDDDDLULULDDDLUUULUURF
+//   LDDLUUULUUULULDLDDDDDLDDDLUUUUDDLUUUULDDDDLUURFFFUF
+//
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <chrono>
+#include "dungeon.h"
+#include "inputRecorder.h"
+
+#ifndef _ENABLE_INPUT_RECORDER_
+  #error "Please compile with -D_ENABLE_INPUT_RECORDER_"
+#endif
+
+// joystick readings (see isLeftPressed() and friends in TinyJoypadUtils.cpp)
+#define JOYSTICK_HIGH  850   // left or down
+#define JOYSTICK_LOW   625   // right or up
+
+// recordings of the device
+#define ATTINY85_EEPROM_SIZE  512
+
+#define PRESS_US  100000UL
+#define IDLE_US   300000UL
+
+static Dungeon dungeon;
+static uint32_t frames;
+static const char *script;
+// time of the last frame, sound or button release
+static uint32_t lastActivity;
+
+/*--------------------------------------------------------*/
+static void displayHook()
+{
+  frames++;
+  lastActivity = hostMicros;
+  // a tap: released once the game has reacted (it doesn't wait for the release,
+  // on the host a held button would repeat the action every frame)
+  if ( hostInputReleaseTime ) { hostInputReleaseTime = hostMicros; }
+}
+
+/*--------------------------------------------------------*/
+static void digitalWriteHook( uint8_t pin, uint8_t /*value*/ )
+{
+  if ( pin == SOUND_PIN ) { lastActivity = hostMicros; }
+}
+
+/*--------------------------------------------------------*/
+// presses the buttons of the next script action when the game is idle
+static void scriptPollHook()
+{
+  if ( hostInputReleaseTime || ( hostMicros - lastActivity < IDLE_US ) ) { return; }
+
+  if ( !*script )
+  {
+    // stop the game
+    hostDeadline = hostMicros;
+    return;
+  }
+
+  switch ( *script++ )
+  {
+    case 'L': hostAnalogPins[LEFT_RIGHT_BUTTON] = JOYSTICK_HIGH; break;
+    case 'R': hostAnalogPins[LEFT_RIGHT_BUTTON] = JOYSTICK_LOW; break;
+    case 'U': hostAnalogPins[UP_DOWN_BUTTON] = JOYSTICK_LOW; break;
+    case 'D': hostAnalogPins[UP_DOWN_BUTTON] = JOYSTICK_HIGH; break;
+    case 'F': hostDigitalPins[FIRE_BUTTON] = LOW; break;
+    default: break;
+  }
+  hostInputReleaseTime = hostMicros + PRESS_US;
+  lastActivity = hostInputReleaseTime;
+}
+
+/*--------------------------------------------------------*/
+// FNV-1a hash of the game state
+static uint32_t getStateHash()
+{
+  const uint8_t *data = ( const uint8_t * )&dungeon._dungeon;
+  uint32_t hash = 2166136261UL;
+  for ( size_t n = 0; n < sizeof( dungeon._dungeon ); n++ )
+  {
+    hash = ( hash ^ data[n] ) * 16777619UL;
+  }
+  return( hash );
+}
+
+/*--------------------------------------------------------*/
+// returns the size of the recording in 'inputRecording'
+static size_t getRecordingSize()
+{
+  size_t size = 2;
+  while ( ( size < INPUT_RECORDING_SIZE ) && ( inputRecording[size] != INPUT_END ) ) { size++; }
+  // including the end marker
+  return( size < INPUT_RECORDING_SIZE ? size + 1 : size );
+}
+
+/*--------------------------------------------------------*/
+// replays 'inputRecording' and returns the hash of the final game state
+static uint32_t replay()
+{
+  inputRecorderMode = INPUT_REPLAY;
+  frames = 0;
+  try
+  {
+    dungeon.gameLoop();
+  }
+  catch ( INPUT_REPLAY_FINISHED & )
+  {
+  }
+  return( getStateHash() );
+}
+
+/*--------------------------------------------------------*/
+// a walkthrough ends with the victory
+static bool isVictory()
+{
+  if ( dungeon._dungeon.playerItems & ITEM_VICTORY ) { return( true ); }
+  printf( "*** the walkthrough doesn't reach the victory\n" );
+  return( false );
+}
+
+/*--------------------------------------------------------*/
+static void printState( const char *title, const uint32_t hash )
+{
+  printf( "%s: %u frames, player at (%d, %d) dir %u, HP %d, items 0x%02x, state hash %08x\n", title, frames,
+          dungeon._dungeon.playerX, dungeon._dungeon.playerY, dungeon._dungeon.dir,
+          dungeon._dungeon.playerHP, dungeon._dungeon.playerItems, hash );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  const char *recordScript = nullptr;
+  unsigned runs = 10;
+
+  int n = 1;
+  for ( ; ( n < argc - 1 ) && ( argv[n][0] == '-' ); n++ )
+  {
+    if ( !strcmp( argv[n], "-r" ) && ( n + 1 < argc - 1 ) ) { recordScript = argv[++n]; }
+    else if ( !strcmp( argv[n], "-n" ) && ( n + 1 < argc - 1 ) ) { runs = atoi( argv[++n] ); }
+    else { break; }
+  }
+  if ( ( n != argc - 1 ) || !runs )
+  {
+    fprintf( stderr, "usage: %s -r <script> <recording>\n"
+                     "       %s [-n <runs>] <recording>\n", argv[0], argv[0] );
+    return( 2 );
+  }
+  const char *recordingName = argv[n];
+
+  hostDisplayHook = displayHook;
+  hostReleaseInputs();
+
+  if ( recordScript )
+  {
+    // play the script
+    inputRecorderMode = INPUT_RECORD;
+    script = recordScript;
+    hostDigitalWriteHook = digitalWriteHook;
+    hostPollHook = scriptPollHook;
+    try
+    {
+      dungeon.gameLoop();
+    }
+    catch ( HOST_DEADLINE_EXCEEDED & )
+    {
+    }
+    hostPollHook = nullptr;
+    hostDeadline = 0;
+
+    const uint32_t recordedHash = getStateHash();
+    printState( "recorded", recordedHash );
+
+    FILE *file = fopen( recordingName, "wb" );
+    if ( !file ) { perror( recordingName ); return( 2 ); }
+    const size_t size = getRecordingSize();
+    fwrite( inputRecording, 1, size, file );
+    fclose( file );
+    printf( "%zu bytes written to %s (the EEPROM of the ATtiny85 holds %u)\n", size, recordingName, ATTINY85_EEPROM_SIZE );
+    if ( inputRecorderFull )
+    {
+      printf( "*** the recording is full, the script isn't recorded to the end\n" );
+      return( 1 );
+    }
+
+    // the replay must end in the same state
+    const uint32_t replayedHash = replay();
+    printState( "replayed", replayedHash );
+    if ( replayedHash != recordedHash )
+    {
+      printf( "*** the replay doesn't match the recording\n" );
+      return( 1 );
+    }
+    return( isVictory() ? 0 : 1 );
+  }
+
+  FILE *file = fopen( recordingName, "rb" );
+  if ( !file ) { perror( recordingName ); return( 2 ); }
+  memset( inputRecording, INPUT_END, sizeof( inputRecording ) );
+  const size_t size = fread( inputRecording, 1, sizeof( inputRecording ), file );
+  fclose( file );
+  if ( size < 2 ) { fprintf( stderr, "%s: no recording\n", recordingName ); return( 2 ); }
+
+  // the fastest run counts
+  uint32_t hash = 0;
+  double bestTime = 0;
+  for ( unsigned run = 0; run < runs; run++ )
+  {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t runHash = replay();
+    double time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    if ( run && ( runHash != hash ) )
+    {
+      printf( "*** run %u ended in a different state\n", run );
+      return( 1 );
+    }
+    hash = runHash;
+    if ( !run || ( time < bestTime ) ) { bestTime = time; }
+  }
+
+  printState( "replayed", hash );
+  printf( "host time: %.3f ms, %.1f us per frame\n", bestTime * 1000.0, frames ? bestTime * 1e6 / frames : 0.0 );
+  return( isVictory() ? 0 : 1 );
+}
@@ -0,0 +1,190 @@
+//
+// Input recorder, see inputRecorder.h for details.
+//
+
+#include <Arduino.h>
+#include "inputRecorder.h"
+#include "tinyJoypadUtils.h"
+
+/*-------------------------------------------------------*/
+// reads all inputs from the joypad
+uint8_t readJoypad()
+{
+  uint8_t inputs = INPUT_NONE;
+  if ( isLeftPressed() ) { inputs |= INPUT_LEFT; }
+  if ( isRightPressed() ) { inputs |= INPUT_RIGHT; }
+  if ( isUpPressed() ) { inputs |= INPUT_UP; }
+  if ( isDownPressed() ) { inputs |= INPUT_DOWN; }
+  if ( isFirePressed() ) { inputs |= INPUT_FIRE; }
+  return( inputs );
+}
+
+#ifdef _ENABLE_INPUT_RECORDER_
+
+#if defined(__AVR__)
+  #include <avr/eeprom.h>
+  #define readRecording( address )          eeprom_read_byte( ( const uint8_t * )( address ) )
+  #define writeRecording( address, value )  eeprom_update_byte( ( uint8_t * )( address ), value )
+#else
+  uint8_t inputRecording[INPUT_RECORDING_SIZE];
+  #define readRecording( address )          inputRecording[address]
+  #define writeRecording( address, value )  inputRecording[address] = ( value )
+#endif
+
+// size of the seed at the beginning of the recording
+#define SEED_SIZE  2
+// an event holds the frames since the last change in the upper 3 bits
+#define EVENT_FRAMES_SHIFT  5
+#define MAX_EVENT_FRAMES    6
+// a pause holds the number of frames / PAUSE_FRAMES - 1 in the lower 5 bits
+#define INPUT_PAUSE         0xe0
+#define PAUSE_FRAMES        ( MAX_EVENT_FRAMES + 1 )
+#define MAX_PAUSE_UNITS     31
+
+uint8_t inputRecorderMode;
+bool inputRecorderFull;
+
+// position of the next event
+static uint16_t eventAddress;
+// frames since the last event
+static uint16_t eventFrames;
+// inputs of the last event
+static uint8_t currentInputs;
+// replay: frames before the next event and its inputs (INPUT_END at the end)
+static uint16_t nextEventFrames;
+static uint8_t nextInputs;
+
+/*-------------------------------------------------------*/
+// replays the recording if the fire button is pressed at power on
+void initInputRecorder()
+{
+#if defined(__AVR__)
+  if ( isFirePressed() ) { inputRecorderMode = INPUT_REPLAY; }
+#endif
+}
+
+/*-------------------------------------------------------*/
+// reads the next event of the replay (and the pauses in front of it)
+static void readNextEvent()
+{
+  nextEventFrames = 0;
+  while ( eventAddress < INPUT_RECORDING_SIZE )
+  {
+    const uint8_t value = readRecording( eventAddress );
+    if ( value == INPUT_END ) { break; }
+    eventAddress++;
+
+    if ( value < INPUT_PAUSE )
+    {
+      nextEventFrames += value >> EVENT_FRAMES_SHIFT;
+      nextInputs = value & INPUT_MASK;
+      return;
+    }
+    nextEventFrames += ( ( value & ~INPUT_PAUSE ) + 1 ) * PAUSE_FRAMES;
+  }
+  nextInputs = INPUT_END;
+}
+
+/*-------------------------------------------------------*/
+// Starts a recording (returns the seed) or a replay (returns the recorded seed)
+uint16_t inputRecorderStart( const uint16_t seed )
+{
+  eventAddress = SEED_SIZE;
+  eventFrames = 0;
+  currentInputs = INPUT_NONE;
+  inputRecorderFull = false;
+
+  if ( inputRecorderMode == INPUT_REPLAY )
+  {
+    readNextEvent();
+    return( readRecording( 0 ) | ( readRecording( 1 ) << 8 ) );
+  }
+
+  writeRecording( 0, uint8_t( seed ) );
+  writeRecording( 1, uint8_t( seed >> 8 ) );
+  writeRecording( SEED_SIZE, INPUT_END );
+  return( seed );
+}
+
+/*-------------------------------------------------------*/
+// appends a byte, the recording is terminated at any time
+static void recordByte( const uint8_t value )
+{
+  writeRecording( eventAddress + 1, INPUT_END );
+  writeRecording( eventAddress, value );
+  eventAddress++;
+}
+
+/*-------------------------------------------------------*/
+// appends an event and the pauses in front of it, or stops the recording if it's full
+static void recordEvent( uint16_t frames, const uint8_t inputs )
+{
+  if ( inputRecorderFull ) { return; }
+
+  // pauses + event + end marker
+  const uint16_t pauses = ( frames + PAUSE_FRAMES * MAX_PAUSE_UNITS - 1UL - MAX_EVENT_FRAMES ) / ( PAUSE_FRAMES * MAX_PAUSE_UNITS );
+  if ( eventAddress + pauses + 2 > INPUT_RECORDING_SIZE )
+  {
+    inputRecorderFull = true;
+    return;
+  }
+
+  while ( frames > MAX_EVENT_FRAMES )
+  {
+    uint8_t units = frames / PAUSE_FRAMES;
+    if ( units > MAX_PAUSE_UNITS ) { units = MAX_PAUSE_UNITS; }
+    recordByte( INPUT_PAUSE | ( units - 1 ) );
+    frames -= units * PAUSE_FRAMES;
+  }
+  recordByte( ( frames << EVENT_FRAMES_SHIFT ) | inputs );
+}
+
+/*-------------------------------------------------------*/
+// returns the replayed inputs
+static uint8_t replayInputs()
+{
+  // at most one event per call, so the game sees every change
+  if ( nextInputs == INPUT_END )
+  {
+    // nothing left to replay
+  #if defined(__AVR__)
+    currentInputs = INPUT_NONE;
+  #else
+    throw INPUT_REPLAY_FINISHED();
+  #endif
+  }
+  else if ( eventFrames >= nextEventFrames )
+  {
+    // the next event is due
+    currentInputs = nextInputs;
+    eventFrames = 0;
+    readNextEvent();
+  }
+  return( currentInputs );
+}
+
+/*-------------------------------------------------------*/
+// reads the inputs (and records every change) or replays them
+uint8_t readInputs()
+{
+  if ( inputRecorderMode == INPUT_REPLAY ) { return( replayInputs() ); }
+
+  const uint8_t inputs = readJoypad();
+  if ( inputs != currentInputs )
+  {
+    recordEvent( eventFrames, inputs );
+    currentInputs = inputs;
+    eventFrames = 0;
+  }
+  return( inputs );
+}
+
+/*-------------------------------------------------------*/
+// called after every frame
+void inputRecorderFrame()
+{
+  // saturate, the break is split anyway
+  if ( eventFrames < 0xffff ) { eventFrames++; }
+}
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+// Input recording and deterministic replay
+//
+// The game reads all inputs at once with readInputs() (a bit mask of INPUT_LEFT...).
+// With _ENABLE_INPUT_RECORDER_ every change of the inputs is recorded together with
+// the number of frames since the last change, so a game can be replayed exactly:
+//   - on AVR the recording is stored in the EEPROM (512 bytes on the ATtiny85)
+//   - on the host it's kept in 'inputRecording[]', the host program loads
+//     and saves it (see host/walkthrough.cpp)
+// The dice only depend on their seed while the recorder is enabled, the seed
+// (timer at the start of the game) is stored at the beginning of the recording.
+//
+// A change takes one byte, a longer break one more byte per 217 frames. Every step,
+// turn or attack is a press and a release, so the 243 actions of a walkthrough of
+// Level_1 take 489 bytes (levels/Level_1.rec) - that fits into the ATtiny85, but
+// longer games don't. A full recording stops and sets 'inputRecorderFull',
+// the replay ends there.
+//
+// Format:
+//   seed[2] (little endian), { event | pause }*, INPUT_END
+//   event: 'fffiiiii' - the inputs change to 'iiiii' (INPUT_LEFT...INPUT_FIRE)
+//          'fff' (0..6) frames (renderImage() calls) after the last change
+//   pause: '111nnnnn' (n < 31) - 7 * ( n + 1 ) more frames before the next event
+//
+// Replay: a recorded change is applied at the first input poll after its frame,
+// at most one per poll, so the game sees every change. On AVR, the replay starts if
+// the fire button is pressed at power on. Every new game starts the replay again,
+// at the end of the recording the game just waits (on the host, INPUT_REPLAY_FINISHED is thrown).
+// Note: every recorded byte writes up to 2 bytes to the EEPROM (~3.4 ms each on AVR).
+
+#include <Arduino.h>
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to record the inputs
+//#define _ENABLE_INPUT_RECORDER_
+
+#if defined(_ENABLE_INPUT_RECORDER_) && !defined(__AVR__) && !defined(ARDUINO_ARCH_HOST)
+  #error "The input recorder requires an EEPROM (AVR) or the host!"
+#endif
+
+// input bits
+#define INPUT_NONE   0x00
+#define INPUT_LEFT   0x01
+#define INPUT_RIGHT  0x02
+#define INPUT_UP     0x04
+#define INPUT_DOWN   0x08
+#define INPUT_FIRE   0x10
+// all input bits
+#define INPUT_MASK   0x1f
+// end of the recording (erased EEPROM)
+#define INPUT_END    0xff
+
+// recorder modes
+enum
+{
+  INPUT_RECORD = 0,
+  INPUT_REPLAY,
+};
+
+#if defined(__AVR__)
+  #define INPUT_RECORDING_SIZE  ( E2END + 1 )
+#else
+  #define INPUT_RECORDING_SIZE  4096
+#endif
+
+// reads all inputs from the joypad
+uint8_t readJoypad();
+
+#ifdef _ENABLE_INPUT_RECORDER_
+  extern uint8_t inputRecorderMode;
+  // set when the recording has been stopped, because it's full
+  extern bool inputRecorderFull;
+  #if !defined(__AVR__)
+    extern uint8_t inputRecording[INPUT_RECORDING_SIZE];
+    class INPUT_REPLAY_FINISHED {};
+  #endif
+
+  void initInputRecorder();
+  uint16_t inputRecorderStart( const uint16_t seed );
+  uint8_t readInputs();
+  void inputRecorderFrame();
+
+  #define INIT_INPUT_RECORDER()  initInputRecorder()
+  #define INPUT_RECORDER_FRAME()  inputRecorderFrame()
+#else
+  inline uint8_t readInputs() { return( readJoypad() ); }
+
+  #define INIT_INPUT_RECORDER()
+  #define INPUT_RECORDER_FRAME()
+#endif
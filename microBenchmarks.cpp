@@ -0,0 +1,256 @@
+//
+// Micro benchmarks, see microBenchmarks.h for details.
+//
+
+#include <Arduino.h>
+#include "dungeon.h"
+#include "microBenchmarks.h"
+
+#ifdef _ENABLE_MICRO_BENCHMARKS_
+
+// the results are stored, so the compiler can't optimize the kernels away
+volatile uint8_t microBenchmarkResult;
+
+// keeps the cell of the level
+const uint8_t KEEP = 0xff;
+
+// a view of the corpus
+class MICRO_BENCHMARK_VIEW
+{
+public:
+  int8_t  playerX;
+  int8_t  playerY;
+  uint8_t dir;
+  // cells in front of the player (distance 0..3, offset -2..+2)
+  uint8_t cells[MAX_VIEW_DISTANCE + 1][5];
+};
+
+const MICRO_BENCHMARK_VIEW microBenchmarkViews[] PROGMEM = {
+  // start position of the level
+  { 1, 1, EAST, { { KEEP, KEEP, KEEP, KEEP, KEEP },
+                  { KEEP, KEEP, KEEP, KEEP, KEEP },
+                  { KEEP, KEEP, KEEP, KEEP, KEEP },
+                  { KEEP, KEEP, KEEP, KEEP, KEEP } } },
+  // open hall with a beholder at distance 1 and bars behind
+  { 1, 1, EAST, { { 0, 0, 0       , 0, 0 },
+                  { 0, 0, BEHOLDER, 0, 0 },
+                  { 0, 0, BARS    , 0, 0 },
+                  { 0, 0, 0       , 0, 0 } } },
+  // open hall with a skeleton at distance 2 and a door behind
+  { 1, 1, EAST, { { 0, 0, 0       , 0, 0 },
+                  { 0, 0, 0       , 0, 0 },
+                  { 0, 0, SKELETON, 0, 0 },
+                  { 0, 0, DOOR    , 0, 0 } } },
+  // corridor with a fountain at the end
+  { 1, 1, EAST, { { WALL, WALL, 0       , WALL, WALL },
+                  { WALL, WALL, 0       , WALL, WALL },
+                  { WALL, WALL, 0       , WALL, WALL },
+                  { WALL, WALL, FOUNTAIN, WALL, WALL } } },
+  // a rat and a chest in front of a lever
+  { 1, 1, EAST, { { 0, WALL, 0           , WALL, 0 },
+                  { 0, 0   , RAT         , 0   , 0 },
+                  { 0, 0   , CLOSED_CHEST, 0   , 0 },
+                  { 0, 0   , LVR_LEFT    , 0   , 0 } } },
+  // plain wall right in front of the player
+  { 1, 1, EAST, { { 0, 0, 0   , 0, 0 },
+                  { 0, 0, WALL, 0, 0 },
+                  { 0, 0, 0   , 0, 0 },
+                  { 0, 0, 0   , 0, 0 } } },
+};
+
+/*-------------------------------------------------------*/
+// Sets up the dungeon for a view of the corpus
+static void setupView( Dungeon &dungeon, const MICRO_BENCHMARK_VIEW *viewPtr )
+{
+  MICRO_BENCHMARK_VIEW view;
+  memcpy_P( &view, viewPtr, sizeof( view ) );
+
+  dungeon.init();
+  dungeon._dungeon.playerX = view.playerX;
+  dungeon._dungeon.playerY = view.playerY;
+  dungeon._dungeon.dir = view.dir;
+
+  for ( int8_t distance = 0; distance <= MAX_VIEW_DISTANCE; distance++ )
+  {
+    for ( int8_t offsetLR = -2; offsetLR <= 2; offsetLR++ )
+    {
+      uint8_t cellValue = view.cells[distance][offsetLR + 2];
+      if ( cellValue != KEEP )
+      {
+        *dungeon.getCellRaw( view.playerX, view.playerY, distance, offsetLR, view.dir ) = cellValue;
+      }
+    }
+  }
+  dungeon.levelModified();
+  dungeon.updatePotentiallyVisibleSet();
+}
+
+/*-------------------------------------------------------*/
+// Wall search of the whole view
+static void benchmarkWalls( Dungeon &dungeon )
+{
+  uint8_t result = 0;
+
+  MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_WALLS );
+#ifdef _USE_VERTICAL_ADDRESSING_
+  uint8_t columnPixels[8];
+  for ( uint8_t x = 0; x < WINDOW_SIZE_X; x++ )
+  {
+    dungeon.getWallColumn( x, columnPixels );
+    result ^= columnPixels[x & 0x07];
+  }
+#else
+  for ( uint8_t y = 0; y < 8; y++ )
+  {
+    for ( uint8_t x = 0; x < WINDOW_SIZE_X; x++ )
+    {
+      result ^= dungeon.getWallPixels( x, y );
+    }
+  }
+#endif
+  MICRO_BENCHMARK_END();
+
+  microBenchmarkResult = result;
+}
+
+/*-------------------------------------------------------*/
+// Lookup of all cells of the field of view
+static void benchmarkCellLookup( Dungeon &dungeon )
+{
+  uint8_t result = 0;
+
+  MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_CELL_LOOKUP );
+  for ( int8_t distance = 0; distance <= MAX_VIEW_DISTANCE; distance++ )
+  {
+    for ( int8_t offsetLR = -2; offsetLR <= 2; offsetLR++ )
+    {
+      result ^= *dungeon.getCellRaw( dungeon._dungeon.playerX, dungeon._dungeon.playerY, distance, offsetLR, dungeon._dungeon.dir );
+    }
+  }
+  MICRO_BENCHMARK_END();
+
+  microBenchmarkResult = result;
+}
+
+/*-------------------------------------------------------*/
+// Scaling of every object (mask and bitmap) at every distance
+static void benchmarkScaling( Dungeon &dungeon )
+{
+  NON_WALL_OBJECT object;
+
+  for ( uint8_t n = 0; n < sizeof( objectList ) / sizeof( objectList[0] ); n++ )
+  {
+    memcpy_P( &object, &objectList[n], sizeof( object ) );
+
+    for ( uint8_t distance = 1; distance <= MAX_VIEW_DISTANCE; distance++ )
+    {
+      uint8_t result = 0;
+      // all columns of the object on the screen
+      uint8_t screenWidth = ( object.bitmapWidth >> distance ) * 2;
+
+      MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_SCALE_D1 + distance - 1 );
+      for ( uint8_t y = 0; y < 8; y++ )
+      {
+        for ( uint8_t x = 0; x < screenWidth; x++ )
+        {
+          result ^= dungeon.getDownScaledBitmapData( x, y, distance, &object, true );
+          result ^= dungeon.getDownScaledBitmapData( x, y, distance, &object, false );
+        }
+      }
+      MICRO_BENCHMARK_END();
+
+      microBenchmarkResult = result;
+    }
+  }
+}
+
+/*-------------------------------------------------------*/
+// Interaction with every lever, chest, door and fountain of the level
+static void benchmarkInteraction( Dungeon &dungeon )
+{
+  for ( uint16_t position = 0; position < MAX_LEVEL_BYTES; position++ )
+  {
+    dungeon.init();
+
+    uint8_t *cell = dungeon._dungeon.currentLevel + position;
+    const uint8_t cellValue = *cell;
+    const uint8_t object = cellValue & OBJECT_MASK;
+
+    // nothing to interact with?
+    if ( ( object == EMPTY ) || ( object == FAKE_WALL ) || ( object == WALL ) || ( cellValue & FLAG_MONSTER ) ) { continue; }
+
+    MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_INTERACTION );
+    dungeon.playerInteraction( cell, cellValue );
+    MICRO_BENCHMARK_END();
+  }
+}
+
+/*-------------------------------------------------------*/
+// Search of every monster
+static void benchmarkFindMonster( Dungeon &dungeon )
+{
+  dungeon.init();
+
+  for ( uint8_t n = 0; n < MAX_MONSTERS; n++ )
+  {
+    const uint8_t position = dungeon._dungeon.monsterStats[n].position;
+
+    MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_FIND_MONSTER );
+    MONSTER_STATS *monster = dungeon.findMonster( position );
+    MICRO_BENCHMARK_END();
+
+    microBenchmarkResult = monster ? monster->hitpoints : 0;
+  }
+}
+
+/*-------------------------------------------------------*/
+// A row of pixel bytes to the display, byte by byte and as a run
+// (the picture is replaced by the first frame of the game)
+static void benchmarkDisplay()
+{
+  const uint8_t *pixels = smallFrontWall_D1;
+
+  for ( uint8_t y = 0; y < 8; y++ )
+  {
+    PrepareDisplayRow( y );
+    MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_SEND_PIXELS );
+    for ( uint8_t x = 0; x < MICRO_BENCHMARK_ROW_BYTES; x++ )
+    {
+      SendPixels( pgm_read_byte( pixels + x ) );
+    }
+    MICRO_BENCHMARK_END();
+    FinishDisplayRow();
+
+    PrepareDisplayRow( y );
+    MICRO_BENCHMARK_BEGIN( MICRO_BENCHMARK_SEND_RUN );
+    SendPixelRun_P( pixels, MICRO_BENCHMARK_ROW_BYTES );
+    MICRO_BENCHMARK_END();
+    FinishDisplayRow();
+  }
+}
+
+/*-------------------------------------------------------*/
+// Runs all kernels (the dungeon is initialized afterwards)
+void runMicroBenchmarks( Dungeon &dungeon )
+{
+  for ( uint8_t n = 0; n < sizeof( microBenchmarkViews ) / sizeof( microBenchmarkViews[0] ); n++ )
+  {
+    setupView( dungeon, microBenchmarkViews + n );
+    benchmarkWalls( dungeon );
+    benchmarkCellLookup( dungeon );
+  }
+
+  benchmarkScaling( dungeon );
+  benchmarkInteraction( dungeon );
+  benchmarkFindMonster( dungeon );
+  benchmarkDisplay();
+
+#if defined(__AVR__)
+  // tell the simavr harness that all kernels have been run
+  GPIOR0 = MICRO_BENCHMARKS_DONE;
+#endif
+
+  dungeon.init();
+}
+
+#endif
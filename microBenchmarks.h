@@ -0,0 +1,72 @@
+#pragma once
+
+// Micro benchmarks of the hot functions
+//
+// runMicroBenchmarks() calls every kernel on a corpus of worst case views
+// (e.g. an open hall with a beholder at distance 1 and bars behind it):
+//   walls         - getWallPixels() (getWallColumn() in vertical mode) for the whole view
+//   cellLookup    - getCellRaw() for every cell of the field of view
+//   scaleD1..D3   - getDownScaledBitmapData() for every object, mask and bitmap, at distance 1..3
+//   interaction   - playerInteraction() for every interactive cell of the level (includes the sound)
+//   findMonster   - findMonster() for every monster
+//   sendPixels    - a row of MICRO_BENCHMARK_ROW_BYTES bytes through SendPixels() (byte by byte)
+//   sendRun       - the same row through SendPixelRun_P()
+// The display kernels only time the pixel bytes (not the page and column commands),
+// so in simavr their cycles per byte compare the display transports (ssd1306xled
+// or _USE_USI_I2C_), see the harness.
+//
+// Every kernel call is enclosed by MICRO_BENCHMARK_BEGIN()/MICRO_BENCHMARK_END():
+//   - on AVR the kernel number is written to GPIOR0, the simavr harness
+//     (simavr/tinyDungeonSim.c) counts the cycles while it is set
+//     and compares them with the stored cycle budgets
+//   - on the host the functions are provided by host/microBenchmarks.cpp
+// After the last kernel, MICRO_BENCHMARKS_DONE is written to GPIOR0.
+
+#include <Arduino.h>
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to run the micro benchmarks at startup
+//#define _ENABLE_MICRO_BENCHMARKS_
+
+#if defined(_ENABLE_MICRO_BENCHMARKS_) && !defined(__AVR__) && !defined(ARDUINO_ARCH_HOST)
+  #error "The micro benchmarks only run on AVR (simavr) or on the host!"
+#endif
+
+// benchmarked kernels (0 = no kernel running)
+enum
+{
+  MICRO_BENCHMARK_WALLS = 1,
+  MICRO_BENCHMARK_CELL_LOOKUP,
+  MICRO_BENCHMARK_SCALE_D1,
+  MICRO_BENCHMARK_SCALE_D2,
+  MICRO_BENCHMARK_SCALE_D3,
+  MICRO_BENCHMARK_INTERACTION,
+  MICRO_BENCHMARK_FIND_MONSTER,
+  MICRO_BENCHMARK_SEND_PIXELS,
+  MICRO_BENCHMARK_SEND_RUN,
+  MICRO_BENCHMARKS,
+  MICRO_BENCHMARKS_DONE = 0xff,
+};
+
+// bytes per call of the display kernels
+#define MICRO_BENCHMARK_ROW_BYTES  128
+
+#ifdef _ENABLE_MICRO_BENCHMARKS_
+  class Dungeon;
+  void runMicroBenchmarks( Dungeon &dungeon );
+
+  #if defined(__AVR__)
+    #define MICRO_BENCHMARK_BEGIN( kernel )  GPIOR0 = ( kernel )
+    #define MICRO_BENCHMARK_END()            GPIOR0 = 0
+  #else
+    // provided by the host program
+    void microBenchmarkBegin( const uint8_t kernel );
+    void microBenchmarkEnd();
+    #define MICRO_BENCHMARK_BEGIN( kernel )  microBenchmarkBegin( kernel )
+    #define MICRO_BENCHMARK_END()            microBenchmarkEnd()
+  #endif
+
+  #define RUN_MICRO_BENCHMARKS( dungeon )  runMicroBenchmarks( dungeon )
+#else
+  #define RUN_MICRO_BENCHMARKS( dungeon )
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+// Pixel sinks receive the output of Dungeon::renderImage().
+// The renderer is a template on the sink type, so all calls are resolved
+// at compile time and can be inlined completely.
+//
+// Every sink provides the same functions:
+//   prepareRow( y, startColumn )               - page addressing: start row <y>
+//   finishRow()                                - page addressing: row is complete
+//   prepareColumns( startColumn, endColumn )   - vertical addressing: start output
+//   finishColumns()                            - vertical addressing: output is complete
+//   send( pixels )                             - 8 vertical pixels
+//   sendRun( pixels, count )                   - <count> bytes from RAM
+//   sendRun_P( pixels, count )                 - <count> bytes from flash
+//   finishFrame()                              - the whole frame is complete
+//   isDisplay                                  - true if the sink is the real display
+
+#include <Arduino.h>
+#include "tinyJoypadUtils.h"
+
+// the real display (SSD1306 via I2C on the ATtiny85, Adafruit_SSD1306 buffer otherwise)
+class DISPLAY_SINK
+{
+public:
+  static constexpr bool isDisplay = true;
+
+  void prepareRow( uint8_t y, uint8_t startColumn ) { PrepareDisplayRow( y, startColumn ); }
+  void finishRow() { FinishDisplayRow(); }
+#ifdef _USE_VERTICAL_ADDRESSING_
+  void prepareColumns( uint8_t startColumn, uint8_t endColumn ) { PrepareDisplayColumns( startColumn, endColumn ); }
+  void finishColumns() { FinishDisplayColumns(); }
+#endif
+  void send( uint8_t pixels ) { SendPixels( pixels ); }
+  void sendRun( const uint8_t *pixels, uint8_t count ) { SendPixelRun( pixels, count ); }
+  void sendRun_P( const uint8_t *pixels, uint8_t count ) { SendPixelRun_P( pixels, count ); }
+  void finishFrame() { DisplayBuffer(); }
+};
+
+// a 128x64 frame buffer in RAM (same layout as the display: 8 rows of 128 bytes)
+class FRAMEBUFFER_SINK
+{
+public:
+  static constexpr bool isDisplay = false;
+
+  FRAMEBUFFER_SINK( uint8_t *frameBuffer ) : buffer( frameBuffer ), position( frameBuffer ), page( 0xff ) {}
+
+  void prepareRow( uint8_t y, uint8_t startColumn ) { position = buffer + y * 128 + startColumn; }
+  void finishRow() {}
+  void prepareColumns( uint8_t startColumn, uint8_t /*endColumn*/ ) { position = buffer + startColumn; page = 0; }
+  void finishColumns() { page = 0xff; }
+  void send( uint8_t pixels )
+  {
+    if ( page != 0xff )
+    {
+      // vertical addressing: move down one page, then to the top of the next column
+      *position = pixels;
+      position += 128;
+      if ( ++page == 8 )
+      {
+        page = 0;
+        position -= 8 * 128 - 1;
+      }
+      return;
+    }
+    *position++ = pixels;
+  }
+  void sendRun( const uint8_t *pixels, uint8_t count ) { while ( count-- ) { send( *pixels++ ); } }
+  void sendRun_P( const uint8_t *pixels, uint8_t count ) { while ( count-- ) { send( pgm_read_byte( pixels++ ) ); } }
+  void finishFrame() {}
+
+  uint8_t *buffer;
+  uint8_t *position;
+  uint8_t page;
+};
+
+// calculates a FNV-1a hash over all bytes sent (in the order they were sent)
+class HASH_SINK
+{
+public:
+  static constexpr bool isDisplay = false;
+
+  HASH_SINK() : hash( 2166136261UL ), byteCount( 0 ) {}
+
+  void prepareRow( uint8_t /*y*/, uint8_t /*startColumn*/ ) {}
+  void finishRow() {}
+  void prepareColumns( uint8_t /*startColumn*/, uint8_t /*endColumn*/ ) {}
+  void finishColumns() {}
+  void send( uint8_t pixels ) { hash = ( hash ^ pixels ) * 16777619UL; byteCount++; }
+  void sendRun( const uint8_t *pixels, uint8_t count ) { while ( count-- ) { send( *pixels++ ); } }
+  void sendRun_P( const uint8_t *pixels, uint8_t count ) { while ( count-- ) { send( pgm_read_byte( pixels++ ) ); } }
+  void finishFrame() {}
+
+  uint32_t hash;
+  uint16_t byteCount;
+};
+
+// discards everything (to measure the pure render time)
+class NULL_SINK
+{
+public:
+  static constexpr bool isDisplay = false;
+
+  void prepareRow( uint8_t /*y*/, uint8_t /*startColumn*/ ) {}
+  void finishRow() {}
+  void prepareColumns( uint8_t /*startColumn*/, uint8_t /*endColumn*/ ) {}
+  void finishColumns() {}
+  // the pixels are stored, so the compiler can't optimize the renderer away
+  void send( uint8_t pixels ) { lastPixels = pixels; }
+  void sendRun( const uint8_t * /*pixels*/, uint8_t /*count*/ ) {}
+  void sendRun_P( const uint8_t * /*pixels*/, uint8_t /*count*/ ) {}
+  void finishFrame() {}
+
+  volatile uint8_t lastPixels;
+};
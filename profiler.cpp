@@ -0,0 +1,147 @@
+//
+// Per stage profiler, see profiler.h for details.
+//
+
+#include <Arduino.h>
+#include "profiler.h"
+
+#ifdef _ENABLE_PROFILER_
+
+#if defined(__AVR__)
+  #include <avr/interrupt.h>
+  #include "tinyJoypadUtils.h"
+  #include "ssd1306TWI.h"
+  // timer 1 runs at full cpu clock, the overflows extend it to 32 bits
+  #define PROFILER_UNIT  F("cycles")
+  static volatile uint16_t timer1Overflows;
+
+  ISR( TIMER1_OVF_vect )
+  {
+    timer1Overflows++;
+  }
+#else
+  #define PROFILER_UNIT  F("us")
+#endif
+
+PROFILER_STAGE profilerStages[PROFILE_STAGES];
+
+// stage names for the report
+const char profilerStageNames[PROFILE_STAGES][9] PROGMEM = {
+  "render",
+  "walls",
+  "objects",
+  "status",
+  "display",
+  "sound",
+  "movement",
+  "combat",
+  "wait",
+  "compute",
+};
+
+/*-------------------------------------------------------*/
+// Returns the current time (in cpu cycles on AVR, in us otherwise)
+uint32_t profilerGetTime()
+{
+#if defined(__AVR__)
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t overflows = timer1Overflows;
+  uint16_t counter = TCNT1;
+  // overflow during the last instructions? (the interrupt hasn't been executed yet)
+  if ( ( TIFR1 & ( 1 << TOV1 ) ) && ( counter < 0x8000 ) ) { overflows++; }
+  SREG = oldSREG;
+  return( ( uint32_t( overflows ) << 16 ) | counter );
+#else
+  return( micros() );
+#endif
+}
+
+/*-------------------------------------------------------*/
+// Starts the timer and resets all statistics
+void profilerInit()
+{
+#if defined(__AVR__)
+  // normal mode, no prescaler, overflow interrupt
+  TCCR1A = 0;
+  TCCR1B = ( 1 << CS10 );
+  TIMSK1 |= ( 1 << TOIE1 );
+#endif
+  memset( profilerStages, 0, sizeof( profilerStages ) );
+}
+
+/*-------------------------------------------------------*/
+// Folds the times of the current frame into the statistics
+// and prints the report on request
+void profilerEndFrame()
+{
+#ifdef _USE_ASYNC_DISPLAY_
+  // the rows of this frame have been sent by the interrupt in the meantime
+  profilerStages[PROFILE_DISPLAY].frameTime += ssd1306TWI_takeBusyTime();
+  if ( profilerStages[PROFILE_RENDER].frameTime )
+  {
+    profilerStages[PROFILE_COMPUTE].frameTime = profilerStages[PROFILE_RENDER].frameTime - profilerStages[PROFILE_DISPLAY_WAIT].frameTime;
+  }
+#endif
+
+  PROFILER_STAGE *stage = profilerStages;
+  for ( uint8_t n = 0; n < PROFILE_STAGES; n++, stage++ )
+  {
+    // stage not used in this frame?
+    if ( !stage->frameTime ) { continue; }
+
+    if ( !stage->frameCount++ )
+    {
+      stage->minTime = stage->maxTime = stage->frameTime;
+    }
+    else
+    {
+      if ( stage->frameTime < stage->minTime ) { stage->minTime = stage->frameTime; }
+      if ( stage->frameTime > stage->maxTime ) { stage->maxTime = stage->frameTime; }
+    }
+    // the very first frame initializes the average
+    stage->avgTime = stage->avgTime ? stage->avgTime - stage->avgTime / 8 + stage->frameTime / 8 : stage->frameTime;
+
+    stage->frameTime = 0;
+  }
+
+  if ( _PROFILER_REPORT_TRIGGER_CONDITION_ )
+  {
+    profilerReport();
+  }
+}
+
+/*-------------------------------------------------------*/
+// Prints min/avg/max of all stages and restarts min/max
+void profilerReport()
+{
+  Serial.print( F("stage     frames  min/avg/max [") ); Serial.print( PROFILER_UNIT ); Serial.println( F("]") );
+
+  PROFILER_STAGE *stage = profilerStages;
+  for ( uint8_t n = 0; n < PROFILE_STAGES; n++, stage++ )
+  {
+    char name[sizeof( profilerStageNames[0] )];
+    strcpy_P( name, profilerStageNames[n] );
+    Serial.print( name );
+    for ( uint8_t pos = strlen( name ); pos < 10; pos++ ) { Serial.print( ' ' ); }
+    Serial.print( stage->frameCount ); Serial.print( F("  ") );
+    Serial.print( stage->minTime ); Serial.print( '/' );
+    Serial.print( stage->avgTime ); Serial.print( '/' );
+    Serial.println( stage->maxTime );
+
+    // min/max are collected again from now on
+    stage->frameCount = 0;
+    stage->minTime = 0;
+    stage->maxTime = 0;
+  }
+
+#ifdef _USE_ASYNC_DISPLAY_
+  // the frame time of the pipeline (averages)
+  const uint32_t compute = profilerStages[PROFILE_COMPUTE].avgTime;
+  const uint32_t transfer = profilerStages[PROFILE_DISPLAY].avgTime;
+  Serial.print( F("pipeline  max( compute, transfer ) = ") ); Serial.print( compute > transfer ? compute : transfer );
+  Serial.print( F(", render = ") ); Serial.println( profilerStages[PROFILE_RENDER].avgTime );
+#endif
+}
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+// Per stage profiler (not available on the ATtiny85 - no timer and no serial port to spare)
+//
+// Every stage accumulates its time over one frame (one iteration of the game loop),
+// so stages called many times per frame (like the wall search for every byte) are
+// summed up. PROFILER_END_FRAME() folds the sums into min/avg/max per stage:
+//   - min/max since the last report
+//   - avg is a rolling average over the last frames (weight 1/8 for the newest frame)
+// Stages are inclusive: e.g. combat contains the frames rendered during the fight.
+//
+// With _USE_ASYNC_DISPLAY_ the rows are sent while the next ones are rendered, so
+// 'display' is the time the TWI has been busy (measured by its interrupt), 'wait' the
+// time the renderer waited for the bus and 'compute' the render time without these
+// waits. The report adds max( compute, transfer ), which the render time should
+// approach if the pipeline works.
+//
+// The report is printed to the serial port if the trigger condition is met.
+// With _ENABLE_PROFILER_ undefined, all macros expand to nothing.
+
+#include <Arduino.h>
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to enable the profiler
+//#define _ENABLE_PROFILER_
+// print the report if this condition is true (checked once per frame):
+#define _PROFILER_REPORT_TRIGGER_CONDITION_ ( Serial.available() && ( Serial.read() == 'p' ) )
+
+#if defined(_ENABLE_PROFILER_) && defined(__AVR_ATtiny85__)
+  #error "The profiler is not available on the ATtiny85!"
+#endif
+
+// profiled stages
+enum
+{
+  PROFILE_RENDER = 0,   // renderImage() as a whole
+  PROFILE_WALLS,        // wall search in getWallPixels()/getWallColumn()
+  PROFILE_OBJECTS,      // NWO scaling and masking
+  PROFILE_STATUS,       // status pane
+  PROFILE_DISPLAY,      // display transfer (DisplayBuffer(), the busy TWI with _USE_ASYNC_DISPLAY_)
+  PROFILE_SOUND,        // sound effects including their delays
+  PROFILE_MOVEMENT,     // special cells and interactions in playerInput()
+  PROFILE_COMBAT,       // a whole combat round
+  PROFILE_DISPLAY_WAIT, // renderer waiting for the TWI (_USE_ASYNC_DISPLAY_)
+  PROFILE_COMPUTE,      // render without the waits for the TWI (_USE_ASYNC_DISPLAY_)
+  PROFILE_STAGES,
+};
+
+#ifdef _ENABLE_PROFILER_
+
+// statistics of a single stage
+class PROFILER_STAGE
+{
+public:
+  // start time of the running measurement
+  uint32_t startTime;
+  // accumulated time of the current frame
+  uint32_t frameTime;
+  // frames with at least one measurement since the last report
+  uint16_t frameCount;
+  uint32_t minTime;
+  uint32_t maxTime;
+  uint32_t avgTime;
+};
+
+uint32_t profilerGetTime();
+void profilerInit();
+void profilerEndFrame();
+void profilerReport();
+
+extern PROFILER_STAGE profilerStages[PROFILE_STAGES];
+
+  #define PROFILER_INIT()          profilerInit()
+  #define PROFILER_START( stage )  profilerStages[stage].startTime = profilerGetTime()
+  #define PROFILER_STOP( stage )   profilerStages[stage].frameTime += profilerGetTime() - profilerStages[stage].startTime
+  #define PROFILER_END_FRAME()     profilerEndFrame()
+#else
+  #define PROFILER_INIT()
+  #define PROFILER_START( stage )
+  #define PROFILER_STOP( stage )
+  #define PROFILER_END_FRAME()
+#endif
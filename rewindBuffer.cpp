@@ -0,0 +1,132 @@
+//
+// Rewind ring buffer, see rewindBuffer.h for details.
+//
+
+#include <Arduino.h>
+#include "rewindBuffer.h"
+
+#ifdef _ENABLE_REWIND_
+
+// size fields at both ends of an action
+#define ACTION_OVERHEAD  4
+
+/*-------------------------------------------------------*/
+static inline uint16_t nextPosition( const uint16_t position )
+{
+  return( ( position + 1 < REWIND_BUFFER_SIZE ) ? position + 1 : 0 );
+}
+
+/*-------------------------------------------------------*/
+void REWIND_BUFFER::reset( const DUNGEON &state )
+{
+  lastState = state;
+  firstByte = 0;
+  bytesUsed = 0;
+  actions = 0;
+}
+
+/*-------------------------------------------------------*/
+// size field at 'position'
+uint16_t REWIND_BUFFER::getSize( const uint16_t position ) const
+{
+  return( buffer[position] | ( buffer[nextPosition( position )] << 8 ) );
+}
+
+/*-------------------------------------------------------*/
+// appends a byte (there must be room for it)
+void REWIND_BUFFER::putByte( const uint8_t value )
+{
+  uint16_t position = firstByte + bytesUsed;
+  if ( position >= REWIND_BUFFER_SIZE ) { position -= REWIND_BUFFER_SIZE; }
+  buffer[position] = value;
+  bytesUsed++;
+}
+
+/*-------------------------------------------------------*/
+void REWIND_BUFFER::record( const DUNGEON &state )
+{
+  uint8_t *last = ( uint8_t * )&lastState;
+  const uint8_t *current = ( const uint8_t * )&state;
+
+  // the size of the pairs first (gaps > 255 take an extra pair per 256 bytes)
+  uint16_t size = 0;
+  uint16_t gap = 0;
+  for ( uint16_t n = 0; n < sizeof( DUNGEON ); n++ )
+  {
+    if ( last[n] == current[n] ) { gap++; continue; }
+    size += 2 + 2 * ( gap >> 8 );
+    gap = 0;
+  }
+
+  if ( size + ACTION_OVERHEAD > REWIND_BUFFER_SIZE )
+  {
+    // doesn't fit at all, the history is lost
+    reset( state );
+    return;
+  }
+
+  // drop the oldest actions until there's room
+  while ( bytesUsed + size + ACTION_OVERHEAD > REWIND_BUFFER_SIZE )
+  {
+    const uint16_t oldestSize = getSize( firstByte ) + ACTION_OVERHEAD;
+    firstByte += oldestSize;
+    if ( firstByte >= REWIND_BUFFER_SIZE ) { firstByte -= REWIND_BUFFER_SIZE; }
+    bytesUsed -= oldestSize;
+    actions--;
+  }
+
+  putByte( uint8_t( size ) );
+  putByte( uint8_t( size >> 8 ) );
+
+  // the old values of the changed bytes
+  gap = 0;
+  for ( uint16_t n = 0; n < sizeof( DUNGEON ); n++ )
+  {
+    if ( last[n] == current[n] ) { gap++; continue; }
+    while ( gap > 255 )
+    {
+      // bridge with an unchanged byte
+      putByte( 255 );
+      putByte( last[n - gap + 255] );
+      gap -= 256;
+    }
+    putByte( uint8_t( gap ) );
+    putByte( last[n] );
+    last[n] = current[n];
+    gap = 0;
+  }
+
+  putByte( uint8_t( size ) );
+  putByte( uint8_t( size >> 8 ) );
+  actions++;
+}
+
+/*-------------------------------------------------------*/
+bool REWIND_BUFFER::stepBack()
+{
+  if ( !actions ) { return( false ); }
+
+  // the newest action is at the end
+  uint16_t position = firstByte + bytesUsed - 2;
+  if ( position >= REWIND_BUFFER_SIZE ) { position -= REWIND_BUFFER_SIZE; }
+  const uint16_t size = getSize( position );
+  bytesUsed -= size + ACTION_OVERHEAD;
+
+  position = firstByte + bytesUsed + 2;
+  if ( position >= REWIND_BUFFER_SIZE ) { position -= REWIND_BUFFER_SIZE; }
+
+  uint8_t *last = ( uint8_t * )&lastState;
+  uint16_t offset = 0xffff;
+  for ( uint16_t n = 0; n < size; n += 2 )
+  {
+    offset += 1 + buffer[position];
+    position = nextPosition( position );
+    last[offset] = buffer[position];
+    position = nextPosition( position );
+  }
+
+  actions--;
+  return( true );
+}
+
+#endif
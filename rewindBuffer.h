@@ -0,0 +1,80 @@
+#pragma once
+
+// Rewind ring buffer of the game state
+//
+// DUNGEON is plain data, so a snapshot is just a copy (see Dungeon::saveSnapshot() and
+// Dungeon::restoreSnapshot()). Keeping a full copy for every action would eat the RAM quickly,
+// so the rewind buffer only stores what an action has changed: after every action
+// (Dungeon::playerInput()) the new state is compared to the last one and the old values of
+// the changed bytes go into a ring buffer (~6 bytes per action with the size fields,
+// 1 kB holds more than 150 actions, see host/rewindCheck.cpp).
+// record() doesn't know which bytes an action has touched, it compares the whole state
+// twice (once for the size of the entry, once for the pairs), so each action costs
+// O(sizeof(DUNGEON)), about 2 * 330 byte compares, no matter how little has changed.
+// Only stepBack() depends on the number of changed bytes alone.
+// The oldest actions are dropped if the buffer is full.
+//
+// Dungeon::rewind( actions ) steps back and restores the state. On the device, the game
+// offers it after the death of the player: DOWN goes back REWIND_ACTIONS_AFTER_DEATH actions,
+// FIRE starts a new game as before.
+//
+// Format of an action (the newest one at the end of the buffer):
+//   size[2], { gap, oldValue }*, size[2]
+// 'size' is the number of bytes of the pairs, 'gap' is the number of unchanged bytes since
+// the last pair (longer gaps are bridged with pairs of unchanged bytes).
+
+#include <Arduino.h>
+#include "dungeonTypes.h"
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to enable the rewind buffer
+// (enabled on the MCUs with plenty of RAM, on the host with -D_ENABLE_REWIND_)
+//#define _ENABLE_REWIND_
+
+#if defined(__AVR_ATmega2560__) || defined(_VARIANT_ARDUINO_ZERO_)
+  #define _ENABLE_REWIND_
+#endif
+
+#if defined(_ENABLE_REWIND_) && defined(__AVR_ATtiny85__)
+  #error "The rewind buffer doesn't fit into the RAM of the ATtiny85!"
+#endif
+
+#ifndef REWIND_BUFFER_SIZE
+  #if defined(ARDUINO_ARCH_HOST)
+    #define REWIND_BUFFER_SIZE  16384
+  #else
+    #define REWIND_BUFFER_SIZE  1024
+  #endif
+#endif
+
+// actions undone by DOWN after the death of the player
+#define REWIND_ACTIONS_AFTER_DEATH  8
+
+#ifdef _ENABLE_REWIND_
+class REWIND_BUFFER
+{
+public:
+  // forgets all actions, 'state' is the current one
+  void reset( const DUNGEON &state );
+  // stores the changes from the last state to 'state'
+  void record( const DUNGEON &state );
+  // restores the state before the last action, returns false if there's none
+  bool stepBack();
+
+  // the last recorded state
+  const DUNGEON &getState() const { return( lastState ); }
+  uint16_t getActions() const { return( actions ); }
+  uint16_t getBytesUsed() const { return( bytesUsed ); }
+
+private:
+  uint16_t getSize( const uint16_t position ) const;
+  void putByte( const uint8_t value );
+
+  DUNGEON lastState;
+  uint8_t buffer[REWIND_BUFFER_SIZE];
+  // oldest byte and bytes in use
+  uint16_t firstByte;
+  uint16_t bytesUsed;
+  uint16_t actions;
+};
+#endif
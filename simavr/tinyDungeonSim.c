@@ -0,0 +1,814 @@
+//
+// Cycle accurate benchmark of the real ATtiny85 firmware using simavr.
+//
+// The firmware (e.g. hex/TinyDungeon.ino.hex) runs on a simulated ATtiny85
+// at 16 MHz. The I2C lines (SDA = PB0, SCL = PB2) are decoded on pin level
+// and fed into a small SSD1306 model, the joypad is driven by a script.
+//
+// Build (simavr installed, e.g. via package 'libsimavr-dev' or from source):
+//   gcc -O2 -o tinyDungeonSim tinyDungeonSim.c -lsimavr -lelf
+// (add -I<simavr>/simavr/sim -L<simavr>/simavr/obj-<arch> if simavr isn't installed system wide)
+//
+// Run:
+//   ./tinyDungeonSim [-l <ms>] [-e <firmware.elf> [-k <bytes>]] <firmware.hex> <script> [screen.pbm]
+//   ./tinyDungeonSim -m [-b <budgets>] [-u] [-t <percent>] [-e <firmware.elf> [-k <bytes>]] <firmware.hex>
+//
+// Script characters (each one is an action, followed by a wait until the game is idle):
+//   L, R, U, D  - joystick left, right, up, down
+//   F           - fire button
+//   C           - fire button, measured as a combat round
+//   .           - just wait
+// Example: "RUUUC" turns right, walks three cells and attacks.
+//
+// Report:
+//   - CPU cycles of every frame (first row to last byte of the frame)
+//   - CPU cycles of every action (input to the end of the last frame it caused)
+//   - min/avg/max per frame, per move and per combat round
+//   - button to photon latency of every action (input to the first byte of the first frame),
+//     for blocked steps (no frame) the latency of the sound (first rising edge on PB4)
+//   - min/avg/max latency per action type (turn, step, blocked step, fire, combat);
+//     with -l, the exit code is 1 if any latency exceeds the given target
+// The final screen can be written as a PBM file for visual checks.
+//
+// Micro benchmarks (-m, firmware built with _ENABLE_MICRO_BENCHMARKS_, see microBenchmarks.h):
+//   The cycles are counted while GPIOR0 holds a kernel number, the report lists
+//   calls and cycles per kernel. With a budgets file (-b), every kernel is compared
+//   with its budget and the exit code is 1 if any kernel exceeds it by more than
+//   the threshold (-t, default 2%) or has no budget. -u writes the measured cycles as new budgets.
+//   The budgets of the release firmware belong into simavr/microBudgets.txt:
+//     ./tinyDungeonSim -m -u -b simavr/microBudgets.txt <firmware.hex>   (after an intended change)
+//     ./tinyDungeonSim -m -b simavr/microBudgets.txt <firmware.hex>      (the gate)
+//   The display kernels (sendPixels, sendRun) are also reported in cycles per pixel byte.
+//   Run a firmware built with ssd1306xled and one built with _USE_USI_I2C_ to compare
+//   the transports, the kernels only count cycles, so this works without USI support.
+//
+// Stack monitor (-e, firmware built with _ENABLE_STACK_MONITOR_, see stackMonitor.h):
+//   'stackMinUnusedBytes' and 'stackGuardViolations' are looked up in the symbol table
+//   of the .elf file the .hex was built from and reported at exit. The exit code is 1
+//   if the guard zone was touched or, with -k, if fewer bytes than given were never used.
+//
+// Notes:
+//   - the firmware has to use the ssd1306xled library (pin level bit banging),
+//     the USI transport (_USE_USI_I2C_) needs a simavr version with USI support (except for -m)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <gelf.h>
+
+#include <simavr/sim_avr.h>
+#include <simavr/sim_io.h>
+#include <simavr/sim_hex.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_adc.h>
+
+#define CPU_FREQUENCY    16000000UL
+#define VCC_MILLIVOLTS   5000
+
+// the SSD1306 address (0x3C) including the write bit
+#define SSD1306_ADDRESS  0x78
+
+// duration of a button press and of the idle time which ends an action
+#define PRESS_CYCLES     ( CPU_FREQUENCY / 50 )
+#define IDLE_CYCLES      ( CPU_FREQUENCY / 2 )
+
+// GPIOR0 of the ATtiny85 (I/O address 0x11) in the data space
+#define GPIOR0_ADDRESS   ( 0x11 + 0x20 )
+// maximum run time of the micro benchmarks
+#define MICRO_BENCHMARK_TIMEOUT_CYCLES  ( 60 * CPU_FREQUENCY )
+
+// data addresses in the AVR .elf files start here
+#define ELF_DATA_OFFSET  0x800000
+
+// joystick voltages (see isLeftPressed() and friends in TinyJoypadUtils.cpp)
+#define JOYSTICK_IDLE_MV  VCC_MILLIVOLTS
+#define JOYSTICK_HIGH_MV  ( 850UL * VCC_MILLIVOLTS / 1023 )   // left or down
+#define JOYSTICK_LOW_MV   ( 625UL * VCC_MILLIVOLTS / 1023 )   // right or up
+
+////////////////////////////////////////////////////////////
+// SSD1306 model
+
+typedef struct
+{
+  uint8_t  buffer[128 * 8];
+  uint8_t  addressingMode;   // 0 = horizontal, 1 = vertical, 2 = page
+  uint8_t  page;
+  uint8_t  column;
+  uint8_t  startColumn, endColumn;
+  uint8_t  startPage, endPage;
+  // command with pending arguments
+  uint8_t  command;
+  uint8_t  argumentCount;
+  uint8_t  arguments[2];
+} SSD1306_MODEL;
+
+// I2C decoder state
+typedef struct
+{
+  uint8_t  sda, scl;
+  uint8_t  active;
+  uint8_t  bitCount;
+  uint8_t  byte;
+  uint8_t  byteCount;
+  // control byte handling
+  uint8_t  isData;
+  uint8_t  continuation;   // Co bit of the last control byte
+  uint8_t  expectControl;
+} I2C_DECODER;
+
+// statistics
+typedef struct
+{
+  uint64_t count;
+  uint64_t minimum;
+  uint64_t maximum;
+  uint64_t sum;
+} STATISTICS;
+
+static avr_t *avr;
+static SSD1306_MODEL display;
+static I2C_DECODER i2c;
+
+// timing
+static uint64_t lastBusActivity;
+static uint64_t frameStart;
+static uint8_t  frameRunning;
+static uint64_t lastFrameEnd;
+static STATISTICS frameStatistics;
+static STATISTICS moveStatistics;
+static STATISTICS combatStatistics;
+
+// button to photon latency
+enum
+{
+  LATENCY_TURN = 0,
+  LATENCY_STEP,
+  LATENCY_BLOCKED_STEP,
+  LATENCY_FIRE,
+  LATENCY_COMBAT,
+  LATENCY_TYPES,
+};
+static const char *latencyNames[LATENCY_TYPES] = { "turn", "step", "blocked", "fire", "combat" };
+static STATISTICS latencyStatistics[LATENCY_TYPES];
+static uint64_t actionStart;
+static uint64_t firstFrameByte;
+static uint64_t firstSound;
+
+////////////////////////////////////////////////////////////
+// micro benchmarks
+
+// kernel names (keep in sync with the kernel numbers in microBenchmarks.h)
+static const char *kernelNames[] =
+{
+  NULL,
+  "walls",
+  "cellLookup",
+  "scaleD1",
+  "scaleD2",
+  "scaleD3",
+  "interaction",
+  "findMonster",
+  "sendPixels",
+  "sendRun",
+};
+#define MICRO_BENCHMARKS       ( sizeof( kernelNames ) / sizeof( kernelNames[0] ) )
+// bytes per call of the display kernels (MICRO_BENCHMARK_ROW_BYTES), 0 for the others
+static const unsigned kernelBytes[] = { 0, 0, 0, 0, 0, 0, 0, 0, 128, 128 };
+#define MICRO_BENCHMARKS_DONE  0xff
+
+typedef struct
+{
+  uint32_t calls;
+  uint64_t cycles;
+} KERNEL_RESULT;
+
+static KERNEL_RESULT kernelResults[MICRO_BENCHMARKS];
+static uint8_t  runningKernel;
+static uint64_t kernelStart;
+static uint8_t  microBenchmarksDone;
+
+/*--------------------------------------------------------*/
+static void addToStatistics( STATISTICS *statistics, uint64_t value )
+{
+  if ( !statistics->count || ( value < statistics->minimum ) ) { statistics->minimum = value; }
+  if ( !statistics->count || ( value > statistics->maximum ) ) { statistics->maximum = value; }
+  statistics->sum += value;
+  statistics->count++;
+}
+
+/*--------------------------------------------------------*/
+static void printStatistics( const char *name, const STATISTICS *statistics )
+{
+  if ( !statistics->count )
+  {
+    printf( "%-8s: -\n", name );
+    return;
+  }
+  printf( "%-8s: %llu samples, min/avg/max = %llu / %llu / %llu cycles\n", name,
+          ( unsigned long long )statistics->count,
+          ( unsigned long long )statistics->minimum,
+          ( unsigned long long )( statistics->sum / statistics->count ),
+          ( unsigned long long )statistics->maximum );
+}
+
+/*--------------------------------------------------------*/
+// the display has received a data byte
+static void ssd1306Data( uint8_t data )
+{
+  uint16_t position = display.page * 128 + display.column;
+
+  if ( !firstFrameByte ) { firstFrameByte = avr->cycle; }
+
+  // the first byte after the last frame starts a new frame
+  if ( !frameRunning )
+  {
+    frameRunning = 1;
+    frameStart = avr->cycle;
+  }
+
+  display.buffer[position] = data;
+
+  // the last byte of the screen finishes the frame
+  if ( position == 128 * 8 - 1 )
+  {
+    frameRunning = 0;
+    lastFrameEnd = avr->cycle;
+    printf( "  frame: %llu cycles\n", ( unsigned long long )( lastFrameEnd - frameStart ) );
+    addToStatistics( &frameStatistics, lastFrameEnd - frameStart );
+  }
+
+  // move to the next position
+  switch ( display.addressingMode )
+  {
+    case 2:
+      // page addressing: stay in the page
+      display.column = ( display.column + 1 ) & 0x7f;
+      break;
+    case 1:
+      // vertical addressing: next page, then next column
+      if ( display.page++ >= display.endPage )
+      {
+        display.page = display.startPage;
+        if ( display.column++ >= display.endColumn ) { display.column = display.startColumn; }
+      }
+      break;
+    default:
+      // horizontal addressing: next column, then next page
+      if ( display.column++ >= display.endColumn )
+      {
+        display.column = display.startColumn;
+        if ( display.page++ >= display.endPage ) { display.page = display.startPage; }
+      }
+  }
+}
+
+/*--------------------------------------------------------*/
+// returns the number of arguments of a command
+static uint8_t ssd1306ArgumentCount( uint8_t command )
+{
+  switch ( command )
+  {
+    case 0x21:
+    case 0x22:
+      return( 2 );
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return( 1 );
+    default:
+      return( 0 );
+  }
+}
+
+/*--------------------------------------------------------*/
+// the display has received a command byte
+static void ssd1306Command( uint8_t value )
+{
+  if ( display.argumentCount < ssd1306ArgumentCount( display.command ) )
+  {
+    // argument of the last command
+    display.arguments[display.argumentCount++] = value;
+    if ( display.argumentCount < ssd1306ArgumentCount( display.command ) ) { return; }
+
+    switch ( display.command )
+    {
+      case 0x20:
+        display.addressingMode = display.arguments[0] & 0x03;
+        break;
+      case 0x21:
+        display.column = display.startColumn = display.arguments[0] & 0x7f;
+        display.endColumn = display.arguments[1] & 0x7f;
+        break;
+      case 0x22:
+        display.page = display.startPage = display.arguments[0] & 0x07;
+        display.endPage = display.arguments[1] & 0x07;
+        break;
+    }
+    return;
+  }
+
+  display.command = value;
+  display.argumentCount = 0;
+
+  if ( ( value & 0xf8 ) == 0xb0 ) { display.page = value & 0x07; }
+  else if ( value < 0x10 ) { display.column = ( display.column & 0xf0 ) | value; }
+  else if ( value < 0x20 ) { display.column = ( display.column & 0x0f ) | ( ( value & 0x07 ) << 4 ); }
+}
+
+/*--------------------------------------------------------*/
+// a complete byte has been received
+static void i2cByte( uint8_t value )
+{
+  if ( i2c.byteCount++ == 0 )
+  {
+    // only the display is on the bus
+    if ( value != SSD1306_ADDRESS ) { i2c.active = 0; }
+    i2c.expectControl = 1;
+    return;
+  }
+
+  if ( i2c.expectControl )
+  {
+    // control byte: Co (bit 7) and D/C (bit 6)
+    i2c.continuation = value & 0x80;
+    i2c.isData = value & 0x40;
+    i2c.expectControl = 0;
+    return;
+  }
+
+  if ( i2c.isData ) { ssd1306Data( value ); }
+  else { ssd1306Command( value ); }
+
+  // with the Co bit set, every byte is followed by another control byte
+  if ( i2c.continuation ) { i2c.expectControl = 1; }
+}
+
+/*--------------------------------------------------------*/
+// called on every change of SDA or SCL
+static void i2cPinChanged( uint8_t sda, uint8_t scl )
+{
+  lastBusActivity = avr->cycle;
+
+  if ( scl && i2c.scl )
+  {
+    // SDA changed while SCL is high: start or stop condition
+    if ( i2c.sda && !sda )
+    {
+      i2c.active = 1;
+      i2c.bitCount = 0;
+      i2c.byteCount = 0;
+    }
+    else if ( !i2c.sda && sda )
+    {
+      i2c.active = 0;
+    }
+  }
+  else if ( scl && !i2c.scl && i2c.active )
+  {
+    // rising edge of SCL: sample SDA (the 9th bit is the acknowledge)
+    if ( i2c.bitCount < 8 )
+    {
+      i2c.byte = ( i2c.byte << 1 ) | ( sda ? 1 : 0 );
+    }
+    if ( ++i2c.bitCount == 9 )
+    {
+      i2c.bitCount = 0;
+      i2cByte( i2c.byte );
+    }
+  }
+
+  i2c.sda = sda;
+  i2c.scl = scl;
+}
+
+/*--------------------------------------------------------*/
+static void sdaChanged( struct avr_irq_t *irq, uint32_t value, void *param )
+{
+  ( void )irq; ( void )param;
+  i2cPinChanged( value != 0, i2c.scl );
+}
+
+/*--------------------------------------------------------*/
+static void sclChanged( struct avr_irq_t *irq, uint32_t value, void *param )
+{
+  ( void )irq; ( void )param;
+  i2cPinChanged( i2c.sda, value != 0 );
+}
+
+/*--------------------------------------------------------*/
+// sound output (PB4)
+static void soundChanged( struct avr_irq_t *irq, uint32_t value, void *param )
+{
+  ( void )irq; ( void )param;
+  if ( value && !firstSound ) { firstSound = avr->cycle; }
+}
+
+/*--------------------------------------------------------*/
+// called on every write to GPIOR0: a kernel starts (kernel number) or ends (0)
+static void gpior0Written( struct avr_t *core, avr_io_addr_t address, uint8_t value, void *param )
+{
+  ( void )param;
+  core->data[address] = value;
+
+  if ( runningKernel )
+  {
+    kernelResults[runningKernel].cycles += avr->cycle - kernelStart;
+    kernelResults[runningKernel].calls++;
+    runningKernel = 0;
+  }
+
+  if ( value == MICRO_BENCHMARKS_DONE ) { microBenchmarksDone = 1; }
+  else if ( value < MICRO_BENCHMARKS )
+  {
+    runningKernel = value;
+    kernelStart = avr->cycle;
+  }
+}
+
+/*--------------------------------------------------------*/
+// returns the budget of a kernel (0 if there is none)
+static uint64_t getBudget( FILE *budgets, const char *kernelName )
+{
+  char line[128];
+  rewind( budgets );
+  while ( fgets( line, sizeof( line ), budgets ) )
+  {
+    char name[32];
+    unsigned long long budget;
+    if ( ( line[0] != '#' ) && ( sscanf( line, "%31s %llu", name, &budget ) == 2 ) && !strcmp( name, kernelName ) )
+    {
+      return( budget );
+    }
+  }
+  return( 0 );
+}
+
+/*--------------------------------------------------------*/
+// prints the kernel results and compares them with the budgets, returns 1 on a regression
+static int reportMicroBenchmarks( const char *budgetsName, int update, unsigned threshold )
+{
+  FILE *budgets = NULL;
+  if ( budgetsName )
+  {
+    budgets = fopen( budgetsName, update ? "w" : "r" );
+    if ( !budgets ) { perror( budgetsName ); return( 1 ); }
+    if ( update ) { fprintf( budgets, "# micro benchmark budgets [cycles]: <kernel> <cycles of all calls>\n" ); }
+  }
+
+  printf( "kernel         calls      cycles  per call  budget\n" );
+  int regression = 0;
+
+  for ( unsigned kernel = 1; kernel < MICRO_BENCHMARKS; kernel++ )
+  {
+    const KERNEL_RESULT *result = &kernelResults[kernel];
+    printf( "%-12s %7u %11llu %9llu", kernelNames[kernel], result->calls, ( unsigned long long )result->cycles,
+            ( unsigned long long )( result->calls ? result->cycles / result->calls : 0 ) );
+
+    if ( budgets && update )
+    {
+      fprintf( budgets, "%s %llu\n", kernelNames[kernel], ( unsigned long long )result->cycles );
+    }
+    else if ( budgets )
+    {
+      uint64_t budget = getBudget( budgets, kernelNames[kernel] );
+      if ( !budget )
+      {
+        // a gate with a hole in it is no gate
+        printf( "       -  NO BUDGET" );
+        regression = 1;
+      }
+      else
+      {
+        printf( " %7llu", ( unsigned long long )budget );
+        if ( result->cycles * 100 > budget * ( 100 + threshold ) )
+        {
+          printf( "  REGRESSION (+%llu%%)", ( unsigned long long )( result->cycles * 100 / budget - 100 ) );
+          regression = 1;
+        }
+        else if ( result->cycles * 100 < budget * ( 100 - threshold ) )
+        {
+          printf( "  improved, update the budget?" );
+        }
+      }
+    }
+    printf( "\n" );
+  }
+
+  if ( budgets ) { fclose( budgets ); }
+
+  // the display kernels
+  printf( "\ndisplay transport\n" );
+  for ( unsigned kernel = 1; kernel < MICRO_BENCHMARKS; kernel++ )
+  {
+    const KERNEL_RESULT *result = &kernelResults[kernel];
+    if ( !kernelBytes[kernel] || !result->calls ) { continue; }
+    double cyclesPerByte = ( double )result->cycles / ( ( double )result->calls * kernelBytes[kernel] );
+    printf( "%-12s %7.1f cycles per byte (%.0f bytes/s)\n", kernelNames[kernel], cyclesPerByte, CPU_FREQUENCY / cyclesPerByte );
+  }
+  return( regression );
+}
+
+////////////////////////////////////////////////////////////
+// stack monitor
+
+/*--------------------------------------------------------*/
+// looks up a variable in the symbol table of the .elf file, returns its RAM address (0 if there is none)
+static uint16_t findVariable( const char *elfName, const char *variableName )
+{
+  uint16_t address = 0;
+  if ( elf_version( EV_CURRENT ) == EV_NONE ) { return( 0 ); }
+
+  int file = open( elfName, O_RDONLY );
+  if ( file < 0 ) { perror( elfName ); return( 0 ); }
+  Elf *elf = elf_begin( file, ELF_C_READ, NULL );
+
+  Elf_Scn *section = NULL;
+  while ( elf && !address && ( section = elf_nextscn( elf, section ) ) )
+  {
+    GElf_Shdr header;
+    if ( !gelf_getshdr( section, &header ) || ( header.sh_type != SHT_SYMTAB ) || !header.sh_entsize ) { continue; }
+
+    Elf_Data *data = elf_getdata( section, NULL );
+    for ( size_t n = 0; data && ( n < header.sh_size / header.sh_entsize ); n++ )
+    {
+      GElf_Sym symbol;
+      if ( !gelf_getsym( data, n, &symbol ) ) { continue; }
+      const char *name = elf_strptr( elf, header.sh_link, symbol.st_name );
+      if ( name && !strcmp( name, variableName ) && ( symbol.st_value >= ELF_DATA_OFFSET ) )
+      {
+        address = symbol.st_value - ELF_DATA_OFFSET;
+        break;
+      }
+    }
+  }
+
+  if ( elf ) { elf_end( elf ); }
+  close( file );
+  return( address );
+}
+
+/*--------------------------------------------------------*/
+// prints the results of the stack monitor, returns 1 if the guard zone was touched
+// or less than 'minUnusedBytes' bytes were never used
+static int reportStackMonitor( const char *elfName, unsigned minUnusedBytes )
+{
+  uint16_t unusedAddress = findVariable( elfName, "stackMinUnusedBytes" );
+  uint16_t violationsAddress = findVariable( elfName, "stackGuardViolations" );
+  if ( !unusedAddress || !violationsAddress )
+  {
+    fprintf( stderr, "%s: no stack monitor (firmware built with _ENABLE_STACK_MONITOR_?)\n", elfName );
+    return( 1 );
+  }
+
+  // little endian
+  unsigned unusedBytes = avr->data[unusedAddress] | ( avr->data[unusedAddress + 1] << 8 );
+  unsigned violations = avr->data[violationsAddress];
+
+  printf( "\nstack monitor\n" );
+  if ( unusedBytes == 0xffff )
+  {
+    printf( "no stack check reached\n" );
+  }
+  else
+  {
+    printf( "%u bytes never used, %u guard violations\n", unusedBytes, violations );
+  }
+
+  int failed = ( violations != 0 );
+  if ( violations ) { printf( "  *** the stack has reached the guard zone\n" ); }
+  if ( minUnusedBytes && ( unusedBytes != 0xffff ) && ( unusedBytes < minUnusedBytes ) )
+  {
+    printf( "  *** less than %u bytes never used\n", minUnusedBytes );
+    failed = 1;
+  }
+  return( failed );
+}
+
+////////////////////////////////////////////////////////////
+// joypad
+
+/*--------------------------------------------------------*/
+static void setJoypad( uint32_t leftRightMillivolts, uint32_t upDownMillivolts, uint8_t fire )
+{
+  // A0 = ADC0 (PB5), A3 = ADC3 (PB3), fire button = PB1 (low active)
+  avr_raise_irq( avr_io_getirq( avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0 ), leftRightMillivolts );
+  avr_raise_irq( avr_io_getirq( avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC3 ), upDownMillivolts );
+  avr_raise_irq( avr_io_getirq( avr, AVR_IOCTL_IOPORT_GETIRQ( 'B' ), 1 ), fire ? 0 : 1 );
+}
+
+/*--------------------------------------------------------*/
+// runs the simulation for the given number of cycles
+static int runCycles( uint64_t cycles )
+{
+  uint64_t end = avr->cycle + cycles;
+  while ( avr->cycle < end )
+  {
+    int state = avr_run( avr );
+    if ( ( state == cpu_Done ) || ( state == cpu_Crashed ) ) { return( 0 ); }
+  }
+  return( 1 );
+}
+
+/*--------------------------------------------------------*/
+// runs the simulation until the bus has been idle for IDLE_CYCLES
+static int runUntilIdle()
+{
+  do
+  {
+    if ( !runCycles( IDLE_CYCLES / 16 ) ) { return( 0 ); }
+  } while ( avr->cycle - lastBusActivity < IDLE_CYCLES );
+  return( 1 );
+}
+
+/*--------------------------------------------------------*/
+static void writeScreen( const char *fileName )
+{
+  FILE *file = fopen( fileName, "w" );
+  if ( !file ) { perror( fileName ); return; }
+
+  fprintf( file, "P1\n128 64\n" );
+  for ( int y = 0; y < 64; y++ )
+  {
+    for ( int x = 0; x < 128; x++ )
+    {
+      fprintf( file, "%d ", ( display.buffer[( y / 8 ) * 128 + x] >> ( y & 7 ) ) & 1 );
+    }
+    fprintf( file, "\n" );
+  }
+  fclose( file );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  int microBenchmarks = 0;
+  const char *budgetsName = NULL;
+  int update = 0;
+  unsigned threshold = 2;
+  uint64_t latencyTarget = 0;
+  const char *elfName = NULL;
+  unsigned minUnusedBytes = 0;
+
+  // options
+  int n = 1;
+  for ( ; ( n < argc ) && ( argv[n][0] == '-' ); n++ )
+  {
+    if ( !strcmp( argv[n], "-m" ) ) { microBenchmarks = 1; }
+    else if ( !strcmp( argv[n], "-u" ) ) { update = 1; }
+    else if ( !strcmp( argv[n], "-b" ) && ( n + 1 < argc ) ) { budgetsName = argv[++n]; }
+    else if ( !strcmp( argv[n], "-t" ) && ( n + 1 < argc ) ) { threshold = atoi( argv[++n] ); }
+    else if ( !strcmp( argv[n], "-l" ) && ( n + 1 < argc ) ) { latencyTarget = atoi( argv[++n] ) * ( CPU_FREQUENCY / 1000 ); }
+    else if ( !strcmp( argv[n], "-e" ) && ( n + 1 < argc ) ) { elfName = argv[++n]; }
+    else if ( !strcmp( argv[n], "-k" ) && ( n + 1 < argc ) ) { minUnusedBytes = atoi( argv[++n] ); }
+    else { break; }
+  }
+  argc -= n - 1;
+  argv += n - 1;
+
+  if ( ( argc < ( microBenchmarks ? 2 : 3 ) ) || ( update && !budgetsName ) || ( minUnusedBytes && !elfName ) )
+  {
+    fprintf( stderr, "usage: tinyDungeonSim [-l <ms>] [-e <firmware.elf> [-k <bytes>]] <firmware.hex> <script> [screen.pbm]\n"
+                     "       tinyDungeonSim -m [-b <budgets>] [-u] [-t <percent>] [-e <firmware.elf> [-k <bytes>]] <firmware.hex>\n" );
+    return( 1 );
+  }
+
+  // load the firmware
+  uint32_t codeSize, codeStart;
+  uint8_t *code = read_ihex_file( argv[1], &codeSize, &codeStart );
+  if ( !code )
+  {
+    fprintf( stderr, "unable to load '%s'\n", argv[1] );
+    return( 1 );
+  }
+
+  avr = avr_make_mcu_by_name( "attiny85" );
+  if ( !avr )
+  {
+    fprintf( stderr, "simavr doesn't support the ATtiny85\n" );
+    return( 1 );
+  }
+  avr_init( avr );
+  avr->frequency = CPU_FREQUENCY;
+  avr->vcc = avr->avcc = avr->aref = VCC_MILLIVOLTS;
+  avr_loadcode( avr, code, codeSize, codeStart );
+  free( code );
+
+  // watch the I2C lines
+  i2c.sda = i2c.scl = 1;
+  avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_IOPORT_GETIRQ( 'B' ), 0 ), sdaChanged, NULL );
+  avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_IOPORT_GETIRQ( 'B' ), 2 ), sclChanged, NULL );
+  // and the sound output
+  avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_IOPORT_GETIRQ( 'B' ), 4 ), soundChanged, NULL );
+  display.addressingMode = 2;
+  display.endColumn = 127;
+  display.endPage = 7;
+
+  // watch the micro benchmark marker
+  avr_register_io_write( avr, GPIOR0_ADDRESS, gpior0Written, NULL );
+
+  // nothing pressed
+  setJoypad( JOYSTICK_IDLE_MV, JOYSTICK_IDLE_MV, 0 );
+
+  if ( microBenchmarks )
+  {
+    // the benchmarks run before the game starts
+    while ( !microBenchmarksDone && ( avr->cycle < MICRO_BENCHMARK_TIMEOUT_CYCLES ) )
+    {
+      if ( !runCycles( CPU_FREQUENCY / 100 ) ) { break; }
+    }
+    if ( !microBenchmarksDone )
+    {
+      fprintf( stderr, "the micro benchmarks didn't finish (firmware built with _ENABLE_MICRO_BENCHMARKS_?)\n" );
+      return( 1 );
+    }
+    int regression = reportMicroBenchmarks( budgetsName, update, threshold );
+    if ( elfName && reportStackMonitor( elfName, minUnusedBytes ) ) { regression = 1; }
+    return( regression );
+  }
+
+  printf( "startup\n" );
+  if ( !runUntilIdle() ) { fprintf( stderr, "firmware stopped\n" ); return( 1 ); }
+
+  for ( const char *action = argv[2]; *action; action++ )
+  {
+    actionStart = avr->cycle;
+    firstFrameByte = 0;
+    firstSound = 0;
+    uint64_t lastFrameBefore = lastFrameEnd;
+
+    printf( "action '%c'\n", *action );
+
+    switch ( *action )
+    {
+      case 'L': setJoypad( JOYSTICK_HIGH_MV, JOYSTICK_IDLE_MV, 0 ); break;
+      case 'R': setJoypad( JOYSTICK_LOW_MV, JOYSTICK_IDLE_MV, 0 ); break;
+      case 'U': setJoypad( JOYSTICK_IDLE_MV, JOYSTICK_LOW_MV, 0 ); break;
+      case 'D': setJoypad( JOYSTICK_IDLE_MV, JOYSTICK_HIGH_MV, 0 ); break;
+      case 'F':
+      case 'C': setJoypad( JOYSTICK_IDLE_MV, JOYSTICK_IDLE_MV, 1 ); break;
+      default: break;
+    }
+
+    // release the buttons after a short press and wait until the game is idle again
+    if ( !runCycles( PRESS_CYCLES ) ) { break; }
+    setJoypad( JOYSTICK_IDLE_MV, JOYSTICK_IDLE_MV, 0 );
+    if ( !runUntilIdle() ) { break; }
+
+    // did the action produce any frames?
+    if ( ( *action != '.' ) && ( lastFrameEnd != lastFrameBefore ) )
+    {
+      uint64_t cycles = lastFrameEnd - actionStart;
+      printf( "  action: %llu cycles\n", ( unsigned long long )cycles );
+      addToStatistics( ( *action == 'C' ) ? &combatStatistics : &moveStatistics, cycles );
+    }
+
+    // button to photon latency (a step without a frame was blocked, only the sound tells)
+    int latencyType = -1;
+    uint64_t feedback = firstFrameByte;
+    switch ( *action )
+    {
+      case 'L':
+      case 'R': latencyType = LATENCY_TURN; break;
+      case 'U':
+      case 'D':
+        latencyType = firstFrameByte ? LATENCY_STEP : LATENCY_BLOCKED_STEP;
+        if ( !firstFrameByte ) { feedback = firstSound; }
+        break;
+      case 'F': latencyType = LATENCY_FIRE; break;
+      case 'C': latencyType = LATENCY_COMBAT; break;
+      default: break;
+    }
+    if ( ( latencyType >= 0 ) && feedback )
+    {
+      printf( "  latency (%s): %llu cycles\n", latencyNames[latencyType], ( unsigned long long )( feedback - actionStart ) );
+      addToStatistics( &latencyStatistics[latencyType], feedback - actionStart );
+    }
+  }
+
+  printf( "\nsummary (%lu Hz)\n", CPU_FREQUENCY );
+  printStatistics( "frame", &frameStatistics );
+  printStatistics( "move", &moveStatistics );
+  printStatistics( "combat", &combatStatistics );
+
+  printf( "\nlatency (%lu cycles = 1 ms)\n", CPU_FREQUENCY / 1000 );
+  int targetMissed = 0;
+  for ( int latencyType = 0; latencyType < LATENCY_TYPES; latencyType++ )
+  {
+    const STATISTICS *statistics = &latencyStatistics[latencyType];
+    printStatistics( latencyNames[latencyType], statistics );
+    if ( latencyTarget && statistics->count && ( statistics->maximum > latencyTarget ) )
+    {
+      printf( "  *** latency target of %llu cycles missed\n", ( unsigned long long )latencyTarget );
+      targetMissed = 1;
+    }
+  }
+
+  if ( argc > 3 ) { writeScreen( argv[3] ); }
+
+  if ( elfName && reportStackMonitor( elfName, minUnusedBytes ) ) { targetMissed = 1; }
+
+  return( targetMissed );
+}
@@ -1,4 +1,5 @@
 #include "soundFX.h"
+#include "profiler.h"
 
 #if defined(__AVR_ATtiny85__)
   // required for _delay_us()
@@ -8,31 +9,39 @@
 /*--------------------------------------------------------*/
 void stepSound()
 {
+  PROFILER_START( PROFILE_SOUND );
   Sound( 100, 1 );
   Sound( 200, 1 );
   _delay_ms( 100 );
+  PROFILER_STOP( PROFILE_SOUND );
 }
 
 /*--------------------------------------------------------*/
 void wallSound()
 {
+  PROFILER_START( PROFILE_SOUND );
   Sound( 50, 1 );
   _delay_ms( 100 );
+  PROFILER_STOP( PROFILE_SOUND );
 }
 
 /*--------------------------------------------------------*/
 void swordSound()
 {
+  PROFILER_START( PROFILE_SOUND );
   Sound( 50, 10 );
+  PROFILER_STOP( PROFILE_SOUND );
 }
 
 /*--------------------------------------------------------*/
 void potionSound()
 {
+  PROFILER_START( PROFILE_SOUND );
   Sound( 100, 30 );
   _delay_ms( 40 );
   Sound( 100, 30 );
   _delay_ms( 20 );
   Sound( 150, 30 );
+  PROFILER_STOP( PROFILE_SOUND );
 }
 
@@ -0,0 +1,29 @@
+#pragma once
+
+// SSD1306 init sequence shared by the built-in transports (ssd1306USI.cpp, ssd1306TWI.cpp)
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// the display is initialized with page addressing mode (PrepareDisplayRow() depends on it)
+static const uint8_t ssd1306InitSequence[] PROGMEM = {
+  0xAE,         // display off
+  0x20, 0x02,   // page addressing mode
+  0xB0,         // page 0
+  0xC8,         // COM output scan direction: remapped
+  0x00,         // column start address, low nibble
+  0x10,         // column start address, high nibble
+  0x40,         // display start line 0
+  0x81, 0x3F,   // contrast
+  0xA1,         // segment remap: column 127 is SEG0
+  0xA6,         // normal display (not inverted)
+  0xA8, 0x3F,   // multiplex ratio: 64 lines
+  0xA4,         // display shows the RAM content
+  0xD3, 0x00,   // no display offset
+  0xD5, 0xF0,   // display clock divide ratio/oscillator frequency
+  0xD9, 0x22,   // pre-charge period
+  0xDA, 0x12,   // COM pins hardware configuration
+  0xDB, 0x20,   // VCOMH deselect level (0.77 x Vcc)
+  0x8D, 0x14,   // enable charge pump
+  0xAF          // display on
+};
@@ -0,0 +1,207 @@
+//
+// Interrupt driven SSD1306 transport for AVR ATmega MCUs.
+// See ssd1306TWI.h for details.
+//
+
+#include <Arduino.h>
+#include "tinyJoypadUtils.h"
+
+#if defined(__AVR__) && !defined(__AVR_ATtiny85__) && defined(_USE_ASYNC_DISPLAY_)
+
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/twi.h>
+#include "ssd1306TWI.h"
+#include "ssd1306InitSequence.h"
+
+// TWI control values (the interrupt is always enabled)
+#define TWI_SEND        ( ( 1 << TWINT ) | ( 1 << TWEN ) | ( 1 << TWIE ) )
+#define TWI_START       ( TWI_SEND | ( 1 << TWSTA ) )
+#define TWI_STOP        ( ( 1 << TWINT ) | ( 1 << TWEN ) | ( 1 << TWSTO ) )
+#define TWI_STOP_START  ( TWI_START | ( 1 << TWSTO ) )
+
+// ring buffer of packets
+static SSD1306_PACKET packetQueue[SSD1306_TWI_QUEUE_SIZE];
+static uint8_t packetHead;
+static uint8_t packetTail;
+static volatile uint8_t packetCount;
+
+// progress of the packet on the bus (only used by the interrupt)
+static uint8_t headerPosition;
+
+#ifdef _ENABLE_PROFILER_
+// start of the current transmission and the busy time of the bus (see ssd1306TWI_takeBusyTime())
+static uint32_t busStartTime;
+static volatile uint32_t busBusyTime;
+#endif
+
+/*-------------------------------------------------------*/
+// Returns the next free packet (waits if the queue is full)
+static SSD1306_PACKET *allocatePacket()
+{
+  PROFILER_START( PROFILE_DISPLAY_WAIT );
+  while ( packetCount == SSD1306_TWI_QUEUE_SIZE );
+  PROFILER_STOP( PROFILE_DISPLAY_WAIT );
+  return( &packetQueue[packetHead] );
+}
+
+/*-------------------------------------------------------*/
+// Hands the packet over to the interrupt
+static void commitPacket()
+{
+  packetHead = ( packetHead + 1 ) % SSD1306_TWI_QUEUE_SIZE;
+
+  uint8_t oldSREG = SREG;
+  cli();
+  // start the transmission if the bus is idle
+  if ( packetCount++ == 0 )
+  {
+    headerPosition = 0;
+    // the stop condition of the last packet might still be on the bus
+    while ( TWCR & _BV( TWSTO ) );
+  #ifdef _ENABLE_PROFILER_
+    busStartTime = profilerGetTime();
+  #endif
+    TWCR = TWI_START;
+  }
+  SREG = oldSREG;
+}
+
+/*-------------------------------------------------------*/
+// prepares the TWI and sends the init sequence
+void ssd1306TWI_init()
+{
+  // internal pull-ups (the display module usually has its own)
+  digitalWrite( SDA, 1 );
+  digitalWrite( SCL, 1 );
+
+  // bit rate with prescaler 1
+  TWSR = 0;
+  TWBR = ( ( F_CPU / SSD1306_TWI_FREQUENCY ) - 16 ) / 2;
+  TWCR = ( 1 << TWEN );
+
+  // all commands are sent in a single transmission
+  SSD1306_PACKET *packet = allocatePacket();
+  packet->header[0] = 0x00;
+  packet->headerCount = 1;
+  packet->data = ssd1306InitSequence;
+  packet->dataCount = sizeof( ssd1306InitSequence );
+  packet->dataInFlash = true;
+  packet->page = 0xff;
+  commitPacket();
+}
+
+/*-------------------------------------------------------*/
+// Sends <count> bytes of page <page>, starting at <startColumn>
+void ssd1306TWI_queueRow( const uint8_t *pixels, const uint8_t page, const uint8_t startColumn, const uint8_t count )
+{
+  SSD1306_PACKET *packet = allocatePacket();
+  // set page and column (each command needs its own control byte)
+  packet->header[0] = 0x80;
+  packet->header[1] = 0xB0 + page;
+  packet->header[2] = 0x80;
+  packet->header[3] = startColumn & 0x0f;
+  packet->header[4] = 0x80;
+  packet->header[5] = 0x10 | ( startColumn >> 4 );
+  // everything else is data
+  packet->header[6] = 0x40;
+  packet->headerCount = 7;
+  packet->data = pixels;
+  packet->dataCount = count;
+  packet->dataInFlash = false;
+  packet->page = page;
+  commitPacket();
+}
+
+/*-------------------------------------------------------*/
+// Waits until no queued packet refers to page <page> anymore
+void ssd1306TWI_waitForPage( const uint8_t page )
+{
+  PROFILER_START( PROFILE_DISPLAY_WAIT );
+  bool pending;
+  do
+  {
+    pending = false;
+    uint8_t oldSREG = SREG;
+    cli();
+    for ( uint8_t n = 0; n < packetCount; n++ )
+    {
+      if ( packetQueue[( packetTail + n ) % SSD1306_TWI_QUEUE_SIZE].page == page ) { pending = true; }
+    }
+    SREG = oldSREG;
+  } while ( pending );
+  PROFILER_STOP( PROFILE_DISPLAY_WAIT );
+}
+
+/*-------------------------------------------------------*/
+// Waits until all packets have been sent
+void ssd1306TWI_waitUntilDone()
+{
+  PROFILER_START( PROFILE_DISPLAY_WAIT );
+  while ( packetCount );
+  PROFILER_STOP( PROFILE_DISPLAY_WAIT );
+}
+
+#ifdef _ENABLE_PROFILER_
+/*-------------------------------------------------------*/
+// Returns the time the bus has been busy since the last call
+uint32_t ssd1306TWI_takeBusyTime()
+{
+  uint8_t oldSREG = SREG;
+  cli();
+  uint32_t busyTime = busBusyTime;
+  busBusyTime = 0;
+  SREG = oldSREG;
+  return( busyTime );
+}
+#endif
+
+/*-------------------------------------------------------*/
+// Sends the next byte of the current packet
+ISR( TWI_vect )
+{
+  SSD1306_PACKET *packet = &packetQueue[packetTail];
+
+  switch ( TW_STATUS )
+  {
+    case TW_START:
+    case TW_REP_START:
+      TWDR = SSD1306_TWI_ADDRESS;
+      TWCR = TWI_SEND;
+      return;
+
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if ( headerPosition < packet->headerCount )
+      {
+        TWDR = packet->header[headerPosition++];
+        TWCR = TWI_SEND;
+        return;
+      }
+      if ( packet->dataCount )
+      {
+        TWDR = packet->dataInFlash ? pgm_read_byte( packet->data ) : *packet->data;
+        packet->data++;
+        packet->dataCount--;
+        TWCR = TWI_SEND;
+        return;
+      }
+      break;
+
+    default:
+      // no acknowledge or bus error: the packet is dropped
+      break;
+  }
+
+  // packet finished
+  packetTail = ( packetTail + 1 ) % SSD1306_TWI_QUEUE_SIZE;
+  headerPosition = 0;
+  // stop, and immediately start the next packet if there is one
+  TWCR = ( --packetCount ) ? TWI_STOP_START : TWI_STOP;
+#ifdef _ENABLE_PROFILER_
+  // the bus is idle now
+  if ( !packetCount ) { busBusyTime += profilerGetTime() - busStartTime; }
+#endif
+}
+
+#endif
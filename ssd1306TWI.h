@@ -0,0 +1,57 @@
+#pragma once
+
+// Interrupt driven SSD1306 transport for AVR ATmega MCUs (TWI hardware).
+//
+// Finished rows are queued as packets and sent by the TWI interrupt, so the
+// renderer can already calculate the next row while the last one is still
+// on the bus. The goal is a frame time of max( compute, transfer ) instead of
+// their sum. The profiler (_ENABLE_PROFILER_, see profiler.h) measures both: the
+// interrupt adds up the time the bus is busy, the waits for the bus are taken
+// out of the render time. The packets only point to the pixel data (the
+// frame buffer), so a row must not be changed until it has been sent (see
+// ssd1306TWI_waitForPage()).
+//
+// Every packet is a single I2C transmission:
+//   0x80 <0xB0 + page> 0x80 <column low> 0x80 <column high> 0x40 <data...>
+// Each command byte is preceded by a control byte with the Co bit set,
+// the final control byte (0x40) switches to data for the rest of the packet.
+//
+// Activate it with _USE_ASYNC_DISPLAY_ in TinyJoypadUtils.h. It replaces
+// Adafruit_SSD1306 and Wire, because Wire already owns the TWI interrupt.
+
+#include <Arduino.h>
+#include "profiler.h"
+
+#if defined(__AVR__) && !defined(__AVR_ATtiny85__) && defined(_USE_ASYNC_DISPLAY_)
+
+// SSD1306 slave address (0x3C) shifted by one, write access
+#define SSD1306_TWI_ADDRESS      0x78
+// I2C clock
+#define SSD1306_TWI_FREQUENCY    400000UL
+// number of packets which can be queued (the one on the bus and the next one)
+#define SSD1306_TWI_QUEUE_SIZE   2
+
+// one I2C transmission to the display
+class SSD1306_PACKET
+{
+public:
+  // command and control bytes sent before the data
+  uint8_t header[7];
+  uint8_t headerCount;
+  // pixel data (or commands, depending on the header)
+  const uint8_t *data;
+  uint8_t dataCount;
+  bool dataInFlash;
+  // display page of a row packet (0xff for anything else)
+  uint8_t page;
+};
+
+void ssd1306TWI_init();
+void ssd1306TWI_queueRow( const uint8_t *pixels, const uint8_t page, const uint8_t startColumn, const uint8_t count );
+void ssd1306TWI_waitForPage( const uint8_t page );
+void ssd1306TWI_waitUntilDone();
+#ifdef _ENABLE_PROFILER_
+uint32_t ssd1306TWI_takeBusyTime();
+#endif
+
+#endif
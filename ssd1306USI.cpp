@@ -0,0 +1,99 @@
+//
+// Built-in SSD1306 transport for the ATtiny85 using the USI peripheral.
+// See ssd1306USI.h for details.
+//
+
+#include <Arduino.h>
+#include "tinyJoypadUtils.h"
+
+#if defined(__AVR_ATtiny85__) && defined(_USE_USI_I2C_)
+
+#include <avr/pgmspace.h>
+#include "ssd1306USI.h"
+#include "ssd1306InitSequence.h"
+
+SSD1306_USI_DEVICE SSD1306;
+
+/*-------------------------------------------------------*/
+// prepares the USI and sends the init sequence
+void SSD1306_USI_DEVICE::ssd1306_init()
+{
+  // both lines are released (high) when idle
+  PORTB |= ( 1 << USI_I2C_SDA ) | ( 1 << USI_I2C_SCL );
+  DDRB |= ( 1 << USI_I2C_SDA ) | ( 1 << USI_I2C_SCL );
+
+  // two-wire mode, software clock strobe
+  USIDR = 0xff;
+  USICR = ( 1 << USIWM1 ) | ( 1 << USICS1 ) | ( 1 << USICLK );
+  // clear all flags and the counter
+  USISR = ( 1 << USISIF ) | ( 1 << USIOIF ) | ( 1 << USIPF ) | ( 1 << USIDC );
+
+  // send all commands in a single transmission
+  start();
+  ssd1306_send_byte( SSD1306_USI_ADDRESS );
+  ssd1306_send_byte( 0x00 );
+  for ( uint8_t n = 0; n < sizeof( ssd1306InitSequence ); n++ )
+  {
+    ssd1306_send_byte( pgm_read_byte( ssd1306InitSequence + n ) );
+  }
+  stop();
+}
+
+/*-------------------------------------------------------*/
+// sends a single command byte
+void SSD1306_USI_DEVICE::ssd1306_send_command( uint8_t command )
+{
+  start();
+  ssd1306_send_byte( SSD1306_USI_ADDRESS );
+  // control byte: command
+  ssd1306_send_byte( 0x00 );
+  ssd1306_send_byte( command );
+  stop();
+}
+
+/*-------------------------------------------------------*/
+// starts a data transmission, every following byte is display data
+void SSD1306_USI_DEVICE::ssd1306_send_data_start()
+{
+  start();
+  ssd1306_send_byte( SSD1306_USI_ADDRESS );
+  // control byte: data
+  ssd1306_send_byte( 0x40 );
+}
+
+/*-------------------------------------------------------*/
+// finishes a data transmission
+void SSD1306_USI_DEVICE::ssd1306_send_data_stop()
+{
+  stop();
+}
+
+/*-------------------------------------------------------*/
+// start condition: SDA goes low while SCL is high
+void SSD1306_USI_DEVICE::start()
+{
+  PORTB |= ( 1 << USI_I2C_SCL );
+  __builtin_avr_delay_cycles( USI_I2C_CYCLES_HIGH );
+  PORTB &= ~( 1 << USI_I2C_SDA );
+  __builtin_avr_delay_cycles( USI_I2C_CYCLES_HIGH );
+  PORTB &= ~( 1 << USI_I2C_SCL );
+  // from now on SDA is driven by the USI data register
+  PORTB |= ( 1 << USI_I2C_SDA );
+  // the start detector has set USISIF and holds SCL low until it's cleared
+  USISR = USI_I2C_STATUS_8_BITS;
+}
+
+/*-------------------------------------------------------*/
+// stop condition: SDA goes high while SCL is high
+void SSD1306_USI_DEVICE::stop()
+{
+  // the USI data register must not pull SDA low anymore
+  USIDR = 0xff;
+  PORTB &= ~( 1 << USI_I2C_SDA );
+  PORTB |= ( 1 << USI_I2C_SCL );
+  __builtin_avr_delay_cycles( USI_I2C_CYCLES_HIGH );
+  PORTB |= ( 1 << USI_I2C_SDA );
+  __builtin_avr_delay_cycles( USI_I2C_CYCLES_LOW );
+}
+
+#endif
@@ -0,0 +1,133 @@
+#pragma once
+
+// Built-in SSD1306 transport for the ATtiny85 using the USI peripheral
+// in two-wire mode (SDA = PB0, SCL = PB2).
+//
+// The device object provides the same functions as the one of the
+// ssd1306xled library, so TinyJoypadUtils.cpp can use either of them.
+// Activate it with _USE_USI_I2C_ in TinyJoypadUtils.h.
+//
+// The SSD1306 never stretches the clock and its acknowledge bits are
+// ignored, so every byte is clocked out with a fixed number of USI strobes.
+// Runs of bytes (ssd1306_send_run()/ssd1306_send_run_P()) are clocked out
+// inline in one loop, the time between two bytes counts as SCL low time.
+
+#include <Arduino.h>
+
+#if defined(__AVR_ATtiny85__) && defined(_USE_USI_I2C_)
+
+// SSD1306 slave address (0x3C) shifted by one, write access
+#define SSD1306_USI_ADDRESS  0x78
+
+// USI pins
+#define USI_I2C_SDA          PB0
+#define USI_I2C_SCL          PB2
+
+// minimum SCL low and high times in ns
+#ifdef _USE_USI_I2C_FAST_MODE_PLUS_
+  // fast-mode plus (1 MHz)
+  #define USI_I2C_T_LOW_NS   500
+  #define USI_I2C_T_HIGH_NS  260
+#else
+  // fast-mode (400 kHz)
+  #define USI_I2C_T_LOW_NS  1300
+  #define USI_I2C_T_HIGH_NS  600
+#endif
+
+// the times converted to cpu cycles (rounded up)
+#define USI_I2C_CYCLES_LOW   ( ( F_CPU / 1000000UL * USI_I2C_T_LOW_NS + 999 ) / 1000 )
+#define USI_I2C_CYCLES_HIGH  ( ( F_CPU / 1000000UL * USI_I2C_T_HIGH_NS + 999 ) / 1000 )
+
+// cycles a run spends between two bytes anyway (taking SDA back, the loop counter, USISR,
+// fetching the next byte and loading USIDR), a lower bound for RAM and flash
+#define USI_I2C_CYCLES_RUN_OVERHEAD  6
+// the SCL low time before the first bit of a run byte, which is left to wait for
+#define USI_I2C_CYCLES_RUN_LOW  ( ( USI_I2C_CYCLES_LOW > USI_I2C_CYCLES_RUN_OVERHEAD ) ? ( USI_I2C_CYCLES_LOW - USI_I2C_CYCLES_RUN_OVERHEAD ) : 0 )
+
+// two-wire mode, software clock strobe, toggle SCL
+#define USI_I2C_CLOCK_STROBE ( ( 1 << USIWM1 ) | ( 1 << USICS1 ) | ( 1 << USICLK ) | ( 1 << USITC ) )
+
+// USISR before a transfer: clear the start, overflow and stop flags (the start detector
+// holds SCL low as long as USISIF is set) and preset the counter to overflow after
+// 8 bits (16 clock edges) or after the acknowledge bit (2 clock edges)
+#define USI_I2C_STATUS_FLAGS ( ( 1 << USISIF ) | ( 1 << USIOIF ) | ( 1 << USIPF ) )
+#define USI_I2C_STATUS_8_BITS  ( USI_I2C_STATUS_FLAGS | ( 0x0 << USICNT0 ) )
+#define USI_I2C_STATUS_1_BIT   ( USI_I2C_STATUS_FLAGS | ( 0xE << USICNT0 ) )
+
+class SSD1306_USI_DEVICE
+{
+public:
+  void ssd1306_init();
+  void ssd1306_send_command( uint8_t command );
+  void ssd1306_send_data_start();
+  void ssd1306_send_data_stop();
+
+  /*-------------------------------------------------------*/
+  // Sends a single byte (inlined, because it's called for every pixel byte)
+  inline void ssd1306_send_byte( uint8_t byte )
+  {
+    USIDR = byte;
+    __builtin_avr_delay_cycles( USI_I2C_CYCLES_LOW );
+    clockOutByte();
+  }
+
+  /*-------------------------------------------------------*/
+  // Sends <count> bytes from RAM in the current data transmission
+  inline void ssd1306_send_run( const uint8_t *pixels, uint8_t count )
+  {
+    while ( count-- )
+    {
+      // SCL is low since the last acknowledge bit, fetching the byte is part of the low time
+      USIDR = *pixels++;
+      __builtin_avr_delay_cycles( USI_I2C_CYCLES_RUN_LOW );
+      clockOutByte();
+    }
+  }
+
+  /*-------------------------------------------------------*/
+  // Sends <count> bytes from flash in the current data transmission
+  inline void ssd1306_send_run_P( const uint8_t *pixels, uint8_t count )
+  {
+    while ( count-- )
+    {
+      // SCL is low since the last acknowledge bit, fetching the byte is part of the low time
+      USIDR = pgm_read_byte( pixels++ );
+      __builtin_avr_delay_cycles( USI_I2C_CYCLES_RUN_LOW );
+      clockOutByte();
+    }
+  }
+
+private:
+  /*-------------------------------------------------------*/
+  // Clocks out USIDR and the acknowledge bit, SCL has already been low for the first bit
+  inline void clockOutByte()
+  {
+    USISR = USI_I2C_STATUS_8_BITS;
+    // 8 data bits
+    for ( uint8_t n = 0; n < 8; n++ )
+    {
+      // SCL high
+      USICR = USI_I2C_CLOCK_STROBE;
+      __builtin_avr_delay_cycles( USI_I2C_CYCLES_HIGH );
+      // SCL low, next bit
+      USICR = USI_I2C_CLOCK_STROBE;
+      if ( n < 7 ) { __builtin_avr_delay_cycles( USI_I2C_CYCLES_LOW ); }
+    }
+
+    // release SDA for the acknowledge bit (the display always acknowledges)
+    DDRB &= ~( 1 << USI_I2C_SDA );
+    USISR = USI_I2C_STATUS_1_BIT;
+    __builtin_avr_delay_cycles( USI_I2C_CYCLES_LOW );
+    USICR = USI_I2C_CLOCK_STROBE;
+    __builtin_avr_delay_cycles( USI_I2C_CYCLES_HIGH );
+    USICR = USI_I2C_CLOCK_STROBE;
+    DDRB |= ( 1 << USI_I2C_SDA );
+  }
+
+  void start();
+  void stop();
+};
+
+extern SSD1306_USI_DEVICE SSD1306;
+
+#endif
@@ -0,0 +1,126 @@
+//
+// Stack monitor, see stackMonitor.h for details.
+//
+
+#include <Arduino.h>
+#include "stackMonitor.h"
+
+#ifdef _ENABLE_STACK_MONITOR_
+
+// smallest number of unused bytes seen so far
+uint16_t stackMinUnusedBytes = 0xffff;
+// number of checks which found the guard zone overwritten
+uint8_t stackGuardViolations;
+
+#if !defined(__AVR__)
+/*-------------------------------------------------------*/
+// host stub: there is no AVR stack to measure
+uint16_t stackUnusedBytes()
+{
+  return( 0xffff );
+}
+
+/*-------------------------------------------------------*/
+bool stackGuardIntact()
+{
+  return( true );
+}
+
+/*-------------------------------------------------------*/
+void stackCheck( const uint8_t checkpoint )
+{
+  (void)checkpoint;
+}
+
+#else
+
+// provided by the linker and malloc()
+extern uint8_t _end;
+extern uint8_t __stack;
+extern char *__brkval;
+
+#if !defined(__AVR_ATtiny85__)
+// checkpoint names for the report
+const char stackCheckpointNames[STACK_CHECKPOINTS][15] PROGMEM = {
+  "renderImage",
+  "monsterAttack",
+  "combat",
+  "interaction",
+};
+#endif
+
+/*-------------------------------------------------------*/
+// Paints the free RAM before main() is called
+// (naked and in .init3, so there is no stack frame and no return)
+void stackPaint() __attribute__ ( ( naked, used, section( ".init3" ) ) );
+void stackPaint()
+{
+  for ( uint8_t *p = &_end; p <= &__stack; p++ )
+  {
+    *p = STACK_CANARY;
+  }
+}
+
+/*-------------------------------------------------------*/
+// Returns the lowest address of the free RAM (the heap might have grown)
+static const uint8_t *getFreeRamStart()
+{
+  return( __brkval ? ( const uint8_t * )__brkval : &_end );
+}
+
+/*-------------------------------------------------------*/
+// Returns the number of bytes above the heap which have never been used
+uint16_t stackUnusedBytes()
+{
+  const uint8_t *p = getFreeRamStart();
+  uint16_t count = 0;
+
+  while ( ( p <= &__stack ) && ( *p == STACK_CANARY ) )
+  {
+    p++;
+    count++;
+  }
+  return( count );
+}
+
+/*-------------------------------------------------------*/
+// Returns false if the stack has reached the guard zone
+bool stackGuardIntact()
+{
+  const uint8_t *p = getFreeRamStart();
+
+  for ( uint8_t n = 0; n < STACK_GUARD_SIZE; n++ )
+  {
+    if ( *p++ != STACK_CANARY ) { return( false ); }
+  }
+  return( true );
+}
+
+/*-------------------------------------------------------*/
+// Updates the low water mark and checks the guard zone
+void stackCheck( const uint8_t checkpoint )
+{
+  bool violation = !stackGuardIntact();
+  if ( violation ) { stackGuardViolations++; }
+
+  uint16_t unusedBytes = stackUnusedBytes();
+  bool newLowWaterMark = ( unusedBytes < stackMinUnusedBytes );
+  if ( newLowWaterMark ) { stackMinUnusedBytes = unusedBytes; }
+
+#if !defined(__AVR_ATtiny85__)
+  if ( violation || newLowWaterMark )
+  {
+    char name[sizeof( stackCheckpointNames[0] )];
+    strcpy_P( name, stackCheckpointNames[checkpoint] );
+    Serial.print( violation ? F("*** stack guard violated") : F("stack low water mark") );
+    Serial.print( F(" after ") ); Serial.print( name );
+    Serial.print( F(": ") ); Serial.print( unusedBytes ); Serial.println( F(" bytes never used") );
+  }
+#else
+  (void)checkpoint;
+#endif
+}
+
+#endif
+
+#endif
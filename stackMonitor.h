@@ -0,0 +1,53 @@
+#pragma once
+
+// Stack monitor
+//
+// At startup (.init3) the whole free RAM between the end of the static
+// variables and the top of the stack is painted with a canary value.
+// The stack overwrites the canaries when it grows, so the number of
+// remaining canaries above the heap is the RAM that has never been used.
+//
+// STACK_CHECK( checkpoint ) should be placed after deep call paths:
+//   - it updates the low water mark 'stackMinUnusedBytes'
+//   - it counts a violation if the guard zone (the lowest STACK_GUARD_SIZE
+//     bytes of the free RAM) has been touched
+// New low water marks and violations are reported over serial (not on the ATtiny85).
+// In simavr, tinyDungeonSim -e <firmware.elf> reports both variables at exit.
+//
+// The host build has no AVR memory layout to measure, there the monitor is a stub:
+// the variables and functions exist, but stackMinUnusedBytes stays 0xffff and
+// stackGuardViolations 0.
+
+#include <Arduino.h>
+
+////////////////////////////////////////////////////////////
+// Uncomment the following line to enable the stack monitor
+//#define _ENABLE_STACK_MONITOR_
+
+// value of unused RAM
+#define STACK_CANARY      0xC5
+// bytes directly above the heap which must never be touched by the stack
+#define STACK_GUARD_SIZE  16
+
+// places of the stack checks
+enum
+{
+  STACK_CHECKPOINT_RENDER = 0,
+  STACK_CHECKPOINT_MONSTER_ATTACK,
+  STACK_CHECKPOINT_COMBAT,
+  STACK_CHECKPOINT_INTERACTION,
+  STACK_CHECKPOINTS,
+};
+
+#ifdef _ENABLE_STACK_MONITOR_
+  extern uint16_t stackMinUnusedBytes;
+  extern uint8_t stackGuardViolations;
+
+  uint16_t stackUnusedBytes();
+  bool stackGuardIntact();
+  void stackCheck( const uint8_t checkpoint );
+
+  #define STACK_CHECK( checkpoint )  stackCheck( checkpoint )
+#else
+  #define STACK_CHECK( checkpoint )
+#endif